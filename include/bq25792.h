@@ -1,4 +1,5 @@
 #pragma once
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -30,6 +31,12 @@ typedef struct {
   uint8_t fault1; /* REG27 */
   bool fault_any;
 
+  /* Charger flag'lar (REG22..REG25, okununca temizlenir; INT bunlardan tetiklenir) */
+  uint8_t chg_flag0;
+  uint8_t chg_flag1;
+  uint8_t chg_flag2;
+  uint8_t chg_flag3;
+
   /* ADC olcumleri (ADC_EN acikken) */
   int ibus_ma;   /* signed */
   int ibat_ma;   /* signed (pozitif = sarj, negatif = desarj) */
@@ -43,6 +50,41 @@ typedef struct {
   int soc_pct_est;      /* 0..100, VBAT/cell uzerinden kaba tahmin */
 } bq25792_status_t;
 
+/* Daemon'un yayinladigi snapshot: status + filtrelenmis SoC */
+typedef enum {
+  BQ25792_TRIGGER_TIMER = 0,
+  BQ25792_TRIGGER_INT   = 1,
+  BQ25792_TRIGGER_LIVE  = 2,   /* istemcinin canli okuma istegi (bq25792d "live") */
+} bq25792_trigger_t;
+
+/* Daemon ornekleme thread'i istatistikleri (bq25792d); jitter son snapshot'tan beri */
+typedef struct {
+  uint32_t period_us;       /* temel tick periyodu */
+  uint32_t jitter_max_us;   /* hedef uyanma zamanina gore en buyuk gecikme */
+  uint32_t jitter_mean_us;
+  uint32_t overruns;        /* kacirilan tick (kumulatif) */
+  uint32_t drops;           /* ring dolu, dusurulen ornek (kumulatif) */
+} bq25792_sampler_stats_t;
+
+typedef struct {
+  int64_t ts_ms;        /* CLOCK_REALTIME, ms */
+  int32_t bus;
+  uint8_t addr;
+  uint8_t trigger;      /* bq25792_trigger_t */
+  uint8_t adc_pending;  /* 1: hizli baslangic, ADC henuz donusmedi (sadece durum/flag gecerli) */
+  bq25792_status_t st;
+  int32_t soc_pct;      /* filtrelenmis (gosterim) SoC */
+  int32_t soc_raw;      /* st.soc_pct_est */
+  float soc_filt;       /* filtre ic durumu */
+
+  /* Coulomb counting (bq25792_soc.h); gecersizse soc_cc_pct = -1 */
+  float soc_cc_pct;
+  float charge_mah;
+  float capacity_mah;
+
+  bq25792_sampler_stats_t sampler;
+} bq25792_snapshot_t;
+
 /* Open/close */
 int  bq25792_open(bq25792_dev_t **dev, int i2c_bus, uint8_t i2c_addr);
 void bq25792_close(bq25792_dev_t *dev);
@@ -51,12 +93,132 @@ void bq25792_close(bq25792_dev_t *dev);
 int bq25792_read_u8 (bq25792_dev_t *dev, uint8_t reg, uint8_t *val);
 int bq25792_read_u16(bq25792_dev_t *dev, uint8_t reg, uint16_t *val);
 
+/* Ardisik registerlari tek I2C transaction ile oku (I2C_RDWR, yoksa SMBus block read) */
+int bq25792_read_block(bq25792_dev_t *dev, uint8_t reg, uint8_t *buf, size_t len);
+
+/* Register yazma */
+int bq25792_write_u8(bq25792_dev_t *dev, uint8_t reg, uint8_t val);
+
+/* reg = (reg & ~mask) | (val & mask). Mevcut deger cache'ten okunur; degismiyorsa
+   yazma yapilmaz (WD_RST gibi kendiliginden temizlenen bitler haric). */
+int bq25792_update_bits(bq25792_dev_t *dev, uint8_t reg, uint8_t mask, uint8_t val);
+
+/*
+  Handle basina register cache'i. Okumalar (u8/u16/block) araligin tamami
+  static/config ise cache'ten verilir; config degerleri refresh_ms'den eskiyse
+  cihazdan tazelenir. Status/flag/ADC registerlari hic cache'lenmez.
+  Watchdog dolmasi, REG_RST yazilmasi ve ADC'nin kapali bulunmasi (reset)
+  cache'i otomatik gecersiz kilar.
+*/
+typedef enum {
+  BQ25792_REG_VOLATILE = 0,  /* status, flag, ADC: her zaman cihazdan */
+  BQ25792_REG_CONFIG,        /* kontrol/maske: cache + yavas tazeleme */
+  BQ25792_REG_STATIC,        /* part info: bir kez */
+} bq25792_reg_class_t;
+
+#define BQ25792_CACHE_REFRESH_MS_DEFAULT 60000
+
+bq25792_reg_class_t bq25792_reg_class(uint8_t reg);
+
+/* Baska bir master (ya da kullanici) registerlari degistirdiyse */
+void bq25792_cache_invalidate(bq25792_dev_t *dev);
+
+/* Tum config/static registerlari cihazdan oku (flag registerlarina dokunmaz) */
+int  bq25792_cache_refresh(bq25792_dev_t *dev);
+
+/* Config tazeleme periyodu, <= 0: sadece invalidate ile */
+void bq25792_cache_set_refresh_ms(bq25792_dev_t *dev, long long refresh_ms);
+
+/* Sadece VBAT + IBAT, tek burst (yuksek hizli ornekleme icin) */
+int bq25792_read_vbat_ibat(bq25792_dev_t *dev, int *vbat_mv, int *ibat_ma);
+
+/* IBUS..VBAT tek burst (REG31..REG3C): giris ve pil gucu icin */
+typedef struct {
+  int vbus_mv;
+  int ibus_ma;               /* negatif = OTG */
+  int vbat_mv;
+  int ibat_ma;               /* pozitif = sarj */
+} bq25792_power_t;
+
+int bq25792_read_power(bq25792_dev_t *dev, bq25792_power_t *out);
+
 /* ADC control (REG2E) */
 int bq25792_adc_enable(bq25792_dev_t *dev, bool enable_continuous, bool high_res_15bit);
 
-/* Durum snapshot */
+/* ADC kanallari: bit sirasi sonuc registerlarinin sirasi (REG31 + 2*i) */
+enum {
+  BQ25792_ADC_IBUS = 1u << 0,
+  BQ25792_ADC_IBAT = 1u << 1,
+  BQ25792_ADC_VBUS = 1u << 2,
+  BQ25792_ADC_VAC1 = 1u << 3,
+  BQ25792_ADC_VAC2 = 1u << 4,
+  BQ25792_ADC_VBAT = 1u << 5,
+  BQ25792_ADC_VSYS = 1u << 6,
+  BQ25792_ADC_TS   = 1u << 7,
+  BQ25792_ADC_TDIE = 1u << 8,
+  BQ25792_ADC_DP   = 1u << 9,
+  BQ25792_ADC_DM   = 1u << 10,
+};
+#define BQ25792_ADC_ALL     0x7FFu
+/* bq25792_read_status'un kullandigi kanallar */
+#define BQ25792_ADC_STATUS  (BQ25792_ADC_IBUS | BQ25792_ADC_IBAT | BQ25792_ADC_VBUS | \
+                             BQ25792_ADC_VBAT | BQ25792_ADC_VSYS | BQ25792_ADC_TDIE)
+
+typedef struct {
+  uint32_t valid;   /* okunan kanallar (BQ25792_ADC_*) */
+  int ibus_ma;
+  int ibat_ma;
+  int vbus_mv;
+  int vac1_mv;
+  int vac2_mv;
+  int vbat_mv;
+  int vsys_mv;
+  float ts_pct;     /* TS/REGN orani */
+  float tdie_c;
+  int dp_mv;
+  int dm_mv;
+} bq25792_adc_t;
+
+/* Sadece mask'teki kanallari donustur (REG2F/REG30 function disable): bir
+   conversion dongusu etkin kanal sayisiyla orantili kisalir. Cache sayesinde
+   degismeyen mask I2C'ye yazilmaz. */
+int bq25792_adc_set_channels(bq25792_dev_t *dev, uint32_t mask);
+int bq25792_adc_get_channels(bq25792_dev_t *dev, uint32_t *mask);
+
+/* mask'teki kanallari etkinlestirip (gerekirse ADC'yi acip ilk donusumu bekler)
+   sadece onlari kapsayan araligi tek transaction'da okur. Diger kanallar
+   kapatilir; sonraki bq25792_read_status durum kanallarini geri acar. */
+int bq25792_read_adc(bq25792_dev_t *dev, uint32_t mask, bq25792_adc_t *out);
+
+/* "vbat,ibat" / "status" / "all" -> mask. Donus: 0 ya da -EINVAL */
+int bq25792_adc_channels_parse(const char *s, uint32_t *mask);
+
+/* Durum snapshot: REG1B..REG46 penceresi tek burst ile okunur,
+   boylece tum alanlar ayni andan gelir. ensure_adc_on ile BQ25792_ADC_STATUS
+   kanallari kapaliysa acilir (digerlerine dokunulmaz).
+   ensure_adc_on: ADC handle uzerinde henuz acilmadiysa bir kez acilir ve ilk conversion
+   ADC_DONE polling ile beklenir; sonraki cagrilar yazma/bekleme yapmaz. */
 int bq25792_read_status(bq25792_dev_t *dev, bq25792_status_t *st, bool ensure_adc_on);
 
+/* Snapshot -> tek satir JSON ('\n' ile biter, NUL sonlandirilir).
+   Donus: yazilan byte sayisi, buffer yetmezse -ENOSPC */
+int bq25792_snapshot_to_json(const bq25792_snapshot_t *snap, char *buf, size_t len);
+
+/* Snapshot ikili formati: sabit yerlesim, little-endian, 4 byte baslik
+   ("BQ", surum, toplam uzunluk) + alanlar. Surum sadece uyumsuz degisiklikte
+   artar; yeni alanlar sona eklenir ve uzunluk buyur, decoder bilmedigi kuyrugu
+   atlar. Malloc yok. */
+#define BQ25792_SNAPSHOT_BIN_VERSION 1
+#define BQ25792_SNAPSHOT_BIN_LEN     98
+
+/* Donus: yazilan byte (BQ25792_SNAPSHOT_BIN_LEN), buffer yetmezse -ENOSPC */
+int bq25792_snapshot_to_bin(const bq25792_snapshot_t *snap, uint8_t *buf, size_t len);
+/* Donus: tuketilen byte; kisa veri -EMSGSIZE, baslik/surum gecersizse -EBADMSG */
+int bq25792_snapshot_from_bin(bq25792_snapshot_t *snap, const uint8_t *buf, size_t len);
+
+/* Hucre basina OCV (mV) -> kaba SoC (%) */
+int bq25792_soc_from_vcell_mv(int vcell_mv);
+
 /* String helper'lar */
 const char* bq25792_chg_stat_str(uint8_t chg_stat);
 const char* bq25792_vbus_stat_str(uint8_t vbus_stat);
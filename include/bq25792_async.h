@@ -0,0 +1,90 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bq25792.h"
+#include "bq25792_regs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+  Bloklamayan API: istekler kuyruga atilir, handle basina tek bir worker thread
+  I2C'yi sirayla kullanir (read_status'taki ADC beklemesi dahil), sonuclar
+  eventfd ile haber verilir. Host event loop'u fd'yi EPOLLIN ile izler ve
+  bq25792_async_reap ile sonuclari toplar.
+
+  Kuyrukta bekleyen (henuz baslamamis) ayni turden bir okuma varsa yeni
+  STATUS/REGS istegi ona eklenir: tek I2C okumasi, istek basina ayri sonuc.
+  Arada bir yazma (UPDATE_BITS) varsa birlestirilmez; sira korunur.
+
+  Async context aciksa dev dogrudan (senkron API ile) kullanilmamalidir.
+  Fonksiyonlar thread-safe'tir; malloc sadece open'da.
+*/
+
+typedef struct bq25792_async bq25792_async_t;
+
+typedef enum {
+  BQ25792_ASYNC_STATUS = 0,   /* bq25792_read_status_regs */
+  BQ25792_ASYNC_REGS,         /* bq25792_read_regs (tum harita) */
+  BQ25792_ASYNC_READ,         /* bq25792_read_block(reg, len) */
+  BQ25792_ASYNC_UPDATE_BITS,  /* bq25792_update_bits(reg, mask, val) */
+} bq25792_async_kind_t;
+
+/* Bekleyen + toplanmamis sonuc ust siniri; dolunca submit -EAGAIN */
+#define BQ25792_ASYNC_DEPTH 32
+
+typedef struct {
+  uint64_t id;             /* submit'in dondurdugu, 1'den baslar */
+  void *user;
+  uint8_t kind;            /* bq25792_async_kind_t */
+  uint8_t reg;             /* READ/UPDATE_BITS */
+  uint8_t len;             /* READ */
+  uint8_t mask;            /* UPDATE_BITS */
+  uint8_t val;             /* UPDATE_BITS */
+  bool ensure_adc_on;      /* STATUS */
+  bool coalesced;          /* baska bir istegin okumasiyla cevaplandi */
+  int rc;                  /* 0 ya da -errno */
+  int64_t submit_ns;       /* CLOCK_MONOTONIC */
+  int64_t done_ns;
+  bq25792_status_t st;     /* STATUS */
+  uint8_t img[BQ25792_NREGS];  /* adrese gore: STATUS/REGS/READ sonucu */
+} bq25792_async_result_t;
+
+typedef struct {
+  uint64_t submitted;
+  uint64_t coalesced;      /* ayri I2C islemi yapilmadan cevaplanan */
+  uint64_t completed;
+  uint64_t rejected;       /* kuyruk dolu (-EAGAIN) */
+  uint32_t pending;        /* kuyrukta + calisan */
+  uint32_t ready;          /* toplanmayi bekleyen sonuc */
+} bq25792_async_stats_t;
+
+/* Worker'i baslatir. dev'in sahipligi cagiranda kalir (close'tan sonra kapatilir). */
+int  bq25792_async_open(bq25792_async_t **a, bq25792_dev_t *dev);
+
+/* Bekleyen istekler iptal edilir (sonuc uretilmez), calisan istek bitince worker durur */
+void bq25792_async_close(bq25792_async_t *a);
+
+/* Nonblocking eventfd: sonuc hazir olunca okunabilir */
+int  bq25792_async_fd(const bq25792_async_t *a);
+
+/* id NULL olabilir. Donus: 0, kuyruk dolu -EAGAIN, kapaniyor -ESHUTDOWN */
+int bq25792_async_submit_status(bq25792_async_t *a, bool ensure_adc_on, void *user, uint64_t *id);
+int bq25792_async_submit_regs(bq25792_async_t *a, void *user, uint64_t *id);
+int bq25792_async_submit_read(bq25792_async_t *a, uint8_t reg, uint8_t len, void *user, uint64_t *id);
+int bq25792_async_submit_update_bits(bq25792_async_t *a, uint8_t reg, uint8_t mask, uint8_t val,
+                                     void *user, uint64_t *id);
+
+/* Hazir sonuclar (bitis sirasiyla), en fazla max. Hic yoksa 0 (bloklamaz).
+   eventfd'yi de bosaltir; max'tan fazlasi varsa fd okunabilir kalir. */
+int bq25792_async_reap(bq25792_async_t *a, bq25792_async_result_t *out, int max);
+
+int bq25792_async_get_stats(bq25792_async_t *a, bq25792_async_stats_t *out);
+
+const char* bq25792_async_kind_str(uint8_t kind);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,122 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bq25792.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+  I2C islem kaydi (capture) ve kayittan oynatma (replay) transport'lari.
+
+  Capture, handle'in transport'unu sarar: cache'ten verilmeyip cihaza giden her
+  islem (read_u8, write_u8, read_block; read_u16/update_bits bunlara iner) zaman
+  damgasi, sonuc kodu ve veri ile kaydedilir. Kayitlar bellekte biriktirilir,
+  tampon dolunca ya da flush_ms dolunca tek writev ile O_APPEND dosyaya yazilir;
+  fsync yok, dosya hic yeniden yazilmaz (SD kart dostu).
+
+  Dosya formati (little-endian varint = LEB128):
+    "BQCAPv1\n"                         dosya basinda bir kez
+    chunk*                              her flush bir chunk
+  chunk : 0x0B varint(body_len) varint(sid) varint(base_us) body
+  body  : record*
+  record: tag varint(dt_us) ...
+    tag[1:0] op (BQ25792_CAP_*), tag[2] hata (rc != 0)
+    READ_U8    reg [rc ? varint(-rc) : val]
+    WRITE_U8   reg val [rc ? varint(-rc)]
+    READ_BLOCK reg varint(len) [rc ? varint(-rc) : len byte]
+    SESSION    zigzag(bus) addr varint(wall_us) varint(name_len) name
+  dt_us bir onceki kayda (chunk'in ilk kaydi icin base_us'e) gore CLOCK_MONOTONIC
+  mikrosaniye. Chunk'lar kendi basina cozulebilir; ayni dosyaya yazan birden
+  fazla handle/surec (sid ile ayrilir) birbirini bozmaz. Yarim kalmis son chunk
+  okuyucu tarafindan dosya sonu sayilir.
+*/
+
+#define BQ25792_CAPTURE_MAGIC      "BQCAPv1\n"
+#define BQ25792_CAPTURE_MAGIC_LEN  8
+#define BQ25792_CAPTURE_BUF_SIZE   4096
+#define BQ25792_CAPTURE_FLUSH_MS_DEFAULT 5000
+
+typedef enum {
+  BQ25792_CAP_READ_U8 = 0,
+  BQ25792_CAP_WRITE_U8,
+  BQ25792_CAP_READ_BLOCK,
+  BQ25792_CAP_SESSION,       /* handle acildi: bus/addr/transport/duvar saati */
+} bq25792_cap_op_t;
+
+typedef struct {
+  uint8_t op;                /* bq25792_cap_op_t */
+  uint8_t reg;
+  uint16_t len;              /* READ_BLOCK istenen uzunluk, digerleri 1 */
+  int rc;                    /* 0 ya da -errno */
+  uint64_t sid;              /* oturum (handle) kimligi */
+  int64_t mono_us;           /* yazan surecin CLOCK_MONOTONIC'i */
+  uint8_t data[256];         /* okunan (rc == 0) ya da yazilan deger */
+  /* sadece SESSION */
+  int bus;
+  uint8_t addr;
+  int64_t wall_us;           /* CLOCK_REALTIME */
+  char transport[16];        /* sarilan transport'un adi (i2c, sim, ...) */
+} bq25792_cap_record_t;
+
+typedef struct {
+  uint64_t records;
+  uint64_t bytes;            /* dosyaya yazilan */
+  uint64_t flushes;
+  uint64_t write_errors;     /* yazilamayip atilan chunk'lar (I/O etkilenmez) */
+} bq25792_capture_stats_t;
+
+/* *dev'in transport'unu capture ile sarar; basarida *dev yeni handle olur (eski
+   handle onun icinde kapanir), hatada *dev degismez. Kayit hatalari I/O'yu asla
+   bozmaz, sadece sayilir. flush_ms <= 0: varsayilan. */
+int bq25792_capture_wrap(bq25792_dev_t **dev, const char *path, int flush_ms);
+
+/* Tampondaki kayitlari hemen yaz (handle capture degilse -EINVAL) */
+int bq25792_capture_flush(bq25792_dev_t *dev);
+int bq25792_capture_get_stats(const bq25792_dev_t *dev, bq25792_capture_stats_t *out);
+
+/* Kayit dosyasini sirayla okuyucu */
+typedef struct bq25792_caplog bq25792_caplog_t;
+
+int  bq25792_caplog_open(bq25792_caplog_t **log, const char *path);
+/* 1: kayit, 0: dosya sonu (yarim son chunk dahil), -EBADMSG: bozuk kayit */
+int  bq25792_caplog_next(bq25792_caplog_t *log, bq25792_cap_record_t *rec);
+void bq25792_caplog_close(bq25792_caplog_t *log);
+
+const char* bq25792_cap_op_str(uint8_t op);
+
+/*
+  Replay transport: secilen oturumun kayitlarini sirayla cevap olarak verir.
+  Her istek (op, reg, len) siradaki kayitla eslesmelidir; eslesmezse ileride
+  window kayit icinde aranir (cache tazeleme zamanlamasi gibi kucuk sapmalar
+  atlanir). Bulunamazsa okuma, kayitlardan olusturulan register goruntusunden
+  verilir (tum byte'lar biliniyorsa), aksi halde -EIO. Kayitlar bitince -ENODATA.
+*/
+typedef struct {
+  int session;               /* bus'i eslesen oturumlar icinde sira, <0 sondan (-1 = son) */
+  int window;                /* eslesme arama penceresi (kayit) */
+  bool pace;                 /* kayittaki zamanlamaya uy (yoksa beklemeden) */
+} bq25792_capreplay_config_t;
+
+typedef struct {
+  uint64_t total;            /* oturumdaki islem sayisi */
+  uint64_t matched;
+  uint64_t skipped;          /* pencere icinde atlanan kayitlar */
+  uint64_t shadow;           /* register goruntusunden verilen okumalar */
+  uint64_t mismatched;       /* eslesmeyen yazma ya da cevapsiz okuma */
+} bq25792_capreplay_stats_t;
+
+void bq25792_capreplay_config_default(bq25792_capreplay_config_t *cfg);
+/* Varsayilanlar + BQ_REPLAY_SESSION, BQ_REPLAY_WINDOW, BQ_REPLAY_PACE */
+void bq25792_capreplay_config_from_env(bq25792_capreplay_config_t *cfg);
+
+/* bus'i eslesen oturum yoksa tum oturumlar arasindan secilir (orn. sim kaydi) */
+int bq25792_open_capreplay(bq25792_dev_t **dev, const char *path, int bus,
+                           const bq25792_capreplay_config_t *cfg);
+int bq25792_capreplay_get_stats(const bq25792_dev_t *dev, bq25792_capreplay_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,82 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bq25792.h"
+#include "bq25792_regs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+  Flag/durum olaylari. REG22..REG27 flag'lari kenar olunca latch'lenir ve
+  okununca temizlenir; iki okuma arasinda set edilip kaybolan bir fault da
+  bir sonraki okumada gorunur. Durum registerlari (REG1B..REG21) onceki
+  imajla karsilastirilarak kenarlar cikarilir. Alan adlari register
+  tablosundan (bq25792_regs.h) gelir.
+
+  Gunluk (journal): sabit boyutlu bellek ici ring, monoton artan seq.
+  Tek thread'li (daemon'da epoll thread'i yazar ve okur).
+*/
+
+typedef enum {
+  BQ25792_EV_FLAG = 0,    /* flag biti set okundu (REG22..REG27) */
+  BQ25792_EV_RISE,        /* 1 bitlik durum 0 -> 1 */
+  BQ25792_EV_FALL,        /* 1 bitlik durum 1 -> 0 */
+  BQ25792_EV_CHANGE,      /* cok bitlik durum degisti (chg_stat, vbus_stat, ico_stat) */
+} bq25792_event_kind_t;
+
+typedef struct {
+  uint64_t seq;           /* journal'a eklenince atanir, 1'den baslar */
+  int64_t t_ns;           /* okuma zamani, CLOCK_MONOTONIC */
+  int64_t ts_ms;          /* okuma zamani, CLOCK_REALTIME */
+  int32_t bus;
+  uint8_t addr;
+  uint8_t kind;           /* bq25792_event_kind_t */
+  uint16_t field;         /* bq25792_field_id_t */
+  int32_t value;
+  int32_t prev;
+} bq25792_event_t;
+
+const char* bq25792_event_kind_str(uint8_t kind);
+
+/* Olay penceresi: durum + flag registerlari */
+#define BQ25792_EVENT_WIN_FIRST  BQ25792_REG1B_CHG_STATUS_0
+#define BQ25792_EVENT_WIN_LAST   BQ25792_REG27_FAULT_FLAG_1
+
+/* REG1B..REG27 tek transaction ile img'e (adrese gore) okunur; flag'lar temizlenir.
+   ADC penceresinden (read_status) ucuz; hizli flag yoklamasi icin. */
+int bq25792_read_event_regs(bq25792_dev_t *dev, uint8_t img[BQ25792_NREGS]);
+
+/* cur: REG1B..REG27 dolu register imaji; prev: onceki okumanin imaji ya da NULL
+   (ilk okuma: sadece flag'lar). Zaman/bus/addr/seq alanlari cagirana kalir.
+   ADC_DONE (her donusumde) olay sayilmaz.
+   Donus: bulunan olay sayisi; max'tan buyukse fazlasi out'a yazilmaz. */
+int bq25792_events_detect(const uint8_t *prev, const uint8_t *cur, bq25792_event_t *out, int max);
+
+/* Tek satir JSON ('\n' ile biter). Donus: uzunluk, buffer yetmezse -ENOSPC */
+int bq25792_event_to_json(const bq25792_event_t *ev, char *buf, size_t len);
+
+#define BQ25792_JOURNAL_CAP 1024   /* 2'nin kuvveti */
+
+typedef struct {
+  uint64_t next_seq;
+  bq25792_event_t ev[BQ25792_JOURNAL_CAP];
+} bq25792_journal_t;
+
+void bq25792_journal_init(bq25792_journal_t *j);
+
+/* ev->seq atanir (dolu ise en eski olay dusurulur). Donus: seq */
+uint64_t bq25792_journal_append(bq25792_journal_t *j, bq25792_event_t *ev);
+
+/* seq'i after_seq'ten buyuk olaylar, eskiden yeniye, en fazla max adet.
+   after_seq artik ringde degilse en eski olaydan baslar (seq boslugu kaybi gosterir). */
+int bq25792_journal_read(const bq25792_journal_t *j, uint64_t after_seq, bq25792_event_t *out, int max);
+
+/* Son atanan seq (bos ise 0) */
+uint64_t bq25792_journal_last_seq(const bq25792_journal_t *j);
+
+#ifdef __cplusplus
+}
+#endif
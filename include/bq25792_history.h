@@ -0,0 +1,114 @@
+#pragma once
+#include "bq25792.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+  Memory-mapped, sabit boyutlu gecmis deposu (varsayilan: /var/lib/bq25792/history.db).
+
+  Dosya: 4 KiB header + 4 ring:
+    RAW : ham ornekler
+    1M  : 1 dakikalik min/max/ortalama
+    1H  : 1 saatlik
+    1D  : 1 gunluk (UTC)
+  Append O(1): sadece ilgili ring slotu ve header'daki sayaclar degisir, dosya
+  hic bastan yazilmaz; dirty sayfalari kernel writeback toplu yazar (SD kart dostu).
+  Ring'ler zamana gore sirali oldugundan aralik sorgusu binary search + sirali okuma.
+*/
+
+#define BQ25792_HISTORY_DEFAULT_PATH "/var/lib/bq25792/history.db"
+
+typedef enum {
+  BQ25792_HIST_RAW = 0,
+  BQ25792_HIST_1M,
+  BQ25792_HIST_1H,
+  BQ25792_HIST_1D,
+  BQ25792_HIST_NTIERS
+} bq25792_hist_res_t;
+
+/* Ham ornek (24 byte, dosya formati) */
+typedef struct {
+  int64_t  ts_ms;        /* CLOCK_REALTIME */
+  int16_t  ibat_ma;
+  int16_t  ibus_ma;
+  uint16_t vbat_mv;
+  uint16_t vbus_mv;
+  uint16_t vsys_mv;
+  int16_t  tdie_dc;      /* 0.1 C */
+  uint8_t  soc_pct;
+  uint8_t  chg_stat;
+  uint8_t  vbus_stat;
+  uint8_t  flags;        /* BQ25792_HIST_F_* */
+} bq25792_hist_sample_t;
+
+#define BQ25792_HIST_F_FAULT   (1u << 0)
+#define BQ25792_HIST_F_PG      (1u << 1)
+#define BQ25792_HIST_F_VBUS    (1u << 2)
+
+/* Aggregate edilen alanlar */
+typedef enum {
+  BQ25792_HIST_VBAT = 0,
+  BQ25792_HIST_VSYS,
+  BQ25792_HIST_VBUS,
+  BQ25792_HIST_IBAT,
+  BQ25792_HIST_IBUS,
+  BQ25792_HIST_TDIE,     /* 0.1 C */
+  BQ25792_HIST_SOC,
+  BQ25792_HIST_NFIELDS
+} bq25792_hist_field_t;
+
+typedef struct {
+  int32_t min;
+  int32_t max;
+  int32_t mean;
+} bq25792_hist_stat_t;
+
+/* Aggregate kayit (104 byte, dosya formati) */
+typedef struct {
+  int64_t  ts_ms;        /* bucket baslangici */
+  uint32_t count;        /* bucket'taki ham ornek sayisi */
+  uint32_t fault_count;
+  bq25792_hist_stat_t f[BQ25792_HIST_NFIELDS];
+  uint32_t reserved;
+} bq25792_hist_agg_t;
+
+typedef struct bq25792_history bq25792_history_t;
+
+/* writable=true: yoksa olusturur (tum alan fallocate edilir), daemon kullanir.
+   writable=false: salt-okunur map (bqctl history). */
+int  bq25792_history_open(bq25792_history_t **h, const char *path, bool writable);
+void bq25792_history_close(bq25792_history_t *h);
+
+/* Snapshot'tan ham ornek uret */
+void bq25792_history_sample_from(bq25792_hist_sample_t *out, const bq25792_snapshot_t *snap);
+
+/* O(1) append. Saat geri giderse ts son kayda sabitlenir (ring'ler sirali kalir). */
+int  bq25792_history_append(bq25792_history_t *h, const bq25792_hist_sample_t *s);
+
+/* [from_ms, to_ms] araligi, eskiden yeniye. Callback != 0 donerse durur.
+   Aggregate sorgularda henuz kapanmamis bucket da (kismi) son kayit olarak doner. */
+typedef int (*bq25792_hist_raw_cb)(const bq25792_hist_sample_t *s, void *user);
+typedef int (*bq25792_hist_agg_cb)(const bq25792_hist_agg_t *a, void *user);
+
+int  bq25792_history_query_raw(bq25792_history_t *h, int64_t from_ms, int64_t to_ms,
+                               bq25792_hist_raw_cb cb, void *user);
+int  bq25792_history_query_agg(bq25792_history_t *h, bq25792_hist_res_t res,
+                               int64_t from_ms, int64_t to_ms,
+                               bq25792_hist_agg_cb cb, void *user);
+
+/* Araligi kapsayan ve en fazla max_rows satir donduren en ince cozunurluk
+   (ring'ler farkli sureleri tutar) */
+bq25792_hist_res_t bq25792_history_pick_res(bq25792_history_t *h, int64_t from_ms, int64_t to_ms,
+                                            uint64_t max_rows);
+
+/* Tier bilgisi: kayit sayisi ve en eski kaydin zamani (bos ise -ENODATA) */
+int  bq25792_history_span(bq25792_history_t *h, bq25792_hist_res_t res,
+                          uint64_t *count, int64_t *oldest_ms);
+
+const char* bq25792_hist_res_str(bq25792_hist_res_t res);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,82 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bq25792.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+  Handle basina I2C sagligi: transport islemi basina sayac + sabit bucket'li
+  gecikme histogrami, register basina hata sayisi. Sayaclar relaxed atomic;
+  bq25792_get_metrics() baska bir thread'den (ornegin daemon'un publisher'i)
+  cihaz kullanilirken cagrilabilir.
+*/
+
+typedef enum {
+  BQ25792_OP_READ_U8 = 0,
+  BQ25792_OP_WRITE_U8,
+  BQ25792_OP_READ_BLOCK,
+  BQ25792_OP_COUNT
+} bq25792_op_t;
+
+/* Histogram ust sinirlari (us), sonuncu bucket +Inf */
+#define BQ25792_HIST_NBUCKETS 16
+extern const uint32_t bq25792_hist_le_us[BQ25792_HIST_NBUCKETS - 1];
+
+typedef struct {
+  uint64_t bucket[BQ25792_HIST_NBUCKETS];  /* kumulatif degil */
+  uint64_t count;
+  uint64_t sum_ns;
+} bq25792_hist_t;
+
+typedef struct {
+  uint64_t ok[BQ25792_OP_COUNT];
+  uint64_t errors[BQ25792_OP_COUNT];
+  uint64_t bytes[BQ25792_OP_COUNT];        /* veri byte'lari */
+  bq25792_hist_t latency[BQ25792_OP_COUNT];
+  uint64_t reg_errors[256];                /* islemin baslangic register'ina gore */
+  uint64_t status_reads;
+  uint64_t status_errors;
+  uint64_t adc_restarts;                   /* ADC_EN kapali bulunup yeniden acildi */
+  uint64_t cache_hits;                     /* cihaza gitmeden cevaplanan okumalar */
+  uint64_t cache_misses;                   /* config/static okuma, cihazdan */
+  uint64_t writes_skipped;                 /* deger degismedigi icin atlanan RMW yazmalari */
+} bq25792_metrics_t;
+
+int bq25792_get_metrics(const bq25792_dev_t *dev, bq25792_metrics_t *out);
+
+const char* bq25792_op_str(bq25792_op_t op);
+
+/* Tek thread'li histogram (daemon dongu sureleri vb.) */
+void bq25792_hist_observe(bq25792_hist_t *h, uint64_t ns);
+
+/*
+  Metin formati yazici. OpenMetrics (socket, "# EOF" cagirana kalir) ya da
+  Prometheus 0.0.4 (node_exporter textfile: counter TYPE satirlari _total ile).
+  Fonksiyonlar buf'a ekler, sigmazsa -ENOSPC.
+*/
+typedef struct {
+  char *buf;
+  size_t len;
+  size_t off;
+  int prom_text;   /* 1: Prometheus 0.0.4, 0: OpenMetrics */
+} bq25792_om_t;
+
+void bq25792_om_init(bq25792_om_t *om, char *buf, size_t len, int prom_text);
+
+/* name: counter icin _total'siz aile adi; labels: "k=\"v\"" listesi ya da NULL */
+int bq25792_om_family(bq25792_om_t *om, const char *name, const char *type, const char *help);
+int bq25792_om_sample(bq25792_om_t *om, const char *name, const char *labels, double value);
+int bq25792_om_histogram(bq25792_om_t *om, const char *name, const char *labels, const bq25792_hist_t *h);
+
+/* Kutuphane metriklerinin tamami (bq25792_i2c_*, bq25792_status_*), n cihaz icin:
+   m[i] ile labels[i] eslesir (labels NULL olabilir). Aile basliklari bir kez yazilir. */
+int bq25792_metrics_openmetrics(bq25792_om_t *om, const bq25792_metrics_t *const *m,
+                                const char *const *labels, int n);
+
+#ifdef __cplusplus
+}
+#endif
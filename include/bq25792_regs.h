@@ -0,0 +1,357 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bq25792.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+  BQ25792 register haritasi (TI SLUSE21), tek kaynak. Register adresleri, bit
+  alanlari ve isimler buradaki X-macro listelerinden uretilir: adres enum'u,
+  calisma zamani tablolari, durum cozucu ve JSON/CSV/raw dokumu.
+
+  Register imaji: adrese gore indekslenmis BQ25792_NREGS byte (16-bit
+  registerlar big-endian, MSB dusuk adreste).
+*/
+
+#define BQ25792_NREGS 0x49
+
+/* R(id, adres, genislik (byte), datasheet adi) */
+#define BQ25792_REG_MAP(R) \
+  R(REG00_MIN_SYS_VOLT,     0x00, 1, "Minimal_System_Voltage") \
+  R(REG01_CHG_VOLT_LIM,     0x01, 2, "Charge_Voltage_Limit") \
+  R(REG03_CHG_CURR_LIM,     0x03, 2, "Charge_Current_Limit") \
+  R(REG05_INPUT_VOLT_LIM,   0x05, 1, "Input_Voltage_Limit") \
+  R(REG06_INPUT_CURR_LIM,   0x06, 2, "Input_Current_Limit") \
+  R(REG08_PRECHG_CTRL,      0x08, 1, "Precharge_Control") \
+  R(REG09_TERM_CTRL,        0x09, 1, "Termination_Control") \
+  R(REG0A_RECHG_CTRL,       0x0A, 1, "Re-charge_Control") \
+  R(REG0B_VOTG_REG,         0x0B, 2, "VOTG_regulation") \
+  R(REG0D_IOTG_REG,         0x0D, 1, "IOTG_regulation") \
+  R(REG0E_TIMER_CTRL,       0x0E, 1, "Timer_Control") \
+  R(REG0F_CHG_CTRL_0,       0x0F, 1, "Charger_Control_0") \
+  R(REG10_CHG_CTRL_1,       0x10, 1, "Charger_Control_1") \
+  R(REG11_CHG_CTRL_2,       0x11, 1, "Charger_Control_2") \
+  R(REG12_CHG_CTRL_3,       0x12, 1, "Charger_Control_3") \
+  R(REG13_CHG_CTRL_4,       0x13, 1, "Charger_Control_4") \
+  R(REG14_CHG_CTRL_5,       0x14, 1, "Charger_Control_5") \
+  R(REG15_MPPT_CTRL,        0x15, 1, "MPPT_Control") \
+  R(REG16_TEMP_CTRL,        0x16, 1, "Temperature_Control") \
+  R(REG17_NTC_CTRL_0,       0x17, 1, "NTC_Control_0") \
+  R(REG18_NTC_CTRL_1,       0x18, 1, "NTC_Control_1") \
+  R(REG19_ICO_CURR_LIM,     0x19, 2, "ICO_Current_Limit") \
+  R(REG1B_CHG_STATUS_0,     0x1B, 1, "Charger_Status_0") \
+  R(REG1C_CHG_STATUS_1,     0x1C, 1, "Charger_Status_1") \
+  R(REG1D_CHG_STATUS_2,     0x1D, 1, "Charger_Status_2") \
+  R(REG1E_CHG_STATUS_3,     0x1E, 1, "Charger_Status_3") \
+  R(REG1F_CHG_STATUS_4,     0x1F, 1, "Charger_Status_4") \
+  R(REG20_FAULT_STATUS_0,   0x20, 1, "FAULT_Status_0") \
+  R(REG21_FAULT_STATUS_1,   0x21, 1, "FAULT_Status_1") \
+  R(REG22_CHG_FLAG_0,       0x22, 1, "Charger_Flag_0") \
+  R(REG23_CHG_FLAG_1,       0x23, 1, "Charger_Flag_1") \
+  R(REG24_CHG_FLAG_2,       0x24, 1, "Charger_Flag_2") \
+  R(REG25_CHG_FLAG_3,       0x25, 1, "Charger_Flag_3") \
+  R(REG26_FAULT_FLAG_0,     0x26, 1, "FAULT_Flag_0") \
+  R(REG27_FAULT_FLAG_1,     0x27, 1, "FAULT_Flag_1") \
+  R(REG28_CHG_MASK_0,       0x28, 1, "Charger_Mask_0") \
+  R(REG29_CHG_MASK_1,       0x29, 1, "Charger_Mask_1") \
+  R(REG2A_CHG_MASK_2,       0x2A, 1, "Charger_Mask_2") \
+  R(REG2B_CHG_MASK_3,       0x2B, 1, "Charger_Mask_3") \
+  R(REG2C_FAULT_MASK_0,     0x2C, 1, "FAULT_Mask_0") \
+  R(REG2D_FAULT_MASK_1,     0x2D, 1, "FAULT_Mask_1") \
+  R(REG2E_ADC_CONTROL,      0x2E, 1, "ADC_Control") \
+  R(REG2F_ADC_FUNC_DIS_0,   0x2F, 1, "ADC_Function_Disable_0") \
+  R(REG30_ADC_FUNC_DIS_1,   0x30, 1, "ADC_Function_Disable_1") \
+  R(REG31_IBUS_ADC,         0x31, 2, "IBUS_ADC") \
+  R(REG33_IBAT_ADC,         0x33, 2, "IBAT_ADC") \
+  R(REG35_VBUS_ADC,         0x35, 2, "VBUS_ADC") \
+  R(REG37_VAC1_ADC,         0x37, 2, "VAC1_ADC") \
+  R(REG39_VAC2_ADC,         0x39, 2, "VAC2_ADC") \
+  R(REG3B_VBAT_ADC,         0x3B, 2, "VBAT_ADC") \
+  R(REG3D_VSYS_ADC,         0x3D, 2, "VSYS_ADC") \
+  R(REG3F_TS_ADC,           0x3F, 2, "TS_ADC") \
+  R(REG41_TDIE_ADC,         0x41, 2, "TDIE_ADC") \
+  R(REG43_DP_ADC,           0x43, 2, "D+_ADC") \
+  R(REG45_DM_ADC,           0x45, 2, "D-_ADC") \
+  R(REG47_DPDM_DRIVER,      0x47, 1, "DPDM_Driver") \
+  R(REG48_PART_INFO,        0x48, 1, "Part_Information")
+
+/* Alan bayraklari */
+#define BQ25792_FF_SIGNED  0x01u  /* iki tumleyen */
+#define BQ25792_FF_RO      0x02u  /* sadece okunur (status/ADC) */
+#define BQ25792_FF_RC      0x04u  /* okununca temizlenir (flag) */
+#define BQ25792_FF_SC      0x08u  /* yazildiktan sonra kendiliginden 0 olur */
+
+/* F(id, json adi, register, kaydirma, bit sayisi, bayraklar, lsb, offset, birim)
+   Fiziksel deger = raw * lsb + offset; lsb == 0 ise raw kod (enum/bool). */
+#define BQ25792_FIELD_MAP(F) \
+  F(VSYSMIN,          "vsysmin",          0x00,  0,  6, 0, 250, 2500, "mV") \
+  F(VREG,             "vreg",             0x01,  0, 11, 0, 10, 0, "mV") \
+  F(ICHG,             "ichg",             0x03,  0,  9, 0, 10, 0, "mA") \
+  F(VINDPM,           "vindpm",           0x05,  0,  8, 0, 100, 0, "mV") \
+  F(IINDPM,           "iindpm",           0x06,  0,  9, 0, 10, 0, "mA") \
+  F(VBAT_LOWV,        "vbat_lowv",        0x08,  6,  2, 0, 0, 0, "") \
+  F(IPRECHG,          "iprechg",          0x08,  0,  6, 0, 40, 0, "mA") \
+  F(REG_RST,          "reg_rst",          0x09,  6,  1, BQ25792_FF_SC, 0, 0, "") \
+  F(STOP_WD_CHG,      "stop_wd_chg",      0x09,  5,  1, 0, 0, 0, "") \
+  F(ITERM,            "iterm",            0x09,  0,  5, 0, 40, 0, "mA") \
+  F(CELL,             "cell",             0x0A,  6,  2, 0, 1, 1, "") \
+  F(TRECHG,           "trechg",           0x0A,  4,  2, 0, 0, 0, "") \
+  F(VRECHG,           "vrechg",           0x0A,  0,  4, 0, 50, 50, "mV") \
+  F(VOTG,             "votg",             0x0B,  0, 11, 0, 10, 2800, "mV") \
+  F(PRECHG_TMR,       "prechg_tmr",       0x0D,  7,  1, 0, 0, 0, "") \
+  F(IOTG,             "iotg",             0x0D,  0,  7, 0, 40, 0, "mA") \
+  F(TOPOFF_TMR,       "topoff_tmr",       0x0E,  6,  2, 0, 0, 0, "") \
+  F(EN_TRICHG_TMR,    "en_trichg_tmr",    0x0E,  5,  1, 0, 0, 0, "") \
+  F(EN_PRECHG_TMR,    "en_prechg_tmr",    0x0E,  4,  1, 0, 0, 0, "") \
+  F(EN_CHG_TMR,       "en_chg_tmr",       0x0E,  3,  1, 0, 0, 0, "") \
+  F(CHG_TMR,          "chg_tmr",          0x0E,  1,  2, 0, 0, 0, "") \
+  F(TMR2X_EN,         "tmr2x_en",         0x0E,  0,  1, 0, 0, 0, "") \
+  F(EN_AUTO_IBATDIS,  "en_auto_ibatdis",  0x0F,  7,  1, 0, 0, 0, "") \
+  F(FORCE_IBATDIS,    "force_ibatdis",    0x0F,  6,  1, 0, 0, 0, "") \
+  F(EN_CHG,           "en_chg",           0x0F,  5,  1, 0, 0, 0, "") \
+  F(EN_ICO,           "en_ico",           0x0F,  4,  1, 0, 0, 0, "") \
+  F(FORCE_ICO,        "force_ico",        0x0F,  3,  1, BQ25792_FF_SC, 0, 0, "") \
+  F(EN_HIZ,           "en_hiz",           0x0F,  2,  1, 0, 0, 0, "") \
+  F(EN_TERM,          "en_term",          0x0F,  1,  1, 0, 0, 0, "") \
+  F(VAC_OVP,          "vac_ovp",          0x10,  4,  2, 0, 0, 0, "") \
+  F(WD_RST,           "wd_rst",           0x10,  3,  1, BQ25792_FF_SC, 0, 0, "") \
+  F(WATCHDOG,         "watchdog",         0x10,  0,  3, 0, 0, 0, "") \
+  F(FORCE_INDET,      "force_indet",      0x11,  7,  1, BQ25792_FF_SC, 0, 0, "") \
+  F(AUTO_INDET_EN,    "auto_indet_en",    0x11,  6,  1, 0, 0, 0, "") \
+  F(EN_12V,           "en_12v",           0x11,  5,  1, 0, 0, 0, "") \
+  F(EN_9V,            "en_9v",            0x11,  4,  1, 0, 0, 0, "") \
+  F(HVDCP_EN,         "hvdcp_en",         0x11,  3,  1, 0, 0, 0, "") \
+  F(SDRV_CTRL,        "sdrv_ctrl",        0x11,  1,  2, 0, 0, 0, "") \
+  F(SDRV_DLY,         "sdrv_dly",         0x11,  0,  1, 0, 0, 0, "") \
+  F(DIS_ACDRV,        "dis_acdrv",        0x12,  7,  1, 0, 0, 0, "") \
+  F(EN_OTG,           "en_otg",           0x12,  6,  1, 0, 0, 0, "") \
+  F(PFM_OTG_DIS,      "pfm_otg_dis",      0x12,  5,  1, 0, 0, 0, "") \
+  F(PFM_FWD_DIS,      "pfm_fwd_dis",      0x12,  4,  1, 0, 0, 0, "") \
+  F(WKUP_DLY,         "wkup_dly",         0x12,  3,  1, 0, 0, 0, "") \
+  F(DIS_LDO,          "dis_ldo",          0x12,  2,  1, 0, 0, 0, "") \
+  F(DIS_OTG_OOA,      "dis_otg_ooa",      0x12,  1,  1, 0, 0, 0, "") \
+  F(DIS_FWD_OOA,      "dis_fwd_ooa",      0x12,  0,  1, 0, 0, 0, "") \
+  F(EN_ACDRV2,        "en_acdrv2",        0x13,  7,  1, 0, 0, 0, "") \
+  F(EN_ACDRV1,        "en_acdrv1",        0x13,  6,  1, 0, 0, 0, "") \
+  F(PWM_FREQ,         "pwm_freq",         0x13,  5,  1, 0, 0, 0, "") \
+  F(DIS_STAT,         "dis_stat",         0x13,  4,  1, 0, 0, 0, "") \
+  F(DIS_VSYS_SHORT,   "dis_vsys_short",   0x13,  3,  1, 0, 0, 0, "") \
+  F(DIS_VOTG_UVP,     "dis_votg_uvp",     0x13,  2,  1, 0, 0, 0, "") \
+  F(FORCE_VINDPM_DET, "force_vindpm_det", 0x13,  1,  1, BQ25792_FF_SC, 0, 0, "") \
+  F(EN_IBUS_OCP,      "en_ibus_ocp",      0x13,  0,  1, 0, 0, 0, "") \
+  F(SFET_PRESENT,     "sfet_present",     0x14,  7,  1, 0, 0, 0, "") \
+  F(EN_IBAT,          "en_ibat",          0x14,  5,  1, 0, 0, 0, "") \
+  F(IBAT_REG,         "ibat_reg",         0x14,  3,  2, 0, 0, 0, "") \
+  F(EN_IINDPM,        "en_iindpm",        0x14,  2,  1, 0, 0, 0, "") \
+  F(EN_EXTILIM,       "en_extilim",       0x14,  1,  1, 0, 0, 0, "") \
+  F(EN_BATOC,         "en_batoc",         0x14,  0,  1, 0, 0, 0, "") \
+  F(VOC_PCT,          "voc_pct",          0x15,  5,  3, 0, 0, 0, "") \
+  F(VOC_DLY,          "voc_dly",          0x15,  3,  2, 0, 0, 0, "") \
+  F(VOC_RATE,         "voc_rate",         0x15,  1,  2, 0, 0, 0, "") \
+  F(EN_MPPT,          "en_mppt",          0x15,  0,  1, 0, 0, 0, "") \
+  F(TREG,             "treg",             0x16,  6,  2, 0, 0, 0, "") \
+  F(TSHUT,            "tshut",            0x16,  4,  2, 0, 0, 0, "") \
+  F(VBUS_PD_EN,       "vbus_pd_en",       0x16,  3,  1, 0, 0, 0, "") \
+  F(VAC1_PD_EN,       "vac1_pd_en",       0x16,  2,  1, 0, 0, 0, "") \
+  F(VAC2_PD_EN,       "vac2_pd_en",       0x16,  1,  1, 0, 0, 0, "") \
+  F(JEITA_VSET,       "jeita_vset",       0x17,  5,  3, 0, 0, 0, "") \
+  F(JEITA_ISETH,      "jeita_iseth",      0x17,  3,  2, 0, 0, 0, "") \
+  F(JEITA_ISETC,      "jeita_isetc",      0x17,  1,  2, 0, 0, 0, "") \
+  F(TS_COOL,          "ts_cool",          0x18,  6,  2, 0, 0, 0, "") \
+  F(TS_WARM,          "ts_warm",          0x18,  4,  2, 0, 0, 0, "") \
+  F(BHOT,             "bhot",             0x18,  2,  2, 0, 0, 0, "") \
+  F(BCOLD,            "bcold",            0x18,  1,  1, 0, 0, 0, "") \
+  F(TS_IGNORE,        "ts_ignore",        0x18,  0,  1, 0, 0, 0, "") \
+  F(ICO_ILIM,         "ico_ilim",         0x19,  0,  9, BQ25792_FF_RO, 10, 0, "mA") \
+  F(IINDPM_STAT,      "iindpm_stat",      0x1B,  7,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(VINDPM_STAT,      "vindpm_stat",      0x1B,  6,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(WD_STAT,          "wd_stat",          0x1B,  5,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(POORSRC_STAT,     "poorsrc_stat",     0x1B,  4,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(PG_STAT,          "pg_stat",          0x1B,  3,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(AC2_PRESENT_STAT, "ac2_present_stat", 0x1B,  2,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(AC1_PRESENT_STAT, "ac1_present_stat", 0x1B,  1,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(VBUS_PRESENT_STAT,"vbus_present_stat",0x1B,  0,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(CHG_STAT,         "chg_stat",         0x1C,  5,  3, BQ25792_FF_RO, 0, 0, "") \
+  F(VBUS_STAT,        "vbus_stat",        0x1C,  1,  4, BQ25792_FF_RO, 0, 0, "") \
+  F(BC12_DONE_STAT,   "bc12_done_stat",   0x1C,  0,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(ICO_STAT,         "ico_stat",         0x1D,  6,  2, BQ25792_FF_RO, 0, 0, "") \
+  F(TREG_STAT,        "treg_stat",        0x1D,  2,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(DPDM_STAT,        "dpdm_stat",        0x1D,  1,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(VBAT_PRESENT_STAT,"vbat_present_stat",0x1D,  0,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(ACRB2_STAT,       "acrb2_stat",       0x1E,  7,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(ACRB1_STAT,       "acrb1_stat",       0x1E,  6,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(ADC_DONE_STAT,    "adc_done_stat",    0x1E,  5,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(VSYS_STAT,        "vsys_stat",        0x1E,  4,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(CHG_TMR_STAT,     "chg_tmr_stat",     0x1E,  3,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(TRICHG_TMR_STAT,  "trichg_tmr_stat",  0x1E,  2,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(PRECHG_TMR_STAT,  "prechg_tmr_stat",  0x1E,  1,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(VBATOTG_LOW_STAT, "vbatotg_low_stat", 0x1F,  4,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(TS_COLD_STAT,     "ts_cold_stat",     0x1F,  3,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(TS_COOL_STAT,     "ts_cool_stat",     0x1F,  2,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(TS_WARM_STAT,     "ts_warm_stat",     0x1F,  1,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(TS_HOT_STAT,      "ts_hot_stat",      0x1F,  0,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(IBAT_REG_STAT,    "ibat_reg_stat",    0x20,  7,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(VBUS_OVP_STAT,    "vbus_ovp_stat",    0x20,  6,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(VBAT_OVP_STAT,    "vbat_ovp_stat",    0x20,  5,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(IBUS_OCP_STAT,    "ibus_ocp_stat",    0x20,  4,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(IBAT_OCP_STAT,    "ibat_ocp_stat",    0x20,  3,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(CONV_OCP_STAT,    "conv_ocp_stat",    0x20,  2,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(VAC2_OVP_STAT,    "vac2_ovp_stat",    0x20,  1,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(VAC1_OVP_STAT,    "vac1_ovp_stat",    0x20,  0,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(VSYS_SHORT_STAT,  "vsys_short_stat",  0x21,  7,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(VSYS_OVP_STAT,    "vsys_ovp_stat",    0x21,  6,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(OTG_OVP_STAT,     "otg_ovp_stat",     0x21,  5,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(OTG_UVP_STAT,     "otg_uvp_stat",     0x21,  4,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(TSHUT_STAT,       "tshut_stat",       0x21,  2,  1, BQ25792_FF_RO, 0, 0, "") \
+  F(IINDPM_FLAG,      "iindpm_flag",      0x22,  7,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(VINDPM_FLAG,      "vindpm_flag",      0x22,  6,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(WD_FLAG,          "wd_flag",          0x22,  5,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(POORSRC_FLAG,     "poorsrc_flag",     0x22,  4,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(PG_FLAG,          "pg_flag",          0x22,  3,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(AC2_PRESENT_FLAG, "ac2_present_flag", 0x22,  2,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(AC1_PRESENT_FLAG, "ac1_present_flag", 0x22,  1,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(VBUS_PRESENT_FLAG,"vbus_present_flag",0x22,  0,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(CHG_FLAG,         "chg_flag",         0x23,  7,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(ICO_FLAG,         "ico_flag",         0x23,  6,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(VBUS_FLAG,        "vbus_flag",        0x23,  4,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(TREG_FLAG,        "treg_flag",        0x23,  2,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(VBAT_PRESENT_FLAG,"vbat_present_flag",0x23,  1,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(BC12_DONE_FLAG,   "bc12_done_flag",   0x23,  0,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(DPDM_DONE_FLAG,   "dpdm_done_flag",   0x24,  6,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(ADC_DONE_FLAG,    "adc_done_flag",    0x24,  5,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(VSYS_FLAG,        "vsys_flag",        0x24,  4,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(CHG_TMR_FLAG,     "chg_tmr_flag",     0x24,  3,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(TRICHG_TMR_FLAG,  "trichg_tmr_flag",  0x24,  2,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(PRECHG_TMR_FLAG,  "prechg_tmr_flag",  0x24,  1,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(TOPOFF_TMR_FLAG,  "topoff_tmr_flag",  0x24,  0,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(VBATOTG_LOW_FLAG, "vbatotg_low_flag", 0x25,  4,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(TS_COLD_FLAG,     "ts_cold_flag",     0x25,  3,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(TS_COOL_FLAG,     "ts_cool_flag",     0x25,  2,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(TS_WARM_FLAG,     "ts_warm_flag",     0x25,  1,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(TS_HOT_FLAG,      "ts_hot_flag",      0x25,  0,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(IBAT_REG_FLAG,    "ibat_reg_flag",    0x26,  7,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(VBUS_OVP_FLAG,    "vbus_ovp_flag",    0x26,  6,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(VBAT_OVP_FLAG,    "vbat_ovp_flag",    0x26,  5,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(IBUS_OCP_FLAG,    "ibus_ocp_flag",    0x26,  4,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(IBAT_OCP_FLAG,    "ibat_ocp_flag",    0x26,  3,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(CONV_OCP_FLAG,    "conv_ocp_flag",    0x26,  2,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(VAC2_OVP_FLAG,    "vac2_ovp_flag",    0x26,  1,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(VAC1_OVP_FLAG,    "vac1_ovp_flag",    0x26,  0,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(VSYS_SHORT_FLAG,  "vsys_short_flag",  0x27,  7,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(VSYS_OVP_FLAG,    "vsys_ovp_flag",    0x27,  6,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(OTG_OVP_FLAG,     "otg_ovp_flag",     0x27,  5,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(OTG_UVP_FLAG,     "otg_uvp_flag",     0x27,  4,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(TSHUT_FLAG,       "tshut_flag",       0x27,  2,  1, BQ25792_FF_RO | BQ25792_FF_RC, 0, 0, "") \
+  F(CHG_MASK_0,       "chg_mask0",        0x28,  0,  8, 0, 0, 0, "") \
+  F(CHG_MASK_1,       "chg_mask1",        0x29,  0,  8, 0, 0, 0, "") \
+  F(CHG_MASK_2,       "chg_mask2",        0x2A,  0,  8, 0, 0, 0, "") \
+  F(CHG_MASK_3,       "chg_mask3",        0x2B,  0,  8, 0, 0, 0, "") \
+  F(FAULT_MASK_0,     "fault_mask0",      0x2C,  0,  8, 0, 0, 0, "") \
+  F(FAULT_MASK_1,     "fault_mask1",      0x2D,  0,  8, 0, 0, 0, "") \
+  F(ADC_EN,           "adc_en",           0x2E,  7,  1, 0, 0, 0, "") \
+  F(ADC_RATE,         "adc_rate",         0x2E,  6,  1, 0, 0, 0, "") \
+  F(ADC_SAMPLE,       "adc_sample",       0x2E,  4,  2, 0, 0, 0, "") \
+  F(ADC_AVG,          "adc_avg",          0x2E,  3,  1, 0, 0, 0, "") \
+  F(ADC_AVG_INIT,     "adc_avg_init",     0x2E,  2,  1, 0, 0, 0, "") \
+  F(IBUS_ADC_DIS,     "ibus_adc_dis",     0x2F,  7,  1, 0, 0, 0, "") \
+  F(IBAT_ADC_DIS,     "ibat_adc_dis",     0x2F,  6,  1, 0, 0, 0, "") \
+  F(VBUS_ADC_DIS,     "vbus_adc_dis",     0x2F,  5,  1, 0, 0, 0, "") \
+  F(VBAT_ADC_DIS,     "vbat_adc_dis",     0x2F,  4,  1, 0, 0, 0, "") \
+  F(VSYS_ADC_DIS,     "vsys_adc_dis",     0x2F,  3,  1, 0, 0, 0, "") \
+  F(TS_ADC_DIS,       "ts_adc_dis",       0x2F,  2,  1, 0, 0, 0, "") \
+  F(TDIE_ADC_DIS,     "tdie_adc_dis",     0x2F,  1,  1, 0, 0, 0, "") \
+  F(DP_ADC_DIS,       "dp_adc_dis",       0x30,  7,  1, 0, 0, 0, "") \
+  F(DM_ADC_DIS,       "dm_adc_dis",       0x30,  6,  1, 0, 0, 0, "") \
+  F(VAC2_ADC_DIS,     "vac2_adc_dis",     0x30,  5,  1, 0, 0, 0, "") \
+  F(VAC1_ADC_DIS,     "vac1_adc_dis",     0x30,  4,  1, 0, 0, 0, "") \
+  F(IBUS_ADC,         "ibus",             0x31,  0, 16, BQ25792_FF_RO | BQ25792_FF_SIGNED, 1, 0, "mA") \
+  F(IBAT_ADC,         "ibat",             0x33,  0, 16, BQ25792_FF_RO | BQ25792_FF_SIGNED, 1, 0, "mA") \
+  F(VBUS_ADC,         "vbus",             0x35,  0, 16, BQ25792_FF_RO, 1, 0, "mV") \
+  F(VAC1_ADC,         "vac1",             0x37,  0, 16, BQ25792_FF_RO, 1, 0, "mV") \
+  F(VAC2_ADC,         "vac2",             0x39,  0, 16, BQ25792_FF_RO, 1, 0, "mV") \
+  F(VBAT_ADC,         "vbat",             0x3B,  0, 16, BQ25792_FF_RO, 1, 0, "mV") \
+  F(VSYS_ADC,         "vsys",             0x3D,  0, 16, BQ25792_FF_RO, 1, 0, "mV") \
+  F(TS_ADC,           "ts",               0x3F,  0, 16, BQ25792_FF_RO, 0.0976563, 0, "%") \
+  F(TDIE_ADC,         "tdie",             0x41,  0, 16, BQ25792_FF_RO | BQ25792_FF_SIGNED, 0.5, 0, "C") \
+  F(DP_ADC,           "dp",               0x43,  0, 16, BQ25792_FF_RO, 1, 0, "mV") \
+  F(DM_ADC,           "dm",               0x45,  0, 16, BQ25792_FF_RO, 1, 0, "mV") \
+  F(DPLUS_DAC,        "dplus_dac",        0x47,  5,  3, 0, 0, 0, "") \
+  F(DMINUS_DAC,       "dminus_dac",       0x47,  2,  3, 0, 0, 0, "") \
+  F(PN,               "pn",               0x48,  3,  3, BQ25792_FF_RO, 0, 0, "") \
+  F(DEV_REV,          "dev_rev",          0x48,  0,  3, BQ25792_FF_RO, 0, 0, "")
+
+/* Register adresleri: BQ25792_REG1B_CHG_STATUS_0 = 0x1B, ... */
+enum {
+#define BQ25792_R_ENUM(id, addr, width, name) BQ25792_##id = (addr),
+  BQ25792_REG_MAP(BQ25792_R_ENUM)
+#undef BQ25792_R_ENUM
+};
+
+/* Alan kimlikleri: BQ25792_F_CHG_STAT, ... */
+typedef enum {
+#define BQ25792_F_ENUM(id, name, reg, shift, bits, flags, lsb, offset, unit) BQ25792_F_##id,
+  BQ25792_FIELD_MAP(BQ25792_F_ENUM)
+#undef BQ25792_F_ENUM
+  BQ25792_F_COUNT
+} bq25792_field_id_t;
+
+typedef struct {
+  const char *name;     /* datasheet adi */
+  uint8_t addr;
+  uint8_t width;        /* 1 ya da 2 byte */
+} bq25792_reg_desc_t;
+
+typedef struct {
+  const char *name;     /* JSON/CSV anahtari */
+  uint8_t reg;
+  uint8_t width;        /* registerin genisligi (tablodan) */
+  uint8_t shift;
+  uint8_t bits;
+  uint8_t flags;        /* BQ25792_FF_* */
+  float lsb;
+  float offset;
+  const char *unit;
+} bq25792_field_desc_t;
+
+extern const bq25792_reg_desc_t bq25792_reg_table[];
+extern const size_t bq25792_reg_table_len;
+extern const bq25792_field_desc_t bq25792_field_table[BQ25792_F_COUNT];
+
+/* Imajdan ham alan degeri (SIGNED ise isaret genisletilmis) */
+int32_t bq25792_field_raw(const uint8_t *img, bq25792_field_id_t id);
+
+/* Fiziksel deger (raw * lsb + offset; lsb == 0 ise raw) */
+double bq25792_field_value(const uint8_t *img, bq25792_field_id_t id);
+
+/* Tum register haritasini oku (config/static cache'ten, digerleri tek burst).
+   Dikkat: REG22..REG27 flag'lari okununca temizlenir. */
+int bq25792_read_regs(bq25792_dev_t *dev, uint8_t img[BQ25792_NREGS]);
+
+/* bq25792_read_status + ayni okumanin tam register imaji. Config/static kisim
+   cache'ten gelir (bayatlamissa cihazdan tazelenir), flag'lar ek okunmaz. */
+int bq25792_read_status_regs(bq25792_dev_t *dev, bq25792_status_t *st, bool ensure_adc_on,
+                             uint8_t img[BQ25792_NREGS]);
+
+/* Imajdan bq25792_status_t (read_status ile ayni cozucu) */
+void bq25792_decode_status(const uint8_t *img, bq25792_status_t *st);
+
+typedef enum {
+  BQ25792_DUMP_RAW = 0,   /* "REG1B Charger_Status_0 0x00" satirlari */
+  BQ25792_DUMP_CSV,       /* reg,field,raw,value,unit */
+  BQ25792_DUMP_JSON,      /* {"regs":{...},"fields":{...}} tek satir */
+} bq25792_dump_fmt_t;
+
+/* [first, last] araligindaki registerlar/alanlar; heap kullanmaz.
+   Donus: yazilan uzunluk (NUL haric) ya da -ENOSPC */
+int bq25792_regs_dump(const uint8_t *img, uint8_t first, uint8_t last,
+                      bq25792_dump_fmt_t fmt, char *buf, size_t len);
+
+int bq25792_dump_fmt_parse(const char *s, bq25792_dump_fmt_t *fmt);
+
+#ifdef __cplusplus
+}
+#endif
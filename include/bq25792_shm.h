@@ -0,0 +1,48 @@
+#pragma once
+#include "bq25792.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+  Paylasimli bellek status segmenti (varsayilan: /run/bq25792/status.shm).
+  bq25792d her ornekte bq25792_snapshot_t'yi seqlock ile yazar; okuyucular
+  dosya acma / JSON parse olmadan, kilitsiz ve kopyasiz okur.
+
+  Yerlesim sabit ve versiyonludur: header (magic, versiyon, payload boyu, seq)
+  + 64 byte hizali payload. Layout degisirse BQ25792_SHM_VERSION artar;
+  uyumsuz segmenti okuyucu -EPROTO ile reddeder.
+*/
+
+#define BQ25792_SHM_DEFAULT_PATH "/run/bq25792/status.shm"
+#define BQ25792_SHM_MAGIC        0x42513235u /* "BQ25" */
+#define BQ25792_SHM_VERSION      4
+
+typedef struct bq25792_shm bq25792_shm_t;
+
+/* Yazici (daemon): segmenti olusturur ya da mevcut olani yeniden kullanir.
+   Dosya yerinde tutulur, boylece acik okuyucularin mapping'i gecerli kalir. */
+int  bq25792_shm_create(bq25792_shm_t **shm, const char *path);
+int  bq25792_shm_publish(bq25792_shm_t *shm, const bq25792_snapshot_t *snap);
+
+/* Okuyucu: salt-okunur map */
+int  bq25792_shm_open(bq25792_shm_t **shm, const char *path);
+
+/* Tutarli kopya. -ENODATA: henuz yayin yok, -EBUSY: yazici surekli mesgul */
+int  bq25792_shm_read(bq25792_shm_t *shm, bq25792_snapshot_t *snap);
+
+/* Kopyasiz okuma:
+     uint32_t s;
+     do { s = bq25792_shm_read_begin(shm); ...data->st.vbat_mv...; }
+     while (bq25792_shm_read_retry(shm, s));
+   read_begin yazim bitene kadar doner; data isaretcisi map omru boyunca gecerlidir. */
+const bq25792_snapshot_t* bq25792_shm_data(const bq25792_shm_t *shm);
+uint32_t bq25792_shm_read_begin(const bq25792_shm_t *shm);
+bool     bq25792_shm_read_retry(const bq25792_shm_t *shm, uint32_t seq);
+
+void bq25792_shm_close(bq25792_shm_t *shm);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,64 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bq25792.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+  Bellek ici BQ25792 simulatoru (transport backend'i). Register seviyesinde:
+   - REG0A hucre sayisi, REG10 watchdog (suresi dolunca REG2E resetlenir), REG14 EN_IBAT
+   - REG1B..REG21 status, REG22..REG27 flag'lar (okununca temizlenir)
+   - REG2E ADC: continuous/one-shot, ADC_SAMPLE'a gore conversion suresi,
+     one-shot bitince ADC_DONE_STAT/ADC_DONE_FLAG ve ADC_EN=0
+   - REG31..REG46 ADC sonuclari (conversion tamamlandikca guncellenir, big-endian)
+  Fizik modeli: OCV egrisi + ic direnc, CC/CV sarj ve terminasyon, giris akim
+  limiti (IINDPM), sistem yuku, die sicakligi.
+
+  Zaman CLOCK_MONOTONIC * speed ile ilerler; speed > 1 CI'da tum yigini hizli
+  calistirir. Tek thread'den kullanilmalidir (cihaz handle'i gibi).
+*/
+
+typedef struct {
+  int cells;                 /* 1..4 (REG0A CELL) */
+  float capacity_mah;
+  float soc0_pct;            /* baslangic SoC */
+  float r_int_mohm;          /* pack ic direnci */
+  int ichg_ma;               /* sarj akimi (CC) */
+  int iterm_ma;              /* terminasyon akimi */
+  int vreg_mv_cell;          /* CV voltaji, hucre basina */
+  int vbus_mv;               /* adaptor voltaji, 0 = adaptor yok */
+  int iin_lim_ma;            /* giris akim limiti */
+  int load_ma;               /* sistem yuku (VSYS) */
+  float ambient_c;
+  float speed;               /* simulasyon zamani / gercek zaman */
+  int plug_period_s;         /* >0: adaptor bu periyotla takilip cikarilir (sim zamani) */
+} bq25792_sim_config_t;
+
+typedef struct bq25792_sim bq25792_sim_t;
+
+void bq25792_sim_config_default(bq25792_sim_config_t *cfg);
+
+/* Varsayilanlar + BQ_SIM_CELLS, BQ_SIM_CAPACITY_MAH, BQ_SIM_SOC, BQ_SIM_RINT_MOHM,
+   BQ_SIM_ICHG_MA, BQ_SIM_ITERM_MA, BQ_SIM_VBUS_MV, BQ_SIM_IIN_LIM_MA, BQ_SIM_LOAD_MA,
+   BQ_SIM_AMBIENT_C, BQ_SIM_SPEED, BQ_SIM_PLUG_PERIOD_S */
+void bq25792_sim_config_from_env(bq25792_sim_config_t *cfg);
+
+/* Simulator transport'u ile handle ac. sim != NULL ise model durumu icin pointer
+   doner (handle kapaninca gecersiz olur). */
+int bq25792_open_sim(bq25792_dev_t **dev, const bq25792_sim_config_t *cfg, bq25792_sim_t **sim);
+
+/* Senaryo kontrolu (adaptor tak/cikar, yuk degisimi) */
+void bq25792_sim_set_vbus(bq25792_sim_t *sim, int vbus_mv);
+void bq25792_sim_set_load(bq25792_sim_t *sim, int load_ma);
+
+/* Model durumu */
+float bq25792_sim_soc_pct(const bq25792_sim_t *sim);
+double bq25792_sim_time_s(const bq25792_sim_t *sim);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,115 @@
+#pragma once
+#include "bq25792.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+  Coulomb counting SoC motoru.
+  IBAT (pozitif = sarj) monotonic zaman damgalariyla trapez kurali ile entegre edilir;
+  birikim tamsayi (mA*us) oldugundan 100 Hz'de bile ucuz ve kaymasizdir.
+  Kalibrasyon noktalari:
+    - dinlenme: |IBAT| < rest_current_ma, rest_time_s boyunca -> OCV tablosundan SoC
+    - sarj sonu (chg_stat 7) -> %100
+  Iki kalibrasyon noktasi arasinda SoC farki yeterince buyukse kapasite ogrenilir
+  (olculen yuk / SoC farki). Durum (kapasite + kalan yuk) dosyaya kaydedilebilir.
+*/
+
+typedef struct {
+  float design_capacity_mah;   /* ogrenme oncesi kapasite */
+  int   rest_current_ma;       /* varsayilan 50 */
+  int   rest_time_s;           /* varsayilan 1800 */
+  float learn_min_delta_pct;   /* kapasite ogrenmek icin min SoC araligi, varsayilan 40 */
+  int   max_gap_ms;            /* bundan uzun bosluklar entegre edilmez (suspend vb.), varsayilan 5000 */
+} bq25792_cc_config_t;
+
+typedef struct {
+  bq25792_cc_config_t cfg;
+
+  int64_t capacity_mAus;       /* ogrenilmis kapasite (mA*us) */
+  int64_t charge_mAus;         /* kalan yuk (mA*us) */
+  bool    valid;               /* en az bir kalibrasyon noktasi (ya da kayitli durum) var */
+
+  /* entegrasyon */
+  bool    have_last;
+  int64_t last_t_ns;
+  int32_t last_ibat_ma;
+  int32_t last_vbat_mv;
+  uint8_t cell_count;
+
+  /* dinlenme tespiti */
+  int64_t rest_since_ns;       /* 0 = dinlenmede degil */
+  bool    rest_calibrated;
+
+  /* sarj sonu kenari */
+  bool    term_latched;
+
+  /* kapasite ogrenme: son kalibrasyon noktasi ve o noktadan beri net yuk */
+  bool    anchor_valid;
+  float   anchor_soc_pct;
+  int64_t anchor_charge_mAus;
+
+  uint64_t samples;
+  uint32_t calibrations;
+  uint32_t learn_count;
+  bool     dirty;              /* kaydedilmemis ogrenilmis durum */
+} bq25792_cc_t;
+
+void  bq25792_cc_config_default(bq25792_cc_config_t *cfg);
+void  bq25792_cc_init(bq25792_cc_t *cc, const bq25792_cc_config_t *cfg);
+
+/* Sicak yol (10..100 Hz): t_ns CLOCK_MONOTONIC */
+void  bq25792_cc_update(bq25792_cc_t *cc, int64_t t_ns, int ibat_ma, int vbat_mv);
+
+/* Yavas yol (tam snapshot): hucre sayisi, sarj sonu kalibrasyonu, ilk tahmin */
+void  bq25792_cc_on_status(bq25792_cc_t *cc, int64_t t_ns, const bq25792_status_t *st);
+
+/* 0..100, gecersizse -1 */
+float bq25792_cc_soc_pct(const bq25792_cc_t *cc);
+float bq25792_cc_charge_mah(const bq25792_cc_t *cc);
+float bq25792_cc_capacity_mah(const bq25792_cc_t *cc);
+
+/* Kalici durum (kapasite + kalan yuk), atomik yazim */
+int   bq25792_cc_save(bq25792_cc_t *cc, const char *path);
+int   bq25792_cc_load(bq25792_cc_t *cc, const char *path);
+
+/*
+  Gosterim SoC filtresi: kaba tahmin (soc_pct_est) uzerinde EMA + yon bazli
+  anti-jitter + hiz siniri. Saat cagirandan gelir (t_ms, herhangi bir monoton ms
+  kaynagi): daemon ornek zamanini, bq25792_replay kayit zamanini verir; filtre
+  gercek zamandan bagimsiz ve deterministiktir.
+*/
+typedef struct {
+  float alpha;                 /* EMA katsayisi, varsayilan 0.15 */
+  int   min_step_ms;           /* gosterimde iki adim arasi en az, varsayilan 60000 */
+  int   big_jump;              /* yone ters adim icin en az fark (%), varsayilan 5 */
+  int   stable_chg;            /* sarjda asagi adim icin ardisik ornek, varsayilan 6 */
+  int   stable_dis;            /* desarjda yukari adim icin ardisik ornek, varsayilan 60 */
+  int   dis_up_mult;           /* desarjda yukari adim: min_step_ms carpani, varsayilan 10 */
+  int   idle_delta;            /* bostayken adim icin en az fark (%), varsayilan 2 */
+  int   stable_idle;           /* bostayken ardisik ornek, varsayilan 6 */
+  int   dir_ma;                /* |IBAT| bundan buyukse sarj/desarj, varsayilan 50 */
+} bq25792_socfilt_config_t;
+
+typedef struct {
+  bq25792_socfilt_config_t cfg;
+  int     soc_display;         /* 0..100, yayinlanan */
+  float   soc_filt;            /* EMA durumu */
+  int64_t last_change_ms;      /* hiz siniri */
+  int     stable_cnt;          /* ardisik kararli ornek */
+  int     last_dir;            /* -1, 0, +1 */
+} bq25792_socfilt_t;
+
+void bq25792_socfilt_config_default(bq25792_socfilt_config_t *cfg);
+
+/* cfg NULL ise varsayilan */
+void bq25792_socfilt_init(bq25792_socfilt_t *f, const bq25792_socfilt_config_t *cfg, int soc0, int64_t t_ms);
+void bq25792_socfilt_update(bq25792_socfilt_t *f, int soc_raw, int dir, int64_t t_ms);
+
+/* IBAT isaretinden sarj yonu: +1 sarj, -1 desarj, 0 bosta */
+int  bq25792_socfilt_dir(const bq25792_socfilt_t *f, int ibat_ma);
+
+#ifdef __cplusplus
+}
+#endif
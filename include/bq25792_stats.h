@@ -0,0 +1,165 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bq25792.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+  Akan istatistik ve enerji sayaci. Ornek basina O(1), malloc yok.
+
+  Pencereler: her pencere BQ25792_STATS_BUCKETS dilime bolunur (60 s pencere ->
+  1 s dilim). Ornek sadece aktif dilimin Welford'una (n, ortalama, M2) eklenir;
+  kapanan dilim pencere toplamina birlestirilir, pencereden cikan dilim toplamdan
+  ters birlestirme ile dusulur, kayma birikmesin diye her tam turda toplam
+  dilimlerden yeniden kurulur. Sorguda toplam + aktif dilim birlestirilir. Kayan min/max dilim minimumlari
+  uzerinde monoton deque ile (amortize O(1)). Pencere cozunurlugu bir dilimdir.
+
+  Enerji/yuk: VBAT*IBAT ve VBUS*IBUS (ve IBAT) trapez kurali ile yonlerine gore
+  ayri ayri entegre edilir. Birikim tamsayi (uW*us, mA*us); tam mWh/mAh'e
+  tasinir, kalan kaybolmaz. Sayaclar dosyaya kaydedilip geri yuklenebilir.
+*/
+
+#define BQ25792_STATS_BUCKETS      60
+#define BQ25792_STATS_MAX_WINDOWS  4
+
+typedef enum {
+  BQ25792_STAT_VBAT = 0,     /* mV */
+  BQ25792_STAT_IBAT,         /* mA, pozitif = sarj */
+  BQ25792_STAT_VBUS,         /* mV */
+  BQ25792_STAT_IBUS,         /* mA, negatif = OTG */
+  BQ25792_STAT_PBAT,         /* mW */
+  BQ25792_STAT_PBUS,         /* mW */
+  BQ25792_STAT_NCHAN
+} bq25792_stat_chan_t;
+
+typedef enum {
+  BQ25792_E_BAT_IN = 0,      /* pile giren (sarj) */
+  BQ25792_E_BAT_OUT,         /* pilden cikan (desarj) */
+  BQ25792_E_BUS_IN,          /* adaptorden alinan */
+  BQ25792_E_BUS_OUT,         /* OTG ile verilen */
+  BQ25792_E_COUNT
+} bq25792_energy_kind_t;
+
+typedef enum {
+  BQ25792_Q_BAT_IN = 0,
+  BQ25792_Q_BAT_OUT,
+  BQ25792_Q_COUNT
+} bq25792_charge_kind_t;
+
+typedef struct {
+  uint32_t n;
+  int32_t  min;
+  int32_t  max;
+  double   mean;
+  double   m2;               /* sum (x - mean)^2 */
+} bq25792_welford_t;
+
+void   bq25792_welford_reset(bq25792_welford_t *w);
+void   bq25792_welford_add(bq25792_welford_t *w, int32_t x);
+/* Iki ozetin birlesimi (Chan vd.) */
+void   bq25792_welford_merge(bq25792_welford_t *dst, const bq25792_welford_t *src);
+/* Orneklem standart sapmasi, n < 2 ise 0 */
+double bq25792_welford_stddev(const bq25792_welford_t *w);
+
+/* Dilim indeksleri, on taraf en eski */
+typedef struct {
+  uint8_t idx[BQ25792_STATS_BUCKETS];
+  uint8_t head;
+  uint8_t len;
+} bq25792_stat_deque_t;
+
+typedef struct {
+  int64_t window_ms;
+  int64_t bucket_ms;
+  int64_t cur_start_ms;      /* aktif dilimin baslangici */
+  int64_t first_ms;          /* temizlendikten sonraki ilk ornek */
+  bool    started;
+  uint8_t cur;
+  uint32_t rotations;
+  bq25792_welford_t bucket[BQ25792_STATS_BUCKETS][BQ25792_STAT_NCHAN];
+  bq25792_welford_t agg[BQ25792_STAT_NCHAN];   /* kapanmis dilimler; min/max kullanilmaz (deque'lerden) */
+  bq25792_stat_deque_t dmin[BQ25792_STAT_NCHAN];
+  bq25792_stat_deque_t dmax[BQ25792_STAT_NCHAN];
+} bq25792_statwin_t;
+
+/* Sabit nokta sayac: tam birim (mWh/mAh) + kalan (2 * alt birim * us, trapez icin) */
+typedef struct {
+  uint64_t whole;
+  int64_t  rem;
+} bq25792_fix_acc_t;
+
+typedef struct {
+  int     nwin;
+  int64_t window_ms[BQ25792_STATS_MAX_WINDOWS];
+  int     max_gap_ms;        /* bundan uzun bosluklar entegre edilmez, varsayilan 5000 */
+} bq25792_stats_config_t;
+
+typedef struct {
+  bq25792_stats_config_t cfg;
+  bq25792_statwin_t win[BQ25792_STATS_MAX_WINDOWS];
+  bq25792_welford_t total[BQ25792_STAT_NCHAN];   /* init'ten beri (kalici degil) */
+
+  bool    have_last;
+  int64_t last_t_ns;
+  int32_t last_vbat_mv, last_ibat_ma, last_vbus_mv, last_ibus_ma;
+
+  bq25792_fix_acc_t energy[BQ25792_E_COUNT];     /* mWh */
+  bq25792_fix_acc_t charge[BQ25792_Q_COUNT];     /* mAh */
+  int64_t  since_ms;         /* sayaclarin baslangici (CLOCK_REALTIME), 0 = henuz yok */
+  uint64_t samples;
+  uint64_t gaps;             /* max_gap_ms'i asan, entegre edilmeyen araliklar */
+  bool     dirty;            /* kaydedilmemis sayac artisi */
+} bq25792_stats_t;
+
+typedef struct {
+  uint32_t n;
+  int32_t  min;              /* n == 0 ise 0 */
+  int32_t  max;
+  double   mean;
+  double   stddev;
+} bq25792_stat_agg_t;
+
+typedef struct {
+  int64_t window_ms;
+  int64_t span_ms;           /* kapsanan sure (pencere dolana kadar daha kisa) */
+  bq25792_stat_agg_t ch[BQ25792_STAT_NCHAN];
+} bq25792_stat_window_t;
+
+typedef struct {
+  double  wh[BQ25792_E_COUNT];
+  double  ah[BQ25792_Q_COUNT];
+  int64_t since_ms;
+} bq25792_energy_t;
+
+/* 10 s, 60 s, 15 dk */
+void bq25792_stats_config_default(bq25792_stats_config_t *cfg);
+/* "10,60,900" (saniye, en fazla BQ25792_STATS_MAX_WINDOWS). 0 ya da -EINVAL */
+int  bq25792_stats_config_parse_windows(bq25792_stats_config_t *cfg, const char *s);
+
+void bq25792_stats_init(bq25792_stats_t *s, const bq25792_stats_config_t *cfg);
+
+/* Sicak yol: t_ns CLOCK_MONOTONIC, zamana gore sirali */
+void bq25792_stats_add(bq25792_stats_t *s, int64_t t_ns, int vbat_mv, int ibat_ma, int vbus_mv, int ibus_ma);
+
+/* k. pencerenin t_ns anindaki ozeti (suresi dolan dilimler once atilir) */
+int  bq25792_stats_window(bq25792_stats_t *s, int k, int64_t t_ns, bq25792_stat_window_t *out);
+void bq25792_stats_energy(const bq25792_stats_t *s, bq25792_energy_t *out);
+
+/* "energy":{...},"windows":[...] parcasi (cagiran nesneyi sarar). Uzunluk ya da -ENOSPC */
+int  bq25792_stats_to_json(bq25792_stats_t *s, int64_t t_ns, char *buf, size_t len);
+
+/* Enerji/yuk sayaclari, atomik yazim (pencereler kaydedilmez) */
+int  bq25792_stats_save(bq25792_stats_t *s, const char *path);
+int  bq25792_stats_load(bq25792_stats_t *s, const char *path);
+
+const char* bq25792_stat_chan_str(int chan);
+const char* bq25792_energy_kind_str(int kind);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,48 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bq25792.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+  Register erisim katmani. bq25792_dev_t tum I/O'yu bu vtable uzerinden yapar;
+  varsayilan backend Linux i2c-dev (/dev/i2c-N), digerleri: simulator
+  (bq25792_sim.h), kayit/replay (bq25792_capture.h) ya da cagiranin kendi implementasyonu (mock, capture, ...).
+
+  Tum fonksiyonlar 0 ya da -errno doner.
+*/
+typedef struct {
+  const char *name;
+
+  /* Tek register oku / yaz */
+  int  (*read_u8)(void *ctx, uint8_t reg, uint8_t *val);
+  int  (*write_u8)(void *ctx, uint8_t reg, uint8_t val);
+
+  /* reg'den baslayarak len ardisik byte, mumkunse tek transaction */
+  int  (*read_block)(void *ctx, uint8_t reg, uint8_t *buf, size_t len);
+
+  /* Handle kapanirken cagrilir (ctx'in sahibi transport'tur), NULL olabilir */
+  void (*close)(void *ctx);
+} bq25792_transport_ops_t;
+
+/* Verilen transport ile handle ac. bus/addr sadece raporlama icindir.
+   Basarili olursa ctx handle'a gecer (bq25792_close -> ops->close), aksi halde cagiranda kalir. */
+int bq25792_open_transport(bq25792_dev_t **dev, const bq25792_transport_ops_t *ops, void *ctx,
+                           int bus, uint8_t addr);
+
+/* Linux i2c-dev backend'i (bq25792_open BQ_TRANSPORT ayarli degilse bunu kullanir) */
+int bq25792_open_i2c(bq25792_dev_t **dev, int i2c_bus, uint8_t i2c_addr);
+
+/* Handle'in transport'u (ayni ctx uzerinde ozel kontroller icin) */
+const bq25792_transport_ops_t* bq25792_transport_ops(const bq25792_dev_t *dev);
+void* bq25792_transport_ctx(const bq25792_dev_t *dev);
+/* Acilista verilen bus/addr (sarici transport'lar ayni degerlerle acar) */
+void bq25792_bus_addr(const bq25792_dev_t *dev, int *bus, uint8_t *addr);
+
+#ifdef __cplusplus
+}
+#endif
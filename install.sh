@@ -36,11 +36,15 @@ if [[ ! -f "$UNIT_SRC" ]]; then
   exit 1
 fi
 
+# Soket erisimi (bqctl status/events/stats): bu gruba eklenen kullanicilar
+groupadd -f --system bq25792
+
 install -m 0644 "$UNIT_SRC" "$UNIT_DST"
+install -m 0644 "${SCRIPT_DIR}/systemd/bq25792d.socket" /etc/systemd/system/bq25792d.socket
 
 echo "[5/6] systemd enable/start..."
 systemctl daemon-reload
-systemctl enable --now bq25792d.service
+systemctl enable --now bq25792d.socket bq25792d.service
 systemctl restart bq25792d.service
 
 echo "[6/6] Kontrol..."
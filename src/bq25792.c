@@ -1,49 +1,99 @@
 #include "bq25792.h"
+#include "bq25792_capture.h"
+#include "bq25792_events.h"
+#include "bq25792_metrics.h"
+#include "bq25792_metrics_priv.h"
+#include "bq25792_regs.h"
+#include "bq25792_sim.h"
+#include "bq25792_transport.h"
 
 #include <errno.h>
-#include <fcntl.h>
-#include <linux/i2c-dev.h>
-#include <i2c/smbus.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <sys/ioctl.h>
+#include <time.h>
 #include <unistd.h>
 
+/* bq25792_metrics_t'nin atomic karsiligi (cihaz thread'i yazar, herkes okur) */
+typedef struct {
+  _Atomic uint64_t ok[BQ25792_OP_COUNT];
+  _Atomic uint64_t errors[BQ25792_OP_COUNT];
+  _Atomic uint64_t bytes[BQ25792_OP_COUNT];
+  _Atomic uint64_t lat_bucket[BQ25792_OP_COUNT][BQ25792_HIST_NBUCKETS];
+  _Atomic uint64_t lat_sum_ns[BQ25792_OP_COUNT];
+  _Atomic uint64_t reg_errors[256];
+  _Atomic uint64_t status_reads;
+  _Atomic uint64_t status_errors;
+  _Atomic uint64_t adc_restarts;
+  _Atomic uint64_t cache_hits;
+  _Atomic uint64_t cache_misses;
+  _Atomic uint64_t writes_skipped;
+} dev_metrics_t;
+
+/* Config/static register cache'i. Volatile registerlar (status/flag/ADC) hic tutulmaz. */
+typedef struct {
+  uint8_t val[BQ25792_NREGS];
+  uint8_t valid[BQ25792_NREGS];
+  long long ts_ms[BQ25792_NREGS];   /* CLOCK_MONOTONIC, config tazeligi */
+  long long refresh_ms;         /* config bu sureden eskiyse cihazdan okunur, 0 = hic */
+} reg_cache_t;
+
 struct bq25792_dev {
-  int fd;
+  const bq25792_transport_ops_t *ops;
+  void *ctx;
   int bus;
   uint8_t addr;
   int inited;
+  int adc_ctrl;        /* son programlanan REG2E degeri, -1 = bilinmiyor */
+  int adc_stale;       /* yeni acilan kanal(lar) henuz donusmedi: REG2E devralinmaz */
+  reg_cache_t cache;
+  dev_metrics_t m;
 };
 
-/* Register map subset (TI BQ25792 datasheet) */
-enum {
-  REG0A_RECHG_CTRL      = 0x0A, /* CELL_1:0 in bits 7:6 (battery cell count) */
-  REG10_CHG_CTRL_1      = 0x10, /* WATCHDOG_2:0 in bits 2:0, WD_RST in bit3 */
-  REG14_CHG_CTRL_5      = 0x14, /* EN_IBAT in bit5 */
-
-  REG1B_CHG_STATUS_0    = 0x1B, /* 8-bit */
-  REG1C_CHG_STATUS_1    = 0x1C, /* 8-bit */
-  REG26_FAULT_FLAG_0    = 0x26, /* 8-bit */
-  REG27_FAULT_FLAG_1    = 0x27, /* 8-bit */
-
-  REG2E_ADC_CONTROL     = 0x2E, /* 8-bit */
-
-  /* ADC result registers are 16-bit */
-  REG31_IBUS_ADC        = 0x31,
-  REG33_IBAT_ADC        = 0x33,
-  REG35_VBUS_ADC        = 0x35,
-  REG3B_VBAT_ADC        = 0x3B,
-  REG3D_VSYS_ADC        = 0x3D,
-  REG41_TDIE_ADC        = 0x41,
+/* REG09[6] REG_RST: tum registerlar POR degerine doner */
+#define REG_RST           (1u << 6)
+
+/* Status/flag/ADC penceresi: REG1B..REG46 tek transaction'da okunur */
+#define STATUS_WIN_FIRST  BQ25792_REG1B_CHG_STATUS_0
+#define STATUS_WIN_LEN    (BQ25792_REG45_DM_ADC + 2 - BQ25792_REG1B_CHG_STATUS_0)
+
+/* REG2E bitleri */
+#define ADC_EN            (1u << 7)
+#define ADC_RATE_ONESHOT  (1u << 6)
+#define ADC_SAMPLE_SHIFT  4
+
+/* REG1E[5] ADC_DONE_STAT (sadece one-shot modda anlamli) */
+#define ADC_DONE_STAT     (1u << 5)
+
+/* ADC conversion suresi (kanal basina, ADC_SAMPLE 15/14/13/12-bit) ve kanal sayisi.
+   Ilk conversion icin bekleme suresinin ust siniri etkin kanallardan hesaplanir. */
+static const int adc_conv_ms[4] = { 24, 12, 6, 3 };
+#define ADC_NUM_CHANNELS  11
+
+/* Kanal i (BQ25792_ADC_* bit sirasi) -> REG2F/REG30'daki *_ADC_DIS biti */
+static const struct { uint8_t reg; uint8_t bit; } adc_dis[ADC_NUM_CHANNELS] = {
+  { BQ25792_REG2F_ADC_FUNC_DIS_0, 7 },  /* IBUS */
+  { BQ25792_REG2F_ADC_FUNC_DIS_0, 6 },  /* IBAT */
+  { BQ25792_REG2F_ADC_FUNC_DIS_0, 5 },  /* VBUS */
+  { BQ25792_REG30_ADC_FUNC_DIS_1, 4 },  /* VAC1 */
+  { BQ25792_REG30_ADC_FUNC_DIS_1, 5 },  /* VAC2 */
+  { BQ25792_REG2F_ADC_FUNC_DIS_0, 4 },  /* VBAT */
+  { BQ25792_REG2F_ADC_FUNC_DIS_0, 3 },  /* VSYS */
+  { BQ25792_REG2F_ADC_FUNC_DIS_0, 2 },  /* TS */
+  { BQ25792_REG2F_ADC_FUNC_DIS_0, 1 },  /* TDIE */
+  { BQ25792_REG30_ADC_FUNC_DIS_1, 7 },  /* D+ */
+  { BQ25792_REG30_ADC_FUNC_DIS_1, 6 },  /* D- */
 };
+#define ADC_DIS_0_MASK    0xFEu   /* REG2F[0] reserved */
+#define ADC_DIS_1_MASK    0xF0u   /* REG30[3:0] reserved */
+#define ADC_WAIT_SLACK_MS 20
+#define ADC_POLL_US       2000
 
 static int clampi(int v, int lo, int hi) { return (v < lo) ? lo : (v > hi) ? hi : v; }
-static uint16_t swap16(uint16_t v) { return (uint16_t)((v >> 8) | (v << 8)); }
 
 /* Kaba Li-ion OCV -> SoC (per-cell, mV). Kendi kimyaniza/yuk profilinize gore kalibre edin. */
-static int soc_from_vcell_mv(int vcell_mv) {
+int bq25792_soc_from_vcell_mv(int vcell_mv) {
   static const int mv[]  = { 3300, 3400, 3500, 3600, 3650, 3700, 3800, 3900, 4000, 4100, 4200 };
   static const int soc[] = {    0,   10,   20,   30,   40,   50,   60,   70,   80,   90,  100 };
   if (vcell_mv <= mv[0]) return 0;
@@ -59,84 +109,335 @@ static int soc_from_vcell_mv(int vcell_mv) {
   return 0;
 }
 
-int bq25792_open(bq25792_dev_t **out, int i2c_bus, uint8_t i2c_addr) {
-  if (!out) return -EINVAL;
+int bq25792_open_transport(bq25792_dev_t **out, const bq25792_transport_ops_t *ops, void *ctx,
+                           int bus, uint8_t addr) {
+  if (!out || !ops || !ops->read_u8 || !ops->write_u8 || !ops->read_block) return -EINVAL;
   *out = NULL;
 
-  char devpath[32];
-  snprintf(devpath, sizeof(devpath), "/dev/i2c-%d", i2c_bus);
-
-  int fd = open(devpath, O_RDWR | O_CLOEXEC);
-  if (fd < 0) return -errno;
-
-  if (ioctl(fd, I2C_SLAVE, i2c_addr) < 0) {
-    int e = -errno;
-    close(fd);
-    return e;
-  }
-
   bq25792_dev_t *dev = (bq25792_dev_t*)calloc(1, sizeof(*dev));
-  if (!dev) {
-    close(fd);
-    return -ENOMEM;
-  }
-  dev->fd = fd;
-  dev->bus = i2c_bus;
-  dev->addr = i2c_addr;
+  if (!dev) return -ENOMEM;
+  dev->ops = ops;
+  dev->ctx = ctx;
+  dev->bus = bus;
+  dev->addr = addr;
   dev->inited = 0;
+  dev->adc_ctrl = -1;
+  dev->cache.refresh_ms = BQ25792_CACHE_REFRESH_MS_DEFAULT;
 
   *out = dev;
   return 0;
 }
 
+static int open_backend(bq25792_dev_t **out, const char *tr, int i2c_bus, uint8_t i2c_addr) {
+  if (tr && strcmp(tr, "sim") == 0) {
+    bq25792_sim_config_t cfg;
+    bq25792_sim_config_from_env(&cfg);
+    return bq25792_open_sim(out, &cfg, NULL);
+  }
+  if (tr && *tr && strcmp(tr, "i2c") != 0) return -ENOTSUP;
+  return bq25792_open_i2c(out, i2c_bus, i2c_addr);
+}
+
+/* BQ_TRANSPORT=sim ise cihaz yerine simulator (ayarlar BQ_SIM_* ortam degiskenlerinden),
+   replay ise BQ_REPLAY_LOG kaydi. BQ_CAPTURE_PATH ayarliysa (replay haric) tum
+   islemler oraya kaydedilir; yoldaki "%d" bus numarasiyla degistirilir. */
+int bq25792_open(bq25792_dev_t **out, int i2c_bus, uint8_t i2c_addr) {
+  const char *tr = getenv("BQ_TRANSPORT");
+  if (tr && strcmp(tr, "replay") == 0) {
+    bq25792_capreplay_config_t cfg;
+    bq25792_capreplay_config_from_env(&cfg);
+    return bq25792_open_capreplay(out, getenv("BQ_REPLAY_LOG"), i2c_bus, &cfg);
+  }
+  int rc = open_backend(out, tr, i2c_bus, i2c_addr);
+  const char *cap = getenv("BQ_CAPTURE_PATH");
+  if (rc || !cap || !*cap) return rc;
+
+  char path[512];
+  const char *pct = strstr(cap, "%d");
+  if (pct) snprintf(path, sizeof(path), "%.*s%d%s", (int)(pct - cap), cap, i2c_bus, pct + 2);
+  else snprintf(path, sizeof(path), "%s", cap);
+  const char *fl = getenv("BQ_CAPTURE_FLUSH_MS");
+  rc = bq25792_capture_wrap(out, path, fl ? (int)strtol(fl, NULL, 0) : 0);
+  if (rc) {
+    bq25792_close(*out);
+    *out = NULL;
+  }
+  return rc;
+}
+
 void bq25792_close(bq25792_dev_t *dev) {
   if (!dev) return;
-  if (dev->fd >= 0) close(dev->fd);
+  if (dev->ops->close) dev->ops->close(dev->ctx);
   free(dev);
 }
 
+const bq25792_transport_ops_t* bq25792_transport_ops(const bq25792_dev_t *dev) {
+  return dev ? dev->ops : NULL;
+}
+
+void* bq25792_transport_ctx(const bq25792_dev_t *dev) {
+  return dev ? dev->ctx : NULL;
+}
+
+void bq25792_bus_addr(const bq25792_dev_t *dev, int *bus, uint8_t *addr) {
+  if (!dev) return;
+  if (bus) *bus = dev->bus;
+  if (addr) *addr = dev->addr;
+}
+
+#define M_INC(field, n) atomic_fetch_add_explicit(&(field), (n), memory_order_relaxed)
+
+static uint64_t mono_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static long long mono_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000LL;
+}
+
+/* Her transport islemi: sayac + gecikme histogrami + hata ise register */
+static void account(bq25792_dev_t *dev, bq25792_op_t op, uint8_t reg, size_t len, int rc, uint64_t t0) {
+  const uint64_t ns = mono_ns() - t0;
+  M_INC(dev->m.lat_bucket[op][bq25792_hist_bucket(ns)], 1);
+  M_INC(dev->m.lat_sum_ns[op], ns);
+  if (rc) {
+    M_INC(dev->m.errors[op], 1);
+    M_INC(dev->m.reg_errors[reg], 1);
+  } else {
+    M_INC(dev->m.ok[op], 1);
+    M_INC(dev->m.bytes[op], len);
+  }
+}
+
+static int io_read_block(bq25792_dev_t *dev, uint8_t reg, uint8_t *buf, size_t len) {
+  const uint64_t t0 = mono_ns();
+  int rc = dev->ops->read_block(dev->ctx, reg, buf, len);
+  account(dev, BQ25792_OP_READ_BLOCK, reg, len, rc, t0);
+  return rc;
+}
+
+int bq25792_get_metrics(const bq25792_dev_t *cdev, bq25792_metrics_t *out) {
+  if (!cdev || !out) return -EINVAL;
+  bq25792_dev_t *dev = (bq25792_dev_t*)cdev; /* atomic_load const olmayan pointer ister */
+  memset(out, 0, sizeof(*out));
+  for (int op = 0; op < BQ25792_OP_COUNT; op++) {
+    out->ok[op] = atomic_load_explicit(&dev->m.ok[op], memory_order_relaxed);
+    out->errors[op] = atomic_load_explicit(&dev->m.errors[op], memory_order_relaxed);
+    out->bytes[op] = atomic_load_explicit(&dev->m.bytes[op], memory_order_relaxed);
+    for (int b = 0; b < BQ25792_HIST_NBUCKETS; b++) {
+      out->latency[op].bucket[b] = atomic_load_explicit(&dev->m.lat_bucket[op][b], memory_order_relaxed);
+      out->latency[op].count += out->latency[op].bucket[b];
+    }
+    out->latency[op].sum_ns = atomic_load_explicit(&dev->m.lat_sum_ns[op], memory_order_relaxed);
+  }
+  for (int r = 0; r < 256; r++) {
+    out->reg_errors[r] = atomic_load_explicit(&dev->m.reg_errors[r], memory_order_relaxed);
+  }
+  out->status_reads = atomic_load_explicit(&dev->m.status_reads, memory_order_relaxed);
+  out->status_errors = atomic_load_explicit(&dev->m.status_errors, memory_order_relaxed);
+  out->adc_restarts = atomic_load_explicit(&dev->m.adc_restarts, memory_order_relaxed);
+  out->cache_hits = atomic_load_explicit(&dev->m.cache_hits, memory_order_relaxed);
+  out->cache_misses = atomic_load_explicit(&dev->m.cache_misses, memory_order_relaxed);
+  out->writes_skipped = atomic_load_explicit(&dev->m.writes_skipped, memory_order_relaxed);
+  return 0;
+}
+
+/*
+  Register siniflari (datasheet register map):
+   static   : REG48 part info, handle omru boyunca degismez
+   config   : REG00..REG18 kontrol, REG28..REG2D maskeler, REG2F/30 ADC kanal, REG47;
+              sadece host yazar (watchdog/REG_RST/POR haric), cache'ten verilir
+   volatile : REG19 ICO, REG1B..REG27 status/flag, REG2E (one-shot ADC_EN'i temizler),
+              REG31..REG46 ADC; her zaman cihazdan
+*/
+bq25792_reg_class_t bq25792_reg_class(uint8_t reg) {
+  if (reg == BQ25792_REG48_PART_INFO) return BQ25792_REG_STATIC;
+  if (reg <= BQ25792_REG18_NTC_CTRL_1) return BQ25792_REG_CONFIG;
+  if (reg >= BQ25792_REG28_CHG_MASK_0 && reg < BQ25792_REG2E_ADC_CONTROL) return BQ25792_REG_CONFIG;
+  if (reg == BQ25792_REG2F_ADC_FUNC_DIS_0 || reg == BQ25792_REG30_ADC_FUNC_DIS_1) return BQ25792_REG_CONFIG;
+  if (reg == BQ25792_REG47_DPDM_DRIVER) return BQ25792_REG_CONFIG;
+  return BQ25792_REG_VOLATILE;
+}
+
+/* Yazildiktan sonra kendiliginden 0'a donen bitler (BQ25792_FF_SC); cache'te hep 0 tutulur */
+static uint8_t self_clear_mask(uint8_t reg) {
+  uint8_t m = 0;
+  for (int id = 0; id < BQ25792_F_COUNT; id++) {
+    const bq25792_field_desc_t *f = &bq25792_field_table[id];
+    if (f->reg == reg && (f->flags & BQ25792_FF_SC)) m |= (uint8_t)(((1u << f->bits) - 1u) << f->shift);
+  }
+  return m;
+}
+
+static int cache_fresh(const bq25792_dev_t *dev, uint8_t reg, long long now) {
+  const reg_cache_t *c = &dev->cache;
+  if (reg >= BQ25792_NREGS || !c->valid[reg]) return 0;
+  if (bq25792_reg_class(reg) == BQ25792_REG_STATIC) return 1;
+  return c->refresh_ms <= 0 || now - c->ts_ms[reg] < c->refresh_ms;
+}
+
+static void cache_store(bq25792_dev_t *dev, uint8_t reg, uint8_t v, long long now) {
+  if (reg >= BQ25792_NREGS || bq25792_reg_class(reg) == BQ25792_REG_VOLATILE) return;
+  dev->cache.val[reg] = (uint8_t)(v & ~self_clear_mask(reg));
+  dev->cache.valid[reg] = 1;
+  dev->cache.ts_ms[reg] = now;
+}
+
+void bq25792_cache_invalidate(bq25792_dev_t *dev) {
+  if (!dev) return;
+  memset(dev->cache.valid, 0, sizeof(dev->cache.valid));
+}
+
+void bq25792_cache_set_refresh_ms(bq25792_dev_t *dev, long long refresh_ms) {
+  if (dev) dev->cache.refresh_ms = refresh_ms;
+}
+
+/* Bir register araliginin tamami cache'ten verilebiliyorsa kopyala */
+static int cache_serve(bq25792_dev_t *dev, uint8_t reg, uint8_t *buf, size_t len) {
+  if ((size_t)reg + len > BQ25792_NREGS) return 0;
+  const long long now = mono_ms();
+  for (size_t i = 0; i < len; i++) {
+    if (!cache_fresh(dev, (uint8_t)(reg + i), now)) return 0;
+  }
+  memcpy(buf, &dev->cache.val[reg], len);
+  M_INC(dev->m.cache_hits, 1);
+  return 1;
+}
+
+static void cache_fill(bq25792_dev_t *dev, uint8_t reg, const uint8_t *buf, size_t len) {
+  const long long now = mono_ms();
+  for (size_t i = 0; i < len && (size_t)reg + i < BQ25792_NREGS; i++) {
+    cache_store(dev, (uint8_t)(reg + i), buf[i], now);
+  }
+}
+
+static int cacheable(uint8_t reg, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    if ((size_t)reg + i >= BQ25792_NREGS || bq25792_reg_class((uint8_t)(reg + i)) == BQ25792_REG_VOLATILE) return 0;
+  }
+  return 1;
+}
+
 int bq25792_read_u8(bq25792_dev_t *dev, uint8_t reg, uint8_t *val) {
   if (!dev || !val) return -EINVAL;
-  int r = i2c_smbus_read_byte_data(dev->fd, reg);
-  if (r < 0) return -errno;
-  *val = (uint8_t)r;
-  return 0;
+  if (cache_serve(dev, reg, val, 1)) return 0;
+  if (cacheable(reg, 1)) M_INC(dev->m.cache_misses, 1);
+  const uint64_t t0 = mono_ns();
+  int rc = dev->ops->read_u8(dev->ctx, reg, val);
+  account(dev, BQ25792_OP_READ_U8, reg, 1, rc, t0);
+  if (rc == 0) cache_fill(dev, reg, val, 1);
+  return rc;
 }
 
+/* Cache'i atlayarak oku; okunan config/static degerler cache'e yazilir */
+static int read_block_uncached(bq25792_dev_t *dev, uint8_t reg, uint8_t *buf, size_t len) {
+  if (cacheable(reg, len)) M_INC(dev->m.cache_misses, 1);
+  int rc = io_read_block(dev, reg, buf, len);
+  if (rc == 0) cache_fill(dev, reg, buf, len);
+  return rc;
+}
+
+/* 16-bit registerlar big-endian (MSB dusuk adreste), iki byte tek transaction */
 int bq25792_read_u16(bq25792_dev_t *dev, uint8_t reg, uint16_t *val) {
-  if (!dev || !val) return -EINVAL;
-  int r = i2c_smbus_read_word_data(dev->fd, reg);
-  if (r < 0) return -errno;
+  if (!dev || !val || reg == 0xFF) return -EINVAL;
+  uint8_t b[2];
+  if (!cache_serve(dev, reg, b, sizeof(b))) {
+    int rc = read_block_uncached(dev, reg, b, sizeof(b));
+    if (rc) return rc;
+  }
+  *val = (uint16_t)((b[0] << 8) | b[1]);
+  return 0;
+}
 
-  /* SMBus word byte sirasi BQ25792 ile ters olabilir -> byte-swap */
-  *val = swap16((uint16_t)r);
+int bq25792_read_block(bq25792_dev_t *dev, uint8_t reg, uint8_t *buf, size_t len) {
+  if (!dev || !buf || len == 0 || (size_t)reg + len > 0x100) return -EINVAL;
+  if (cache_serve(dev, reg, buf, len)) return 0;
+  return read_block_uncached(dev, reg, buf, len);
+}
+
+/* Ayni sinifta (volatile ya da config+static) ardisik register bloklarini img'e oku.
+   uncached: cache'i atla (tazeleme). Flag registerlari sadece VOLATILE ile okunur. */
+static int read_runs(bq25792_dev_t *dev, uint8_t *img, bq25792_reg_class_t cls, int uncached) {
+  const int want_vol = (cls == BQ25792_REG_VOLATILE);
+  int r = 0;
+  while (r < BQ25792_NREGS) {
+    if ((bq25792_reg_class((uint8_t)r) == BQ25792_REG_VOLATILE) != want_vol) { r++; continue; }
+    int end = r;
+    while (end < BQ25792_NREGS && (bq25792_reg_class((uint8_t)end) == BQ25792_REG_VOLATILE) == want_vol) end++;
+    int rc = uncached ? read_block_uncached(dev, (uint8_t)r, &img[r], (size_t)(end - r))
+                      : bq25792_read_block(dev, (uint8_t)r, &img[r], (size_t)(end - r));
+    if (rc) return rc;
+    r = end;
+  }
   return 0;
 }
 
+/* Config/static registerlari ardisik bloklar halinde yeniden oku
+   (REG22..REG27 read-clear flag'lara dokunmadan) */
+int bq25792_cache_refresh(bq25792_dev_t *dev) {
+  if (!dev) return -EINVAL;
+  uint8_t img[BQ25792_NREGS];
+  return read_runs(dev, img, BQ25792_REG_CONFIG, 1);
+}
+
 static int write_u8(bq25792_dev_t *dev, uint8_t reg, uint8_t v) {
-  int r = i2c_smbus_write_byte_data(dev->fd, reg, v);
-  if (r < 0) return -errno;
+  const uint64_t t0 = mono_ns();
+  int rc = dev->ops->write_u8(dev->ctx, reg, v);
+  account(dev, BQ25792_OP_WRITE_U8, reg, 1, rc, t0);
+  if (rc) {
+    /* yazma yarida kalmis olabilir: cihazdaki deger bilinmiyor */
+    if (reg < BQ25792_NREGS) dev->cache.valid[reg] = 0;
+    return rc;
+  }
+  if (reg == BQ25792_REG09_TERM_CTRL && (v & REG_RST)) {
+    /* register reset: her sey POR degerinde, handle durumu da sifirlanir */
+    bq25792_cache_invalidate(dev);
+    dev->inited = 0;
+    dev->adc_ctrl = -1;
+    return 0;
+  }
+  cache_store(dev, reg, v, mono_ms());
   return 0;
 }
 
+int bq25792_write_u8(bq25792_dev_t *dev, uint8_t reg, uint8_t val) {
+  if (!dev) return -EINVAL;
+  return write_u8(dev, reg, val);
+}
+
+/* Okuma cache'ten (config ise); yeni deger ayniysa ve kendiliginden temizlenen
+   bir bit (WD_RST gibi) set edilmiyorsa yazma atlanir */
 static int rmw_u8(bq25792_dev_t *dev, uint8_t reg, uint8_t clear_mask, uint8_t set_mask) {
   uint8_t v = 0;
   int rc = bq25792_read_u8(dev, reg, &v);
   if (rc) return rc;
-  v = (uint8_t)((v & ~clear_mask) | set_mask);
-  return write_u8(dev, reg, v);
+  const uint8_t nv = (uint8_t)((v & ~clear_mask) | set_mask);
+  if (nv == v && !(set_mask & self_clear_mask(reg)) && cacheable(reg, 1)) {
+    M_INC(dev->m.writes_skipped, 1);
+    return 0;
+  }
+  return write_u8(dev, reg, nv);
+}
+
+int bq25792_update_bits(bq25792_dev_t *dev, uint8_t reg, uint8_t mask, uint8_t val) {
+  if (!dev) return -EINVAL;
+  return rmw_u8(dev, reg, mask, (uint8_t)(val & mask));
 }
 
 static int bq25792_apply_safe_defaults(bq25792_dev_t *dev) {
   /* I2C watchdog'u disable et (REG10[2:0]=0) -> ADC_EN / EN_IBAT beklenmedik reset olmasin */
-  int rc = rmw_u8(dev, REG10_CHG_CTRL_1, 0x07, 0x00);
+  int rc = rmw_u8(dev, BQ25792_REG10_CHG_CTRL_1, 0x07, 0x00);
   if (rc) return rc;
 
   /* WD status temizlemek icin WD_RST pulse (opsiyonel) */
-  (void)rmw_u8(dev, REG10_CHG_CTRL_1, 0x00, (1u << 3));
+  (void)rmw_u8(dev, BQ25792_REG10_CHG_CTRL_1, 0x00, (1u << 3));
 
   /* IBAT discharge current sensing enable (REG14[5]) */
-  rc = rmw_u8(dev, REG14_CHG_CTRL_5, 0x00, (1u << 5));
+  rc = rmw_u8(dev, BQ25792_REG14_CHG_CTRL_5, 0x00, (1u << 5));
   return rc;
 }
 
@@ -146,16 +447,156 @@ static int bq25792_apply_safe_defaults(bq25792_dev_t *dev) {
    bit6 ADC_RATE: 0=continuous, 1=one-shot
    bit5-4 ADC_SAMPLE: 00=15-bit, 01=14-bit, 10=13-bit, 11=12-bit
 */
+static uint8_t adc_ctrl_value(bool enable_continuous, bool high_res_15bit) {
+  uint8_t v = 0;
+  v |= ADC_EN;
+  if (!enable_continuous) v |= ADC_RATE_ONESHOT; /* 1 = one-shot */
+  /* ADC_SAMPLE[5:4]: 00=15-bit, 01=14-bit */
+  if (!high_res_15bit) v |= (1u << ADC_SAMPLE_SHIFT);
+  return v;
+}
+
 int bq25792_adc_enable(bq25792_dev_t *dev, bool enable_continuous, bool high_res_15bit) {
   if (!dev) return -EINVAL;
 
-  uint8_t v = 0;
-  v |= (1u << 7); /* ADC_EN */
-  if (!enable_continuous) v |= (1u << 6); /* 1 = one-shot */
-  /* ADC_SAMPLE[5:4]: 00=15-bit, 01=14-bit */
-  if (!high_res_15bit) v |= (1u << 4);
+  const uint8_t v = adc_ctrl_value(enable_continuous, high_res_15bit);
+  int rc = write_u8(dev, BQ25792_REG2E_ADC_CONTROL, v);
+  dev->adc_ctrl = rc ? -1 : v;
+  return rc;
+}
+
+/* ADC'yi ilk kez (ya da cihaz resetlendikten sonra) acar.
+   Continuous modda ADC_DONE_STAT hep 0 okunur; bu yuzden once one-shot
+   conversion baslatilir, ADC_DONE_STAT polling ile (sinirli deadline) beklenir,
+   sonra istenen continuous moda gecilir. Sonraki snapshot'lar beklemeden okur. */
+static int adc_start_and_wait(bq25792_dev_t *dev, bool high_res_15bit) {
+  const uint8_t oneshot = adc_ctrl_value(false, high_res_15bit);
+  int rc = write_u8(dev, BQ25792_REG2E_ADC_CONTROL, oneshot);
+  if (rc) {
+    dev->adc_ctrl = -1;
+    return rc;
+  }
+
+  /* dongu suresi etkin kanal sayisiyla orantili (REG2F/30 normalde cache'te) */
+  uint32_t chans = BQ25792_ADC_ALL;
+  (void)bq25792_adc_get_channels(dev, &chans);
+  int nch = __builtin_popcount(chans);
+  if (nch < 1) nch = 1;
+  const int sample = (oneshot >> ADC_SAMPLE_SHIFT) & 0x3;
+  const long long deadline = mono_ms() + nch * adc_conv_ms[sample] + ADC_WAIT_SLACK_MS;
+  for (;;) {
+    uint8_t s3 = 0;
+    if (bq25792_read_u8(dev, BQ25792_REG1E_CHG_STATUS_3, &s3) == 0 && (s3 & ADC_DONE_STAT)) break;
+    if (mono_ms() >= deadline) break; /* timeout: eldeki degerlerle devam */
+    usleep(ADC_POLL_US);
+  }
+  dev->adc_stale = 0;
+
+  return bq25792_adc_enable(dev, true, high_res_15bit);
+}
+
+/* REG2F/REG30 disable bitlerinden etkin kanal maskesi */
+static uint32_t adc_mask_from_dis(const uint8_t dis[2]) {
+  uint32_t m = 0;
+  for (int i = 0; i < ADC_NUM_CHANNELS; i++) {
+    const uint8_t d = dis[adc_dis[i].reg - BQ25792_REG2F_ADC_FUNC_DIS_0];
+    if (!(d & (1u << adc_dis[i].bit))) m |= 1u << i;
+  }
+  return m;
+}
+
+int bq25792_adc_get_channels(bq25792_dev_t *dev, uint32_t *mask) {
+  if (!dev || !mask) return -EINVAL;
+  uint8_t dis[2];
+  int rc = bq25792_read_block(dev, BQ25792_REG2F_ADC_FUNC_DIS_0, dis, sizeof(dis));
+  if (rc) return rc;
+  *mask = adc_mask_from_dis(dis);
+  return 0;
+}
+
+int bq25792_adc_set_channels(bq25792_dev_t *dev, uint32_t mask) {
+  if (!dev || !(mask & BQ25792_ADC_ALL)) return -EINVAL;
+  uint32_t prev = 0;
+  int rc = bq25792_adc_get_channels(dev, &prev);
+  if (rc) return rc;
+
+  uint8_t dis[2] = { 0, 0 };
+  for (int i = 0; i < ADC_NUM_CHANNELS; i++) {
+    if (!(mask & (1u << i))) dis[adc_dis[i].reg - BQ25792_REG2F_ADC_FUNC_DIS_0] |= (uint8_t)(1u << adc_dis[i].bit);
+  }
+  rc = bq25792_update_bits(dev, BQ25792_REG2F_ADC_FUNC_DIS_0, ADC_DIS_0_MASK, dis[0]);
+  if (rc == 0) rc = bq25792_update_bits(dev, BQ25792_REG30_ADC_FUNC_DIS_1, ADC_DIS_1_MASK, dis[1]);
+  if (rc) return rc;
+
+  /* Yeni acilan kanallarin sonuc registerlari eski: bir sonraki okuma
+     one-shot ile ilk donusumu beklesin */
+  if (mask & ~prev & BQ25792_ADC_ALL) {
+    dev->adc_ctrl = -1;
+    dev->adc_stale = 1;
+  }
+  return 0;
+}
+
+static const char *const adc_names[ADC_NUM_CHANNELS] = {
+  "ibus", "ibat", "vbus", "vac1", "vac2", "vbat", "vsys", "ts", "tdie", "dp", "dm",
+};
+
+int bq25792_adc_channels_parse(const char *s, uint32_t *mask) {
+  if (!s || !mask) return -EINVAL;
+  uint32_t m = 0;
+  while (*s) {
+    size_t n = strcspn(s, ", ");
+    if (n == 3 && strncmp(s, "all", 3) == 0) m |= BQ25792_ADC_ALL;
+    else if (n == 6 && strncmp(s, "status", 6) == 0) m |= BQ25792_ADC_STATUS;
+    else if (n > 0) {
+      int i = 0;
+      while (i < ADC_NUM_CHANNELS && !(strlen(adc_names[i]) == n && strncmp(s, adc_names[i], n) == 0)) i++;
+      if (i == ADC_NUM_CHANNELS) return -EINVAL;
+      m |= 1u << i;
+    }
+    s += n;
+    while (*s == ',' || *s == ' ') s++;
+  }
+  if (!m) return -EINVAL;
+  *mask = m;
+  return 0;
+}
+
+int bq25792_read_adc(bq25792_dev_t *dev, uint32_t mask, bq25792_adc_t *out) {
+  if (!dev || !out) return -EINVAL;
+  mask &= BQ25792_ADC_ALL;
+  if (!mask) return -EINVAL;
+  memset(out, 0, sizeof(*out));
+
+  int rc = bq25792_adc_set_channels(dev, mask);
+  if (rc) return rc;
+  if (dev->adc_ctrl != adc_ctrl_value(true, true)) (void)adc_start_and_wait(dev, true);
 
-  return write_u8(dev, REG2E_ADC_CONTROL, v);
+  /* mask'i kapsayan en kisa aralik, tek transaction */
+  const int first = __builtin_ctz(mask);
+  const int last = 31 - __builtin_clz(mask);
+  uint8_t b[2 * ADC_NUM_CHANNELS];
+  rc = bq25792_read_block(dev, (uint8_t)(BQ25792_REG31_IBUS_ADC + 2 * first), b, (size_t)(2 * (last - first + 1)));
+  if (rc) return rc;
+
+  int v[ADC_NUM_CHANNELS];
+  for (int i = first; i <= last; i++) {
+    const uint8_t *p = &b[2 * (i - first)];
+    v[i] = (uint16_t)((p[0] << 8) | p[1]);
+  }
+  if (mask & BQ25792_ADC_IBUS) out->ibus_ma = (int16_t)v[0];
+  if (mask & BQ25792_ADC_IBAT) out->ibat_ma = (int16_t)v[1];
+  if (mask & BQ25792_ADC_VBUS) out->vbus_mv = v[2];
+  if (mask & BQ25792_ADC_VAC1) out->vac1_mv = v[3];
+  if (mask & BQ25792_ADC_VAC2) out->vac2_mv = v[4];
+  if (mask & BQ25792_ADC_VBAT) out->vbat_mv = v[5];
+  if (mask & BQ25792_ADC_VSYS) out->vsys_mv = v[6];
+  if (mask & BQ25792_ADC_TS)   out->ts_pct = (float)v[7] * 0.0976563f;
+  if (mask & BQ25792_ADC_TDIE) out->tdie_c = (float)((int16_t)v[8]) * 0.5f;
+  if (mask & BQ25792_ADC_DP)   out->dp_mv = v[9];
+  if (mask & BQ25792_ADC_DM)   out->dm_mv = v[10];
+  out->valid = mask;
+  return 0;
 }
 
 const char* bq25792_chg_stat_str(uint8_t s) {
@@ -187,71 +628,140 @@ const char* bq25792_vbus_stat_str(uint8_t s) {
   }
 }
 
-int bq25792_read_status(bq25792_dev_t *dev, bq25792_status_t *st, bool ensure_adc_on) {
-  if (!dev || !st) return -EINVAL;
+/* IBAT..VBAT (REG33..REG3C) tek transaction: coulomb counter'in sicak yolu.
+   ADC'nin acik oldugu varsayilir (read_status ile acilir). */
+int bq25792_read_vbat_ibat(bq25792_dev_t *dev, int *vbat_mv, int *ibat_ma) {
+  if (!dev || !vbat_mv || !ibat_ma) return -EINVAL;
+  uint8_t b[BQ25792_REG3B_VBAT_ADC + 2 - BQ25792_REG33_IBAT_ADC];
+  int rc = bq25792_read_block(dev, BQ25792_REG33_IBAT_ADC, b, sizeof(b));
+  if (rc) return rc;
+  *ibat_ma = (int16_t)((b[0] << 8) | b[1]);
+  *vbat_mv = (int)(uint16_t)((b[BQ25792_REG3B_VBAT_ADC - BQ25792_REG33_IBAT_ADC] << 8) | b[BQ25792_REG3B_VBAT_ADC - BQ25792_REG33_IBAT_ADC + 1]);
+  return 0;
+}
+
+/* IBUS..VBAT (REG31..REG3C) tek transaction: enerji sayacinin sicak yolu,
+   read_vbat_ibat'tan 4 byte uzun. ADC'nin acik oldugu varsayilir. */
+int bq25792_read_power(bq25792_dev_t *dev, bq25792_power_t *out) {
+  if (!dev || !out) return -EINVAL;
+  uint8_t b[BQ25792_REG3B_VBAT_ADC + 2 - BQ25792_REG31_IBUS_ADC];
+  int rc = bq25792_read_block(dev, BQ25792_REG31_IBUS_ADC, b, sizeof(b));
+  if (rc) return rc;
+#define W(reg) ((b[(reg) - BQ25792_REG31_IBUS_ADC] << 8) | b[(reg) - BQ25792_REG31_IBUS_ADC + 1])
+  out->ibus_ma = (int16_t)W(BQ25792_REG31_IBUS_ADC);
+  out->ibat_ma = (int16_t)W(BQ25792_REG33_IBAT_ADC);
+  out->vbus_mv = (int)(uint16_t)W(BQ25792_REG35_VBUS_ADC);
+  out->vbat_mv = (int)(uint16_t)W(BQ25792_REG3B_VBAT_ADC);
+#undef W
+  return 0;
+}
+
+/* read_status govdesi: REG0A + REG1B..REG46 penceresi img'e (adrese gore) okunur */
+static int read_status_img(bq25792_dev_t *dev, bq25792_status_t *st, bool ensure_adc_on, uint8_t *img) {
   memset(st, 0, sizeof(*st));
+  M_INC(dev->m.status_reads, 1);
 
   if (!dev->inited) {
     (void)bq25792_apply_safe_defaults(dev);
     dev->inited = 1;
   }
 
-  /* Cell count from REG0A[7:6] (1s..4s) */
-  uint8_t reg0a = 0;
-  if (bq25792_read_u8(dev, REG0A_RECHG_CTRL, &reg0a) == 0) {
-    uint8_t cell = (reg0a >> 6) & 0x3;
-    st->cell_count = (uint8_t)(cell + 1);
-  } else {
-    st->cell_count = 1;
+  /* Cell count REG0A[7:6]; config register, normalde cache'ten (okunamazsa 1s) */
+  if (bq25792_read_u8(dev, BQ25792_REG0A_RECHG_CTRL, &img[BQ25792_REG0A_RECHG_CTRL]) != 0) {
+    img[BQ25792_REG0A_RECHG_CTRL] = 0;
   }
 
-  uint8_t s0 = 0, s1 = 0;
-  int rc = bq25792_read_u8(dev, REG1B_CHG_STATUS_0, &s0);
-  if (rc) return rc;
-  rc = bq25792_read_u8(dev, REG1C_CHG_STATUS_1, &s1);
-  if (rc) return rc;
+  /* ADC enable if requested (pencere okunmadan once; tum alanlar ayni andan gelsin).
+     Handle zaten continuous modu programladiysa tekrar yazmaz ve beklemez. */
+  const uint8_t adc_want = adc_ctrl_value(true, true);
+  if (ensure_adc_on && dev->adc_ctrl < 0 && !dev->adc_stale) {
+    /* Onceki surec (orn. daemon yeniden baslatildi) continuous modu acik biraktiysa
+       devral: donusumler zaten suruyor, one-shot beklemesine gerek yok. Kanal
+       yeni acildiysa (adc_stale) sonuc registerlari eski, devralinmaz. */
+    uint8_t cur = 0;
+    if (bq25792_read_u8(dev, BQ25792_REG2E_ADC_CONTROL, &cur) == 0 && cur == adc_want) dev->adc_ctrl = cur;
+  }
+  if (ensure_adc_on && dev->adc_ctrl != adc_want) {
+    (void)adc_start_and_wait(dev, true);
+  }
+
+  /* REG1B..REG46: status + flag + ADC tek transaction */
+  int rc = bq25792_read_block(dev, STATUS_WIN_FIRST, &img[STATUS_WIN_FIRST], STATUS_WIN_LEN);
+  if (rc) goto fail;
+
+  /* Cihaz resetlenip ADC kapanmissa ya da durum kanallarindan biri kapatilmissa
+     (baska surecte bq25792_read_adc) yeniden ac ve tekrar oku. REG2E..REG30
+     pencerede: karar cache'ten (60 s bayat kalabilir) degil bu burst'ten, cache de
+     burada tazelenir. */
+  const long long now = mono_ms();
+  cache_store(dev, BQ25792_REG2F_ADC_FUNC_DIS_0, img[BQ25792_REG2F_ADC_FUNC_DIS_0], now);
+  cache_store(dev, BQ25792_REG30_ADC_FUNC_DIS_1, img[BQ25792_REG30_ADC_FUNC_DIS_1], now);
+  const uint32_t chans = adc_mask_from_dis(&img[BQ25792_REG2F_ADC_FUNC_DIS_0]);
+  const bool adc_off = ensure_adc_on && !(img[BQ25792_REG2E_ADC_CONTROL] & ADC_EN);
+  const bool chans_off = ensure_adc_on && (chans & BQ25792_ADC_STATUS) != BQ25792_ADC_STATUS;
+  if (adc_off || chans_off) {
+    /* ilk burst'te okunup temizlenen flag'lar: tam da bu reset/ADC kapanmasinin izi */
+    uint8_t flags[BQ25792_REG27_FAULT_FLAG_1 + 1 - BQ25792_REG22_CHG_FLAG_0];
+    memcpy(flags, &img[BQ25792_REG22_CHG_FLAG_0], sizeof(flags));
+    if (adc_off) {
+      M_INC(dev->m.adc_restarts, 1);
+      /* ADC kapali bulunduysa cihaz resetlenmis olabilir: config cache'i gecersiz,
+         safe default'lar (watchdog kapali, IBAT sense) yeniden yazilir */
+      bq25792_cache_invalidate(dev);
+      (void)bq25792_apply_safe_defaults(dev);
+      dev->inited = 1;
+    }
+    if (chans_off) (void)bq25792_adc_set_channels(dev, chans | BQ25792_ADC_STATUS);
+    (void)adc_start_and_wait(dev, true);
+    rc = bq25792_read_block(dev, STATUS_WIN_FIRST, &img[STATUS_WIN_FIRST], STATUS_WIN_LEN);
+    if (rc) goto fail;
+    for (size_t i = 0; i < sizeof(flags); i++) img[BQ25792_REG22_CHG_FLAG_0 + i] |= flags[i];
+  }
+
+  /* Alanlar ve SoC tahmini register tablosundan (bq25792_regs.h) */
+  bq25792_decode_status(img, st);
 
-  st->iindpm = (s0 >> 7) & 1;
-  st->vindpm = (s0 >> 6) & 1;
-  st->watchdog_expired = (s0 >> 5) & 1;
-  st->poor_source = (s0 >> 4) & 1;
-  st->pg = (s0 >> 3) & 1;
-  st->ac2_present = (s0 >> 2) & 1;
-  st->ac1_present = (s0 >> 1) & 1;
-  st->vbus_present = (s0 >> 0) & 1;
-
-  st->chg_stat = (s1 >> 5) & 0x7;
-  st->vbus_stat = (s1 >> 1) & 0xF;
-  st->bc12_done = (s1 >> 0) & 1;
-
-  /* Fault flags */
-  uint8_t f0 = 0, f1 = 0;
-  (void)bq25792_read_u8(dev, REG26_FAULT_FLAG_0, &f0);
-  (void)bq25792_read_u8(dev, REG27_FAULT_FLAG_1, &f1);
-  st->fault0 = f0;
-  st->fault1 = f1;
-  st->fault_any = (f0 != 0) || (f1 != 0) || st->watchdog_expired || st->poor_source;
-
-  /* ADC enable if requested */
-  if (ensure_adc_on) {
-    (void)bq25792_adc_enable(dev, true, true);
-    /* ADC enable sonrasi ilk conversion 0 gelebilir */
-    usleep(50000);
+  /* Watchdog dolunca config registerlari POR degerine doner: safe default'lar
+     sonraki okumada yeniden yazilir (REG_RST'teki gibi) */
+  if (st->watchdog_expired) {
+    bq25792_cache_invalidate(dev);
+    dev->inited = 0;
   }
+  return 0;
 
-  /* ADC reads (LSB=1mV/1mA, TDIE=0.5C) */
-  uint16_t w = 0;
-  if (bq25792_read_u16(dev, REG31_IBUS_ADC, &w) == 0) st->ibus_ma = (int16_t)w;
-  if (bq25792_read_u16(dev, REG33_IBAT_ADC, &w) == 0) st->ibat_ma = (int16_t)w;
-  if (bq25792_read_u16(dev, REG35_VBUS_ADC, &w) == 0) st->vbus_mv = (int)w;
-  if (bq25792_read_u16(dev, REG3B_VBAT_ADC, &w) == 0) st->vbat_mv = (int)w;
-  if (bq25792_read_u16(dev, REG3D_VSYS_ADC, &w) == 0) st->vsys_mv = (int)w;
-  if (bq25792_read_u16(dev, REG41_TDIE_ADC, &w) == 0) st->tdie_c = (float)((int16_t)w) * 0.5f;
+fail:
+  M_INC(dev->m.status_errors, 1);
+  return rc;
+}
 
-  /* SoC estimate from per-cell voltage */
-  if (st->cell_count < 1) st->cell_count = 1;
-  int vcell = (st->vbat_mv > 0) ? (st->vbat_mv / (int)st->cell_count) : 0;
-  st->soc_pct_est = soc_from_vcell_mv(vcell);
+int bq25792_read_status(bq25792_dev_t *dev, bq25792_status_t *st, bool ensure_adc_on) {
+  if (!dev || !st) return -EINVAL;
+  uint8_t img[BQ25792_NREGS];
+  return read_status_img(dev, st, ensure_adc_on, img);
+}
 
+/* read_status + tam register imaji: config/static kisim cache'ten (bayatladiysa
+   bloklar halinde cihazdan), status/flag/ADC penceresi ayni burst'ten */
+int bq25792_read_status_regs(bq25792_dev_t *dev, bq25792_status_t *st, bool ensure_adc_on,
+                             uint8_t img[BQ25792_NREGS]) {
+  if (!dev || !st || !img) return -EINVAL;
+  memset(img, 0, BQ25792_NREGS);
+  int rc = read_status_img(dev, st, ensure_adc_on, img);
+  if (rc) return rc;
+  (void)read_runs(dev, img, BQ25792_REG_CONFIG, 0);
   return 0;
 }
+
+int bq25792_read_regs(bq25792_dev_t *dev, uint8_t img[BQ25792_NREGS]) {
+  if (!dev || !img) return -EINVAL;
+  memset(img, 0, BQ25792_NREGS);
+  int rc = read_runs(dev, img, BQ25792_REG_CONFIG, 0);
+  if (rc == 0) rc = read_runs(dev, img, BQ25792_REG_VOLATILE, 0);
+  return rc;
+}
+
+int bq25792_read_event_regs(bq25792_dev_t *dev, uint8_t img[BQ25792_NREGS]) {
+  if (!dev || !img) return -EINVAL;
+  return bq25792_read_block(dev, BQ25792_EVENT_WIN_FIRST, &img[BQ25792_EVENT_WIN_FIRST],
+                            BQ25792_EVENT_WIN_LAST - BQ25792_EVENT_WIN_FIRST + 1);
+}
@@ -0,0 +1,318 @@
+#include "bq25792_async.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+  Sabit slot havuzu, uc liste (indeks ile bagli): bos, bekleyen (FIFO) ve hazir
+  (FIFO). Birlestirilen istekler bekleyen slotun dup zincirine eklenir ve onunla
+  birlikte hazir listesine gecer. Tum listeler mu altinda.
+*/
+
+typedef struct {
+  bq25792_async_result_t r;
+  int next;   /* liste baglantisi, -1 = son */
+  int dup;    /* birlestirilmis istekler, -1 = yok */
+} slot_t;
+
+struct bq25792_async {
+  bq25792_dev_t *dev;
+  int efd;
+  pthread_t th;
+  pthread_mutex_t mu;
+  pthread_cond_t cv;
+  int stop;
+
+  uint64_t next_id;
+  slot_t slot[BQ25792_ASYNC_DEPTH];
+  int free_head;
+  int q_head, q_tail;       /* bekleyen */
+  int done_head, done_tail; /* hazir */
+
+  bq25792_async_stats_t stats;
+};
+
+static int64_t mono_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void list_push(slot_t *slot, int *head, int *tail, int i) {
+  slot[i].next = -1;
+  if (*tail >= 0) slot[*tail].next = i;
+  else *head = i;
+  *tail = i;
+}
+
+static int list_pop(slot_t *slot, int *head, int *tail) {
+  const int i = *head;
+  if (i < 0) return -1;
+  *head = slot[i].next;
+  if (*head < 0) *tail = -1;
+  slot[i].next = -1;
+  return i;
+}
+
+static void slot_free(bq25792_async_t *a, int i) {
+  a->slot[i].next = a->free_head;
+  a->free_head = i;
+}
+
+/* Istegi calistirir; sonuc r'ye. mu tutulmaz (I2C burada bloklar). */
+static void run_req(bq25792_dev_t *dev, bq25792_async_result_t *r) {
+  switch (r->kind) {
+    case BQ25792_ASYNC_STATUS:
+      r->rc = bq25792_read_status_regs(dev, &r->st, r->ensure_adc_on, r->img);
+      break;
+    case BQ25792_ASYNC_REGS:
+      r->rc = bq25792_read_regs(dev, r->img);
+      break;
+    case BQ25792_ASYNC_READ:
+      r->rc = bq25792_read_block(dev, r->reg, &r->img[r->reg], r->len);
+      break;
+    case BQ25792_ASYNC_UPDATE_BITS:
+      r->rc = bq25792_update_bits(dev, r->reg, r->mask, r->val);
+      break;
+    default:
+      r->rc = -EINVAL;
+      break;
+  }
+}
+
+static void *worker_main(void *arg) {
+  bq25792_async_t *a = (bq25792_async_t*)arg;
+  pthread_mutex_lock(&a->mu);
+  for (;;) {
+    while (!a->stop && a->q_head < 0) pthread_cond_wait(&a->cv, &a->mu);
+    if (a->stop) break;
+
+    const int i = list_pop(a->slot, &a->q_head, &a->q_tail);
+    /* Calisirken slot'un argumanlari degismez; yeni istekler bu slota eklenmez */
+    bq25792_async_result_t r = a->slot[i].r;
+    pthread_mutex_unlock(&a->mu);
+
+    run_req(a->dev, &r);
+    r.done_ns = mono_ns();
+
+    pthread_mutex_lock(&a->mu);
+    a->slot[i].r = r;
+    int n = 1;
+    for (int d = a->slot[i].dup; d >= 0; d = a->slot[d].dup, n++) {
+      bq25792_async_result_t *c = &a->slot[d].r;
+      c->rc = r.rc;
+      c->done_ns = r.done_ns;
+      c->st = r.st;
+      memcpy(c->img, r.img, sizeof(c->img));
+    }
+    for (int d = i; d >= 0; d = a->slot[d].dup) list_push(a->slot, &a->done_head, &a->done_tail, d);
+    a->stats.completed += (uint64_t)n;
+    a->stats.pending -= (uint32_t)n;
+    a->stats.ready += (uint32_t)n;
+    pthread_mutex_unlock(&a->mu);
+
+    const uint64_t one = 1;
+    (void)!write(a->efd, &one, sizeof(one));
+
+    pthread_mutex_lock(&a->mu);
+  }
+  pthread_mutex_unlock(&a->mu);
+  return NULL;
+}
+
+int bq25792_async_open(bq25792_async_t **out, bq25792_dev_t *dev) {
+  if (!out || !dev) return -EINVAL;
+  *out = NULL;
+
+  bq25792_async_t *a = (bq25792_async_t*)calloc(1, sizeof(*a));
+  if (!a) return -ENOMEM;
+  a->dev = dev;
+  a->next_id = 1;
+  a->q_head = a->q_tail = -1;
+  a->done_head = a->done_tail = -1;
+  a->free_head = -1;
+  for (int i = BQ25792_ASYNC_DEPTH - 1; i >= 0; i--) slot_free(a, i);
+
+  a->efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (a->efd < 0) {
+    const int rc = -errno;
+    free(a);
+    return rc;
+  }
+  pthread_mutex_init(&a->mu, NULL);
+  pthread_cond_init(&a->cv, NULL);
+
+  const int prc = pthread_create(&a->th, NULL, worker_main, a);
+  if (prc != 0) {
+    pthread_cond_destroy(&a->cv);
+    pthread_mutex_destroy(&a->mu);
+    close(a->efd);
+    free(a);
+    return -prc;
+  }
+  *out = a;
+  return 0;
+}
+
+void bq25792_async_close(bq25792_async_t *a) {
+  if (!a) return;
+  pthread_mutex_lock(&a->mu);
+  a->stop = 1;
+  pthread_cond_signal(&a->cv);
+  pthread_mutex_unlock(&a->mu);
+  pthread_join(a->th, NULL);
+
+  pthread_cond_destroy(&a->cv);
+  pthread_mutex_destroy(&a->mu);
+  close(a->efd);
+  free(a);
+}
+
+int bq25792_async_fd(const bq25792_async_t *a) {
+  return a ? a->efd : -EINVAL;
+}
+
+static int coalescable(uint8_t kind) {
+  return kind == BQ25792_ASYNC_STATUS || kind == BQ25792_ASYNC_REGS;
+}
+
+/* Ayni turden, arkasinda yazma olmayan son bekleyen istek; yoksa -1 */
+static int find_dup_target(const bq25792_async_t *a, const bq25792_async_result_t *r) {
+  if (!coalescable(r->kind)) return -1;
+  int cand = -1;
+  for (int i = a->q_head; i >= 0; i = a->slot[i].next) {
+    const bq25792_async_result_t *q = &a->slot[i].r;
+    if (q->kind == BQ25792_ASYNC_UPDATE_BITS) cand = -1;
+    else if (q->kind == r->kind && (r->kind != BQ25792_ASYNC_STATUS || q->ensure_adc_on == r->ensure_adc_on)) cand = i;
+  }
+  return cand;
+}
+
+static int submit(bq25792_async_t *a, const bq25792_async_result_t *req, uint64_t *id) {
+  if (!a) return -EINVAL;
+  pthread_mutex_lock(&a->mu);
+  if (a->stop) {
+    pthread_mutex_unlock(&a->mu);
+    return -ESHUTDOWN;
+  }
+  const int i = a->free_head;
+  if (i < 0) {
+    a->stats.rejected++;
+    pthread_mutex_unlock(&a->mu);
+    return -EAGAIN;
+  }
+  a->free_head = a->slot[i].next;
+
+  slot_t *s = &a->slot[i];
+  s->r = *req;
+  s->r.id = a->next_id++;
+  s->r.submit_ns = mono_ns();
+  s->next = -1;
+  s->dup = -1;
+
+  const int target = find_dup_target(a, &s->r);
+  if (target >= 0) {
+    int t = target;
+    while (a->slot[t].dup >= 0) t = a->slot[t].dup;
+    a->slot[t].dup = i;
+    s->r.coalesced = true;
+    a->stats.coalesced++;
+  } else {
+    list_push(a->slot, &a->q_head, &a->q_tail, i);
+    pthread_cond_signal(&a->cv);
+  }
+  a->stats.submitted++;
+  a->stats.pending++;
+  if (id) *id = s->r.id;
+  pthread_mutex_unlock(&a->mu);
+  return 0;
+}
+
+int bq25792_async_submit_status(bq25792_async_t *a, bool ensure_adc_on, void *user, uint64_t *id) {
+  bq25792_async_result_t r;
+  memset(&r, 0, sizeof(r));
+  r.kind = BQ25792_ASYNC_STATUS;
+  r.ensure_adc_on = ensure_adc_on;
+  r.user = user;
+  return submit(a, &r, id);
+}
+
+int bq25792_async_submit_regs(bq25792_async_t *a, void *user, uint64_t *id) {
+  bq25792_async_result_t r;
+  memset(&r, 0, sizeof(r));
+  r.kind = BQ25792_ASYNC_REGS;
+  r.user = user;
+  return submit(a, &r, id);
+}
+
+int bq25792_async_submit_read(bq25792_async_t *a, uint8_t reg, uint8_t len, void *user, uint64_t *id) {
+  if (len == 0 || (size_t)reg + len > BQ25792_NREGS) return -EINVAL;
+  bq25792_async_result_t r;
+  memset(&r, 0, sizeof(r));
+  r.kind = BQ25792_ASYNC_READ;
+  r.reg = reg;
+  r.len = len;
+  r.user = user;
+  return submit(a, &r, id);
+}
+
+int bq25792_async_submit_update_bits(bq25792_async_t *a, uint8_t reg, uint8_t mask, uint8_t val,
+                                     void *user, uint64_t *id) {
+  bq25792_async_result_t r;
+  memset(&r, 0, sizeof(r));
+  r.kind = BQ25792_ASYNC_UPDATE_BITS;
+  r.reg = reg;
+  r.mask = mask;
+  r.val = val;
+  r.user = user;
+  return submit(a, &r, id);
+}
+
+int bq25792_async_reap(bq25792_async_t *a, bq25792_async_result_t *out, int max) {
+  if (!a || (!out && max > 0)) return -EINVAL;
+
+  /* Once sayaci sifirla: sonradan gelen tamamlanma fd'yi yeniden tetikler */
+  uint64_t cnt;
+  (void)!read(a->efd, &cnt, sizeof(cnt));
+
+  pthread_mutex_lock(&a->mu);
+  int n = 0;
+  while (n < max) {
+    const int i = list_pop(a->slot, &a->done_head, &a->done_tail);
+    if (i < 0) break;
+    out[n++] = a->slot[i].r;
+    slot_free(a, i);
+  }
+  a->stats.ready -= (uint32_t)n;
+  const int more = a->done_head >= 0;
+  pthread_mutex_unlock(&a->mu);
+
+  if (more) {
+    const uint64_t one = 1;
+    (void)!write(a->efd, &one, sizeof(one));
+  }
+  return n;
+}
+
+int bq25792_async_get_stats(bq25792_async_t *a, bq25792_async_stats_t *out) {
+  if (!a || !out) return -EINVAL;
+  pthread_mutex_lock(&a->mu);
+  *out = a->stats;
+  pthread_mutex_unlock(&a->mu);
+  return 0;
+}
+
+const char* bq25792_async_kind_str(uint8_t kind) {
+  switch (kind) {
+    case BQ25792_ASYNC_STATUS:      return "status";
+    case BQ25792_ASYNC_REGS:        return "regs";
+    case BQ25792_ASYNC_READ:        return "read";
+    case BQ25792_ASYNC_UPDATE_BITS: return "update_bits";
+    default:                        return "unknown";
+  }
+}
@@ -0,0 +1,394 @@
+#define _GNU_SOURCE
+#include "bq25792.h"
+#include "bq25792_async.h"
+#include "bq25792_capture.h"
+#include "bq25792_sim.h"
+#include "bq25792_soc.h"
+#include "bq25792_stats.h"
+#include "bq25792_transport.h"
+
+#include <errno.h>
+#include <getopt.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+  Kutuphane sicak yollari icin mikrobenchmark. Her vaka icin gecikme dagilimi
+  (p50/p99/max), islem basina I2C transaction/byte ve heap allocation sayisi.
+  Varsayilan bus: simulator uzerine sayac transport'u (cipsiz, sabit maliyet);
+  --bus ile gercek /dev/i2c-N. Cikti tek JSON dokumani (--text: tablo).
+*/
+
+/* ---- allocation sayaci (glibc: executable'daki tanim kutuphaneyi de kapsar) ---- */
+
+static unsigned long long g_allocs;
+
+#ifdef __GLIBC__
+extern void *__libc_malloc(size_t);
+extern void *__libc_calloc(size_t, size_t);
+extern void *__libc_realloc(void*, size_t);
+extern void  __libc_free(void*);
+
+void *malloc(size_t n) { g_allocs++; return __libc_malloc(n); }
+void *calloc(size_t n, size_t m) { g_allocs++; return __libc_calloc(n, m); }
+void *realloc(void *p, size_t n) { g_allocs++; return __libc_realloc(p, n); }
+void  free(void *p) { __libc_free(p); }
+#define ALLOC_COUNTING 1
+#else
+#define ALLOC_COUNTING 0
+#endif
+
+/* ---- sayac transport: ic handle'in ops/ctx'ine iletir ---- */
+
+typedef struct {
+  bq25792_dev_t *inner;
+  const bq25792_transport_ops_t *ops;
+  void *ctx;
+  unsigned long long txn;
+  unsigned long long bytes;   /* register pointer + veri (adres byte'lari haric) */
+} count_ctx_t;
+
+static int cnt_read_u8(void *ctx, uint8_t reg, uint8_t *val) {
+  count_ctx_t *c = (count_ctx_t*)ctx;
+  c->txn++;
+  c->bytes += 2;
+  return c->ops->read_u8(c->ctx, reg, val);
+}
+
+static int cnt_write_u8(void *ctx, uint8_t reg, uint8_t val) {
+  count_ctx_t *c = (count_ctx_t*)ctx;
+  c->txn++;
+  c->bytes += 2;
+  return c->ops->write_u8(c->ctx, reg, val);
+}
+
+static int cnt_read_block(void *ctx, uint8_t reg, uint8_t *buf, size_t len) {
+  count_ctx_t *c = (count_ctx_t*)ctx;
+  c->txn++;
+  c->bytes += 1 + len;
+  return c->ops->read_block(c->ctx, reg, buf, len);
+}
+
+static void cnt_close(void *ctx) {
+  count_ctx_t *c = (count_ctx_t*)ctx;
+  bq25792_close(c->inner);
+}
+
+static const bq25792_transport_ops_t count_ops = {
+  .name = "count",
+  .read_u8 = cnt_read_u8,
+  .write_u8 = cnt_write_u8,
+  .read_block = cnt_read_block,
+  .close = cnt_close,
+};
+
+/* ---- olcum ---- */
+
+static long long mono_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int cmp_ll(const void *a, const void *b) {
+  const long long x = *(const long long*)a, y = *(const long long*)b;
+  return (x > y) - (x < y);
+}
+
+typedef struct {
+  bq25792_dev_t *dev;
+  bq25792_async_t *async;   /* async vakasinda acilir; sonrasinda dev dogrudan kullanilmaz */
+  count_ctx_t *cnt;
+  bq25792_status_t st;
+  bq25792_socfilt_t filt;
+  bq25792_stats_t stats;
+  bq25792_snapshot_t snap;
+  char json[2048];
+  unsigned iter;
+  int err;
+} bench_ctx_t;
+
+typedef void (*bench_fn)(bench_ctx_t *b);
+
+typedef struct {
+  const char *name;
+  bench_fn fn;
+  int batch;      /* ucuz islemler zamanlayici cozunurlugu icin toplu olculur */
+} bench_case_t;
+
+static void b_read_status(bench_ctx_t *b) {
+  if (bq25792_read_status(b->dev, &b->st, true)) b->err++;
+}
+
+static void b_read_vbat_ibat(bench_ctx_t *b) {
+  int v, i;
+  if (bq25792_read_vbat_ibat(b->dev, &v, &i)) b->err++;
+}
+
+/* Hafif tuketici: sadece VBAT+IBAT donusturulur ve okunur */
+static void b_read_adc(bench_ctx_t *b) {
+  bq25792_adc_t a;
+  if (bq25792_read_adc(b->dev, BQ25792_ADC_VBAT | BQ25792_ADC_IBAT, &a)) b->err++;
+}
+
+/* Kontrol yolu: EN_CHG (REG0F[5]) zaten set; cache ile I2C'ye hic gitmemeli */
+static void b_update_bits(bench_ctx_t *b) {
+  if (bq25792_update_bits(b->dev, 0x0F, 1u << 5, 1u << 5)) b->err++;
+}
+
+static volatile int g_sink;
+
+static void b_soc_estimate(bench_ctx_t *b) {
+  g_sink += bq25792_soc_from_vcell_mv(3200 + (int)(b->iter++ % 1100));
+}
+
+static void b_soc_filter(bench_ctx_t *b) {
+  const int raw = 40 + (int)(b->iter++ % 16);
+  bq25792_socfilt_update(&b->filt, raw, (b->iter & 64) ? 1 : -1, (int64_t)b->iter * 1000);
+}
+
+/* Akan istatistik: 3 pencere + enerji entegrasyonu, 10 Hz ornek zamanlariyla */
+static void b_stats_add(bench_ctx_t *b) {
+  const int k = (int)(b->iter++ % 64);
+  bq25792_stats_add(&b->stats, (int64_t)b->iter * 100000000LL, 7400 + k, 1000 - 30 * k, 5000 + k, 2100 - k);
+}
+
+static void b_to_json(bench_ctx_t *b) {
+  if (bq25792_snapshot_to_json(&b->snap, b->json, sizeof(b->json)) <= 0) b->err++;
+}
+
+/* Ikili format: encode + decode (tuketici tarafi dahil) */
+static void b_to_bin(bench_ctx_t *b) {
+  uint8_t bin[BQ25792_SNAPSHOT_BIN_LEN];
+  bq25792_snapshot_t out;
+  if (bq25792_snapshot_to_bin(&b->snap, bin, sizeof(bin)) <= 0) b->err++;
+  if (bq25792_snapshot_from_bin(&out, bin, sizeof(bin)) <= 0) b->err++;
+  g_sink += out.soc_pct;
+}
+
+/* Daemon'un ornek basina yaptigi: durum oku + filtre + JSON */
+static void b_snapshot(bench_ctx_t *b) {
+  if (bq25792_read_status(b->dev, &b->st, true)) {
+    b->err++;
+    return;
+  }
+  b->iter++;
+  bq25792_socfilt_update(&b->filt, b->st.soc_pct_est, bq25792_socfilt_dir(&b->filt, b->st.ibat_ma),
+                         (int64_t)b->iter * 1000);
+  b->snap.st = b->st;
+  b->snap.soc_pct = b->filt.soc_display;
+  b->snap.soc_raw = b->st.soc_pct_est;
+  b->snap.soc_filt = b->filt.soc_filt;
+  if (bq25792_snapshot_to_json(&b->snap, b->json, sizeof(b->json)) <= 0) b->err++;
+}
+
+/* Async yol: submit -> eventfd poll -> reap (worker thread gecisi dahil) */
+static void b_async_status(bench_ctx_t *b) {
+  if (!b->async && bq25792_async_open(&b->async, b->dev)) {
+    b->err++;
+    return;
+  }
+  if (bq25792_async_submit_status(b->async, true, NULL, NULL)) {
+    b->err++;
+    return;
+  }
+  struct pollfd pfd = { .fd = bq25792_async_fd(b->async), .events = POLLIN };
+  bq25792_async_result_t r;
+  for (;;) {
+    if (poll(&pfd, 1, 1000) <= 0) {
+      b->err++;
+      return;
+    }
+    if (bq25792_async_reap(b->async, &r, 1) == 1) break;
+  }
+  if (r.rc) b->err++;
+}
+
+static const bench_case_t cases[] = {
+  { "read_status",    b_read_status,    1 },
+  { "read_vbat_ibat", b_read_vbat_ibat, 1 },
+  { "read_adc",       b_read_adc,       1 },
+  { "update_bits",    b_update_bits,    1 },
+  { "soc_estimate",   b_soc_estimate,   256 },
+  { "soc_filter",     b_soc_filter,     256 },
+  { "stats_add",      b_stats_add,      256 },
+  { "snapshot_json",  b_to_json,        16 },
+  { "snapshot_bin",   b_to_bin,         16 },
+  { "snapshot",       b_snapshot,       1 },
+  { "async_status",   b_async_status,   1 },   /* son: worker dev'i sahiplenir */
+};
+
+typedef struct {
+  long long p50, p99, max, mean;
+  double txn, bytes, allocs;
+  int errors;
+} bench_result_t;
+
+static void run_case(bench_ctx_t *b, const bench_case_t *bc, int iters, int warmup,
+                     long long *lat, bench_result_t *r) {
+  for (int i = 0; i < warmup; i++) for (int k = 0; k < bc->batch; k++) bc->fn(b);
+
+  b->err = 0;
+  const unsigned long long txn0 = b->cnt ? b->cnt->txn : 0;
+  const unsigned long long bytes0 = b->cnt ? b->cnt->bytes : 0;
+  const unsigned long long alloc0 = g_allocs;
+  long long sum = 0;
+
+  for (int i = 0; i < iters; i++) {
+    const long long t0 = mono_ns();
+    for (int k = 0; k < bc->batch; k++) bc->fn(b);
+    lat[i] = (mono_ns() - t0) / bc->batch;
+    sum += lat[i];
+  }
+
+  const double ops = (double)iters * bc->batch;
+  r->txn = b->cnt ? (double)(b->cnt->txn - txn0) / ops : 0;
+  r->bytes = b->cnt ? (double)(b->cnt->bytes - bytes0) / ops : 0;
+  r->allocs = (double)(g_allocs - alloc0) / ops;
+  r->errors = b->err;
+
+  qsort(lat, (size_t)iters, sizeof(lat[0]), cmp_ll);
+  r->p50 = lat[iters / 2];
+  r->p99 = lat[(size_t)((iters - 1) * 0.99)];
+  r->max = lat[iters - 1];
+  r->mean = sum / iters;
+}
+
+static void print_usage(const char *argv0) {
+  fprintf(stderr,
+    "Usage: %s [--bus N] [--addr 0x6b] [--iters N] [--warmup N] [--case NAME] [--capture FILE] [--text]\n"
+    "  Varsayilan: simulator + sayac transport (cipsiz). --bus ile /dev/i2c-N.\n"
+    "  --capture: tum I2C islemleri FILE'a kaydedilirken olc (kayit maliyeti)\n"
+    "  Cikti: JSON (p50/p99/max/mean ns, islem basina txn/byte/alloc)\n",
+    argv0);
+}
+
+int main(int argc, char **argv) {
+  int bus = -1;
+  int addr = 0x6B;
+  int iters = 10000;
+  int warmup = 100;
+  int text = 0;
+  const char *only = NULL;
+  const char *capture = NULL;
+
+  static const struct option long_opts[] = {
+    { "bus",    required_argument, NULL, 'b' },
+    { "addr",   required_argument, NULL, 'a' },
+    { "iters",  required_argument, NULL, 'i' },
+    { "warmup", required_argument, NULL, 'w' },
+    { "case",   required_argument, NULL, 'c' },
+    { "capture", required_argument, NULL, 'C' },
+    { "text",   no_argument,       NULL, 't' },
+    { "help",   no_argument,       NULL, 'h' },
+    { NULL, 0, NULL, 0 }
+  };
+
+  int c;
+  while ((c = getopt_long(argc, argv, "b:a:i:w:c:th", long_opts, NULL)) != -1) {
+    switch (c) {
+      case 'b': bus = (int)strtol(optarg, NULL, 0); break;
+      case 'a': addr = (int)strtol(optarg, NULL, 0); break;
+      case 'i': iters = (int)strtol(optarg, NULL, 0); break;
+      case 'w': warmup = (int)strtol(optarg, NULL, 0); break;
+      case 'c': only = optarg; break;
+      case 'C': capture = optarg; break;
+      case 't': text = 1; break;
+      case 'h':
+      default:
+        print_usage(argv[0]);
+        return 2;
+    }
+  }
+  if (iters < 1) iters = 1;
+  if (warmup < 1) warmup = 1; /* ilk read_status ADC acma/beklemeyi olcume katmasin */
+
+  bq25792_dev_t *inner = NULL;
+  int rc;
+  if (bus >= 0) {
+    rc = bq25792_open_i2c(&inner, bus, (uint8_t)addr);
+  } else {
+    bq25792_sim_config_t scfg;
+    bq25792_sim_config_default(&scfg);
+    scfg.speed = 1000.0f; /* ADC conversion beklemesi warmup'i uzatmasin */
+    rc = bq25792_open_sim(&inner, &scfg, NULL);
+  }
+  if (rc) {
+    fprintf(stderr, "bq25792_bench: open failed: %s\n", strerror(-rc));
+    return 1;
+  }
+
+  if (capture && (rc = bq25792_capture_wrap(&inner, capture, 0)) != 0) {
+    fprintf(stderr, "bq25792_bench: capture failed: %s\n", strerror(-rc));
+    bq25792_close(inner);
+    return 1;
+  }
+
+  static count_ctx_t cnt;
+  cnt.inner = inner;
+  cnt.ops = bq25792_transport_ops(inner);
+  cnt.ctx = bq25792_transport_ctx(inner);
+
+  static bench_ctx_t b;
+  b.cnt = &cnt;
+  rc = bq25792_open_transport(&b.dev, &count_ops, &cnt, bus, (uint8_t)addr);
+  if (rc) {
+    fprintf(stderr, "bq25792_bench: open failed: %s\n", strerror(-rc));
+    bq25792_close(inner);
+    return 1;
+  }
+
+  /* JSON/filtre vakalari icin gercekci bir snapshot */
+  (void)bq25792_read_status(b.dev, &b.st, true);
+  bq25792_socfilt_init(&b.filt, NULL, b.st.soc_pct_est, 0);
+  bq25792_stats_init(&b.stats, NULL);
+  b.snap.st = b.st;
+  b.snap.bus = bus;
+  b.snap.addr = (uint8_t)addr;
+  b.snap.soc_cc_pct = -1.0f;
+
+  long long *lat = (long long*)malloc(sizeof(long long) * (size_t)iters);
+  if (!lat) {
+    bq25792_close(b.dev);
+    return 1;
+  }
+
+  const char *transport = (bus >= 0) ? (capture ? "i2c+capture" : "i2c") : (capture ? "sim+capture" : "sim");
+  if (text) {
+    printf("transport=%s iters=%d\n", transport, iters);
+    printf("%-16s %10s %10s %10s %10s %8s %8s %8s\n",
+           "case", "p50_ns", "p99_ns", "max_ns", "mean_ns", "txn", "bytes", "allocs");
+  } else {
+    printf("{\"bench\":\"bq25792\",\"transport\":\"%s\",\"iters\":%d,\"alloc_counting\":%s,\"results\":[",
+           transport, iters, ALLOC_COUNTING ? "true" : "false");
+  }
+
+  int first = 1;
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    const bench_case_t *bc = &cases[i];
+    if (only && strcmp(only, bc->name) != 0) continue;
+
+    bench_result_t r;
+    run_case(&b, bc, iters, warmup, lat, &r);
+
+    if (text) {
+      printf("%-16s %10lld %10lld %10lld %10lld %8.2f %8.2f %8.2f\n",
+             bc->name, r.p50, r.p99, r.max, r.mean, r.txn, r.bytes, r.allocs);
+    } else {
+      printf("%s{\"case\":\"%s\",\"p50_ns\":%lld,\"p99_ns\":%lld,\"max_ns\":%lld,\"mean_ns\":%lld,"
+             "\"txn_per_op\":%.2f,\"bytes_per_op\":%.2f,\"allocs_per_op\":%.2f,\"errors\":%d}",
+             first ? "" : ",", bc->name, r.p50, r.p99, r.max, r.mean,
+             r.txn, r.bytes, r.allocs, r.errors);
+    }
+    first = 0;
+  }
+  if (!text) printf("]}\n");
+
+  free(lat);
+  bq25792_async_close(b.async);
+  bq25792_close(b.dev);
+  return 0;
+}
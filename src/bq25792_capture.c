@@ -0,0 +1,660 @@
+#include "bq25792_capture.h"
+#include "bq25792_transport.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TAG_OP_MASK   0x03u
+#define TAG_ERR       0x04u
+#define TAG_CHUNK     0x0Bu
+#define VARINT_MAX    10
+#define CHUNK_MAX     (1u << 20)   /* okuyucu icin akil siniri */
+
+/* tag + dt + reg + len + deger + rc + veri */
+#define REC_MAX(len)  (1 + VARINT_MAX + 1 + VARINT_MAX + 1 + VARINT_MAX + (len))
+
+static int64_t mono_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+static int64_t wall_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (int64_t)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+static size_t put_varint(uint8_t *p, uint64_t v) {
+  size_t n = 0;
+  while (v >= 0x80) {
+    p[n++] = (uint8_t)(v | 0x80);
+    v >>= 7;
+  }
+  p[n++] = (uint8_t)v;
+  return n;
+}
+
+/* Donus: tuketilen byte, bozuk/eksikse 0 */
+static size_t get_varint(const uint8_t *p, const uint8_t *end, uint64_t *v) {
+  uint64_t x = 0;
+  for (size_t n = 0; n < VARINT_MAX && p + n < end; n++) {
+    x |= (uint64_t)(p[n] & 0x7F) << (7 * n);
+    if (!(p[n] & 0x80)) {
+      *v = x;
+      return n + 1;
+    }
+  }
+  return 0;
+}
+
+static uint64_t zigzag(int64_t v) { return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+static int64_t unzigzag(uint64_t v) { return (int64_t)(v >> 1) ^ -(int64_t)(v & 1); }
+
+const char* bq25792_cap_op_str(uint8_t op) {
+  switch (op) {
+    case BQ25792_CAP_READ_U8:    return "read_u8";
+    case BQ25792_CAP_WRITE_U8:   return "write_u8";
+    case BQ25792_CAP_READ_BLOCK: return "read_block";
+    case BQ25792_CAP_SESSION:    return "session";
+    default:                     return "unknown";
+  }
+}
+
+/* ---- capture ---- */
+
+typedef struct {
+  bq25792_dev_t *inner;
+  const bq25792_transport_ops_t *ops;
+  void *ctx;
+  int fd;
+  uint64_t sid;
+  int64_t flush_us;
+  int64_t last_flush_us;
+  int64_t base_us;           /* tampondaki chunk'in baz zamani */
+  int64_t last_us;
+  size_t n;
+  uint8_t buf[BQ25792_CAPTURE_BUF_SIZE];
+  bq25792_capture_stats_t stats;
+} cap_ctx_t;
+
+static void cap_flush(cap_ctx_t *c) {
+  if (c->n == 0) return;
+  uint8_t hdr[1 + 3 * VARINT_MAX];
+  size_t h = 0;
+  hdr[h++] = TAG_CHUNK;
+  h += put_varint(&hdr[h], c->n);
+  h += put_varint(&hdr[h], c->sid);
+  h += put_varint(&hdr[h], (uint64_t)c->base_us);
+  struct iovec iov[2] = {
+    { .iov_base = hdr, .iov_len = h },
+    { .iov_base = c->buf, .iov_len = c->n },
+  };
+  /* O_APPEND + tek writev: baska yazanlarin chunk'lari araya girmez */
+  const ssize_t w = writev(c->fd, iov, 2);
+  if (w == (ssize_t)(h + c->n)) {
+    c->stats.bytes += (uint64_t)w;
+    c->stats.flushes++;
+  } else {
+    c->stats.write_errors++;
+  }
+  c->n = 0;
+  c->last_flush_us = mono_us();
+}
+
+/* Kayit tampona eklenir; data: okunan (rc == 0) ya da yazilan deger */
+static void cap_record(cap_ctx_t *c, uint8_t op, uint8_t reg, const uint8_t *data, size_t len,
+                       int rc, int64_t t) {
+  if (c->n + REC_MAX(len) > sizeof(c->buf)) cap_flush(c);
+  if (c->n == 0) c->base_us = c->last_us = t;
+
+  uint8_t *p = &c->buf[c->n];
+  *p++ = (uint8_t)(op | (rc ? TAG_ERR : 0));
+  p += put_varint(p, (uint64_t)(t > c->last_us ? t - c->last_us : 0));
+  *p++ = reg;
+  if (op == BQ25792_CAP_READ_BLOCK) p += put_varint(p, len);
+  if (op == BQ25792_CAP_WRITE_U8) *p++ = data[0];
+  if (rc) {
+    p += put_varint(p, (uint64_t)-(int64_t)rc);
+  } else if (op != BQ25792_CAP_WRITE_U8) {
+    memcpy(p, data, len);
+    p += len;
+  }
+  c->n = (size_t)(p - c->buf);
+  c->last_us = t;
+  c->stats.records++;
+
+  if (t - c->last_flush_us >= c->flush_us) cap_flush(c);
+}
+
+static void cap_session(cap_ctx_t *c, int bus, uint8_t addr, const char *name) {
+  const size_t nl = name ? strnlen(name, 15) : 0;
+  const int64_t t = mono_us();
+  c->base_us = c->last_us = t;
+
+  uint8_t *p = &c->buf[c->n];
+  *p++ = BQ25792_CAP_SESSION;
+  p += put_varint(p, 0);
+  p += put_varint(p, zigzag(bus));
+  *p++ = addr;
+  p += put_varint(p, (uint64_t)wall_us());
+  p += put_varint(p, nl);
+  memcpy(p, name, nl);
+  p += nl;
+  c->n = (size_t)(p - c->buf);
+}
+
+static int cap_read_u8(void *ctx, uint8_t reg, uint8_t *val) {
+  cap_ctx_t *c = (cap_ctx_t*)ctx;
+  const int64_t t = mono_us();
+  const int rc = c->ops->read_u8(c->ctx, reg, val);
+  cap_record(c, BQ25792_CAP_READ_U8, reg, val, 1, rc, t);
+  return rc;
+}
+
+static int cap_write_u8(void *ctx, uint8_t reg, uint8_t val) {
+  cap_ctx_t *c = (cap_ctx_t*)ctx;
+  const int64_t t = mono_us();
+  const int rc = c->ops->write_u8(c->ctx, reg, val);
+  cap_record(c, BQ25792_CAP_WRITE_U8, reg, &val, 1, rc, t);
+  return rc;
+}
+
+static int cap_read_block(void *ctx, uint8_t reg, uint8_t *buf, size_t len) {
+  cap_ctx_t *c = (cap_ctx_t*)ctx;
+  const int64_t t = mono_us();
+  const int rc = c->ops->read_block(c->ctx, reg, buf, len);
+  cap_record(c, BQ25792_CAP_READ_BLOCK, reg, buf, len, rc, t);
+  return rc;
+}
+
+static void cap_close(void *ctx) {
+  cap_ctx_t *c = (cap_ctx_t*)ctx;
+  cap_flush(c);
+  close(c->fd);
+  bq25792_close(c->inner);
+  free(c);
+}
+
+static const bq25792_transport_ops_t capture_ops = {
+  .name = "capture",
+  .read_u8 = cap_read_u8,
+  .write_u8 = cap_write_u8,
+  .read_block = cap_read_block,
+  .close = cap_close,
+};
+
+int bq25792_capture_wrap(bq25792_dev_t **dev, const char *path, int flush_ms) {
+  if (!dev || !*dev || !path || !*path) return -EINVAL;
+  static _Atomic unsigned seq;
+
+  cap_ctx_t *c = (cap_ctx_t*)calloc(1, sizeof(*c));
+  if (!c) return -ENOMEM;
+  c->inner = *dev;
+  c->ops = bq25792_transport_ops(c->inner);
+  c->ctx = bq25792_transport_ctx(c->inner);
+  c->flush_us = (int64_t)(flush_ms > 0 ? flush_ms : BQ25792_CAPTURE_FLUSH_MS_DEFAULT) * 1000;
+  c->last_flush_us = mono_us();
+  /* Dosya icinde tekil: saniye | pid | surec ici sira */
+  c->sid = ((uint64_t)(wall_us() / 1000000) << 24) | ((uint64_t)(getpid() & 0xFFFF) << 8) |
+           (atomic_fetch_add(&seq, 1) & 0xFF);
+
+  c->fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+  if (c->fd < 0) {
+    const int rc = -errno;
+    free(c);
+    return rc;
+  }
+  struct stat sb;
+  if (fstat(c->fd, &sb) == 0 && sb.st_size == 0 &&
+      write(c->fd, BQ25792_CAPTURE_MAGIC, BQ25792_CAPTURE_MAGIC_LEN) != BQ25792_CAPTURE_MAGIC_LEN) {
+    const int rc = -errno;
+    close(c->fd);
+    free(c);
+    return rc ? rc : -EIO;
+  }
+
+  int bus = -1;
+  uint8_t addr = 0;
+  bq25792_bus_addr(c->inner, &bus, &addr);
+  cap_session(c, bus, addr, c->ops->name);
+
+  bq25792_dev_t *nd = NULL;
+  const int rc = bq25792_open_transport(&nd, &capture_ops, c, bus, addr);
+  if (rc) {
+    close(c->fd);
+    free(c);
+    return rc;
+  }
+  *dev = nd;
+  return 0;
+}
+
+static cap_ctx_t* cap_of(const bq25792_dev_t *dev) {
+  return bq25792_transport_ops(dev) == &capture_ops ? (cap_ctx_t*)bq25792_transport_ctx(dev) : NULL;
+}
+
+int bq25792_capture_flush(bq25792_dev_t *dev) {
+  cap_ctx_t *c = cap_of(dev);
+  if (!c) return -EINVAL;
+  const uint64_t errs = c->stats.write_errors;
+  cap_flush(c);
+  return c->stats.write_errors == errs ? 0 : -EIO;
+}
+
+int bq25792_capture_get_stats(const bq25792_dev_t *dev, bq25792_capture_stats_t *out) {
+  const cap_ctx_t *c = cap_of(dev);
+  if (!c || !out) return -EINVAL;
+  *out = c->stats;
+  return 0;
+}
+
+/* ---- okuyucu ---- */
+
+struct bq25792_caplog {
+  FILE *f;
+  uint8_t *body;
+  size_t cap;
+  size_t len;
+  size_t pos;
+  uint64_t sid;
+  int64_t t_us;
+};
+
+int bq25792_caplog_open(bq25792_caplog_t **out, const char *path) {
+  if (!out || !path) return -EINVAL;
+  *out = NULL;
+  bq25792_caplog_t *l = (bq25792_caplog_t*)calloc(1, sizeof(*l));
+  if (!l) return -ENOMEM;
+  l->f = fopen(path, "rbe");
+  if (!l->f) {
+    const int rc = -errno;
+    free(l);
+    return rc;
+  }
+  char magic[BQ25792_CAPTURE_MAGIC_LEN];
+  if (fread(magic, 1, sizeof(magic), l->f) != sizeof(magic) ||
+      memcmp(magic, BQ25792_CAPTURE_MAGIC, sizeof(magic)) != 0) {
+    fclose(l->f);
+    free(l);
+    return -EBADMSG;
+  }
+  *out = l;
+  return 0;
+}
+
+void bq25792_caplog_close(bq25792_caplog_t *l) {
+  if (!l) return;
+  fclose(l->f);
+  free(l->body);
+  free(l);
+}
+
+/* Donus: 1 varint, 0 dosya sonu */
+static int file_varint(FILE *f, uint64_t *v) {
+  uint64_t x = 0;
+  for (int n = 0; n < VARINT_MAX; n++) {
+    const int ch = getc(f);
+    if (ch == EOF) return 0;
+    x |= (uint64_t)(ch & 0x7F) << (7 * n);
+    if (!(ch & 0x80)) {
+      *v = x;
+      return 1;
+    }
+  }
+  return -EBADMSG;
+}
+
+/* Sonraki chunk'i body'ye yukle. 1, 0 = dosya sonu, <0 bozuk */
+static int next_chunk(bq25792_caplog_t *l) {
+  for (;;) {
+    const int tag = getc(l->f);
+    if (tag == EOF) return 0;
+    if (tag == BQ25792_CAPTURE_MAGIC[0]) {
+      /* dosyayi ayni anda olusturan iki yazici: ikinci magic */
+      char rest[BQ25792_CAPTURE_MAGIC_LEN - 1];
+      if (fread(rest, 1, sizeof(rest), l->f) != sizeof(rest)) return 0;
+      if (memcmp(rest, BQ25792_CAPTURE_MAGIC + 1, sizeof(rest)) != 0) return -EBADMSG;
+      continue;
+    }
+    if (tag != TAG_CHUNK) return -EBADMSG;
+
+    uint64_t blen, sid, base;
+    int rc;
+    if ((rc = file_varint(l->f, &blen)) <= 0) return rc;
+    if ((rc = file_varint(l->f, &sid)) <= 0) return rc;
+    if ((rc = file_varint(l->f, &base)) <= 0) return rc;
+    if (blen == 0 || blen > CHUNK_MAX) return -EBADMSG;
+    if (blen > l->cap) {
+      uint8_t *nb = (uint8_t*)realloc(l->body, blen);
+      if (!nb) return -ENOMEM;
+      l->body = nb;
+      l->cap = blen;
+    }
+    if (fread(l->body, 1, blen, l->f) != blen) return 0; /* yarim kalmis son chunk */
+    l->len = blen;
+    l->pos = 0;
+    l->sid = sid;
+    l->t_us = (int64_t)base;
+    return 1;
+  }
+}
+
+int bq25792_caplog_next(bq25792_caplog_t *l, bq25792_cap_record_t *r) {
+  if (!l || !r) return -EINVAL;
+  if (l->pos >= l->len) {
+    const int rc = next_chunk(l);
+    if (rc <= 0) return rc;
+  }
+
+  const uint8_t *p = &l->body[l->pos];
+  const uint8_t *end = &l->body[l->len];
+  uint64_t v;
+  size_t k;
+
+  memset(r, 0, sizeof(*r));
+  const uint8_t tag = *p++;
+  if (tag & ~(TAG_OP_MASK | TAG_ERR)) return -EBADMSG;
+  r->op = tag & TAG_OP_MASK;
+  r->sid = l->sid;
+  if (!(k = get_varint(p, end, &v))) return -EBADMSG;
+  p += k;
+  l->t_us += (int64_t)v;
+  r->mono_us = l->t_us;
+  r->len = 1;
+
+  if (r->op == BQ25792_CAP_SESSION) {
+    if (!(k = get_varint(p, end, &v))) return -EBADMSG;
+    p += k;
+    r->bus = (int)unzigzag(v);
+    if (p >= end) return -EBADMSG;
+    r->addr = *p++;
+    if (!(k = get_varint(p, end, &v))) return -EBADMSG;
+    p += k;
+    r->wall_us = (int64_t)v;
+    if (!(k = get_varint(p, end, &v)) || v >= sizeof(r->transport) || p + k + v > end) return -EBADMSG;
+    p += k;
+    memcpy(r->transport, p, v);
+    r->transport[v] = '\0';
+    p += v;
+    r->len = 0;
+    l->pos = (size_t)(p - l->body);
+    return 1;
+  }
+
+  if (p >= end) return -EBADMSG;
+  r->reg = *p++;
+  if (r->op == BQ25792_CAP_READ_BLOCK) {
+    if (!(k = get_varint(p, end, &v)) || v == 0 || r->reg + v > 0x100) return -EBADMSG;
+    p += k;
+    r->len = (uint16_t)v;
+  }
+  if (r->op == BQ25792_CAP_WRITE_U8) {
+    if (p >= end) return -EBADMSG;
+    r->data[0] = *p++;
+  }
+  if (tag & TAG_ERR) {
+    if (!(k = get_varint(p, end, &v)) || v == 0 || v > 4095) return -EBADMSG;
+    p += k;
+    r->rc = -(int)v;
+  } else if (r->op != BQ25792_CAP_WRITE_U8) {
+    if (p + r->len > end) return -EBADMSG;
+    memcpy(r->data, p, r->len);
+    p += r->len;
+  }
+  l->pos = (size_t)(p - l->body);
+  return 1;
+}
+
+/* ---- replay ---- */
+
+typedef struct {
+  uint8_t op;
+  uint8_t reg;
+  uint16_t len;
+  int rc;
+  int64_t t_us;              /* oturum basindan */
+  uint32_t off;              /* data icinde */
+} rp_rec_t;
+
+typedef struct {
+  rp_rec_t *rec;
+  size_t n;
+  size_t pos;
+  uint8_t *data;
+  size_t data_len;
+  bq25792_capreplay_config_t cfg;
+  int64_t t0_us;             /* replay'in basladigi an (pace) */
+  uint8_t shadow[256];
+  uint8_t known[256];
+  bq25792_capreplay_stats_t stats;
+} rp_ctx_t;
+
+void bq25792_capreplay_config_default(bq25792_capreplay_config_t *c) {
+  memset(c, 0, sizeof(*c));
+  c->session = 0;
+  c->window = 64;
+  c->pace = false;
+}
+
+static int env_i(const char *name, int defv) {
+  const char *v = getenv(name);
+  return (v && *v) ? (int)strtol(v, NULL, 0) : defv;
+}
+
+void bq25792_capreplay_config_from_env(bq25792_capreplay_config_t *c) {
+  bq25792_capreplay_config_default(c);
+  c->session = env_i("BQ_REPLAY_SESSION", c->session);
+  c->window = env_i("BQ_REPLAY_WINDOW", c->window);
+  c->pace = env_i("BQ_REPLAY_PACE", c->pace) != 0;
+}
+
+static void rp_apply(rp_ctx_t *r, const rp_rec_t *x) {
+  if (x->rc || x->op == BQ25792_CAP_SESSION) return;
+  memcpy(&r->shadow[x->reg], &r->data[x->off], x->len);
+  memset(&r->known[x->reg], 1, x->len);
+}
+
+static int rp_take(rp_ctx_t *r, uint8_t op, uint8_t reg, uint8_t *buf, size_t len) {
+  if (r->pos >= r->n) return -ENODATA;
+
+  size_t i = r->pos;
+  const size_t lim = r->pos + (size_t)(r->cfg.window > 0 ? r->cfg.window : 1);
+  for (; i < r->n && i < lim; i++) {
+    const rp_rec_t *x = &r->rec[i];
+    if (x->op == op && x->reg == reg && x->len == len) break;
+  }
+  if (i >= r->n || i >= lim) {
+    if (op == BQ25792_CAP_WRITE_U8) {
+      r->stats.mismatched++;
+      r->shadow[reg] = buf[0];
+      r->known[reg] = 1;
+      return 0;
+    }
+    for (size_t k = 0; k < len; k++) {
+      if (!r->known[reg + k]) {
+        r->stats.mismatched++;
+        return -EIO;
+      }
+    }
+    memcpy(buf, &r->shadow[reg], len);
+    r->stats.shadow++;
+    return 0;
+  }
+
+  for (size_t k = r->pos; k < i; k++) rp_apply(r, &r->rec[k]);
+  r->stats.skipped += i - r->pos;
+  r->pos = i + 1;
+  r->stats.matched++;
+
+  const rp_rec_t *x = &r->rec[i];
+  if (r->cfg.pace) {
+    const int64_t wait = r->t0_us + x->t_us - mono_us();
+    if (wait > 0) {
+      struct timespec ts = { (time_t)(wait / 1000000), (long)(wait % 1000000) * 1000 };
+      nanosleep(&ts, NULL);
+    }
+  }
+  if (op == BQ25792_CAP_WRITE_U8) {
+    if (x->rc == 0 && r->data[x->off] != buf[0]) r->stats.mismatched++;
+    r->shadow[reg] = buf[0];
+    r->known[reg] = 1;
+    return x->rc;
+  }
+  rp_apply(r, x);
+  if (x->rc == 0) memcpy(buf, &r->data[x->off], len);
+  return x->rc;
+}
+
+static int rp_read_u8(void *ctx, uint8_t reg, uint8_t *val) {
+  return rp_take((rp_ctx_t*)ctx, BQ25792_CAP_READ_U8, reg, val, 1);
+}
+
+static int rp_write_u8(void *ctx, uint8_t reg, uint8_t val) {
+  return rp_take((rp_ctx_t*)ctx, BQ25792_CAP_WRITE_U8, reg, &val, 1);
+}
+
+static int rp_read_block(void *ctx, uint8_t reg, uint8_t *buf, size_t len) {
+  if (len == 0 || (size_t)reg + len > 0x100) return -EINVAL;
+  return rp_take((rp_ctx_t*)ctx, BQ25792_CAP_READ_BLOCK, reg, buf, len);
+}
+
+static void rp_free(rp_ctx_t *r) {
+  free(r->rec);
+  free(r->data);
+  free(r);
+}
+
+static void rp_close(void *ctx) {
+  rp_free((rp_ctx_t*)ctx);
+}
+
+static const bq25792_transport_ops_t replay_ops = {
+  .name = "replay",
+  .read_u8 = rp_read_u8,
+  .write_u8 = rp_write_u8,
+  .read_block = rp_read_block,
+  .close = rp_close,
+};
+
+typedef struct {
+  uint64_t sid;
+  int bus;
+  uint8_t addr;
+  int64_t start_us;
+} rp_session_t;
+
+/* Ilk gecis: oturum listesi, bus'i eslesenler tercih edilir */
+static int pick_session(const char *path, int bus, int index, rp_session_t *out) {
+  bq25792_caplog_t *l = NULL;
+  int rc = bq25792_caplog_open(&l, path);
+  if (rc) return rc;
+
+  rp_session_t *all = NULL;
+  size_t n = 0, cap = 0, nmatch = 0;
+  bq25792_cap_record_t rec;
+  while ((rc = bq25792_caplog_next(l, &rec)) > 0) {
+    if (rec.op != BQ25792_CAP_SESSION) continue;
+    if (n == cap) {
+      cap = cap ? cap * 2 : 16;
+      rp_session_t *na = (rp_session_t*)realloc(all, cap * sizeof(*all));
+      if (!na) { rc = -ENOMEM; break; }
+      all = na;
+    }
+    all[n++] = (rp_session_t){ rec.sid, rec.bus, rec.addr, rec.mono_us };
+    if (rec.bus == bus) nmatch++;
+  }
+  bq25792_caplog_close(l);
+
+  if (rc == 0) {
+    const int by_bus = nmatch > 0;
+    const size_t cnt = by_bus ? nmatch : n;
+    const long want = index < 0 ? (long)cnt + index : index;
+    rc = -ENOENT;
+    if (want >= 0 && (size_t)want < cnt) {
+      long k = 0;
+      for (size_t i = 0; i < n; i++) {
+        if (by_bus && all[i].bus != bus) continue;
+        if (k++ == want) {
+          *out = all[i];
+          rc = 0;
+          break;
+        }
+      }
+    }
+  }
+  free(all);
+  return rc;
+}
+
+/* Ikinci gecis: secilen oturumun islemleri */
+static int load_session(rp_ctx_t *r, const char *path, const rp_session_t *s) {
+  bq25792_caplog_t *l = NULL;
+  int rc = bq25792_caplog_open(&l, path);
+  if (rc) return rc;
+
+  size_t cap = 0, dcap = 0;
+  bq25792_cap_record_t rec;
+  while ((rc = bq25792_caplog_next(l, &rec)) > 0) {
+    if (rec.sid != s->sid || rec.op == BQ25792_CAP_SESSION) continue;
+    if (r->n == cap) {
+      cap = cap ? cap * 2 : 256;
+      rp_rec_t *na = (rp_rec_t*)realloc(r->rec, cap * sizeof(*r->rec));
+      if (!na) { rc = -ENOMEM; break; }
+      r->rec = na;
+    }
+    if (r->data_len + rec.len > dcap) {
+      dcap = dcap ? dcap * 2 : 4096;
+      uint8_t *nd = (uint8_t*)realloc(r->data, dcap);
+      if (!nd) { rc = -ENOMEM; break; }
+      r->data = nd;
+    }
+    r->rec[r->n++] = (rp_rec_t){ rec.op, rec.reg, rec.len, rec.rc, rec.mono_us - s->start_us,
+                                 (uint32_t)r->data_len };
+    memcpy(&r->data[r->data_len], rec.data, rec.len);
+    r->data_len += rec.len;
+  }
+  bq25792_caplog_close(l);
+  return rc;
+}
+
+int bq25792_open_capreplay(bq25792_dev_t **out, const char *path, int bus,
+                           const bq25792_capreplay_config_t *cfg) {
+  if (!out || !path || !*path) return -EINVAL;
+  *out = NULL;
+
+  rp_session_t s;
+  bq25792_capreplay_config_t c;
+  if (cfg) c = *cfg; else bq25792_capreplay_config_default(&c);
+  int rc = pick_session(path, bus, c.session, &s);
+  if (rc) return rc;
+
+  rp_ctx_t *r = (rp_ctx_t*)calloc(1, sizeof(*r));
+  if (!r) return -ENOMEM;
+  r->cfg = c;
+  rc = load_session(r, path, &s);
+  if (rc) {
+    rp_free(r);
+    return rc;
+  }
+  r->stats.total = r->n;
+  r->t0_us = mono_us();
+
+  rc = bq25792_open_transport(out, &replay_ops, r, s.bus, s.addr);
+  if (rc) rp_free(r);
+  return rc;
+}
+
+int bq25792_capreplay_get_stats(const bq25792_dev_t *dev, bq25792_capreplay_stats_t *out) {
+  if (!out || bq25792_transport_ops(dev) != &replay_ops) return -EINVAL;
+  *out = ((const rp_ctx_t*)bq25792_transport_ctx(dev))->stats;
+  return 0;
+}
@@ -0,0 +1,95 @@
+#include "bq25792_events.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+const char* bq25792_event_kind_str(uint8_t kind) {
+  switch (kind) {
+    case BQ25792_EV_FLAG:   return "flag";
+    case BQ25792_EV_RISE:   return "rise";
+    case BQ25792_EV_FALL:   return "fall";
+    case BQ25792_EV_CHANGE: return "change";
+    default:                return "unknown";
+  }
+}
+
+/* Surekli modda her donusumde set olur; olay degil */
+static int ignored(int id) {
+  return id == BQ25792_F_ADC_DONE_STAT || id == BQ25792_F_ADC_DONE_FLAG;
+}
+
+int bq25792_events_detect(const uint8_t *prev, const uint8_t *cur, bq25792_event_t *out, int max) {
+  if (!cur || (!out && max > 0)) return -EINVAL;
+  int n = 0;
+
+  for (int id = 0; id < BQ25792_F_COUNT; id++) {
+    const bq25792_field_desc_t *f = &bq25792_field_table[id];
+    if (f->reg < BQ25792_EVENT_WIN_FIRST || f->reg > BQ25792_EVENT_WIN_LAST || ignored(id)) continue;
+
+    const int32_t v = bq25792_field_raw(cur, (bq25792_field_id_t)id);
+    int32_t pv = 0;
+    uint8_t kind;
+    if (f->flags & BQ25792_FF_RC) {
+      if (!v) continue;
+      kind = BQ25792_EV_FLAG;
+    } else {
+      if (!prev) continue;
+      pv = bq25792_field_raw(prev, (bq25792_field_id_t)id);
+      if (v == pv) continue;
+      kind = (f->bits > 1) ? BQ25792_EV_CHANGE : (v ? BQ25792_EV_RISE : BQ25792_EV_FALL);
+    }
+
+    if (n < max) {
+      bq25792_event_t *e = &out[n];
+      memset(e, 0, sizeof(*e));
+      e->kind = kind;
+      e->field = (uint16_t)id;
+      e->value = v;
+      e->prev = pv;
+    }
+    n++;
+  }
+  return n;
+}
+
+int bq25792_event_to_json(const bq25792_event_t *ev, char *buf, size_t len) {
+  if (!ev || !buf || ev->field >= BQ25792_F_COUNT) return -EINVAL;
+  const bq25792_field_desc_t *f = &bq25792_field_table[ev->field];
+  int n = snprintf(buf, len,
+    "{\"seq\":%llu,\"t_ns\":%lld,\"ts_ms\":%lld,\"bus\":%d,\"addr\":\"0x%02x\","
+    "\"event\":\"%s\",\"reg\":\"0x%02x\",\"kind\":\"%s\",\"value\":%d,\"prev\":%d}\n",
+    (unsigned long long)ev->seq, (long long)ev->t_ns, (long long)ev->ts_ms,
+    (int)ev->bus, ev->addr, f->name, f->reg, bq25792_event_kind_str(ev->kind),
+    (int)ev->value, (int)ev->prev);
+  if (n < 0) return -EIO;
+  if ((size_t)n >= len) return -ENOSPC;
+  return n;
+}
+
+void bq25792_journal_init(bq25792_journal_t *j) {
+  if (!j) return;
+  memset(j, 0, sizeof(*j));
+  j->next_seq = 1;
+}
+
+uint64_t bq25792_journal_append(bq25792_journal_t *j, bq25792_event_t *ev) {
+  ev->seq = j->next_seq++;
+  j->ev[ev->seq & (BQ25792_JOURNAL_CAP - 1)] = *ev;
+  return ev->seq;
+}
+
+uint64_t bq25792_journal_last_seq(const bq25792_journal_t *j) {
+  return j->next_seq - 1;
+}
+
+int bq25792_journal_read(const bq25792_journal_t *j, uint64_t after_seq, bq25792_event_t *out, int max) {
+  if (!j || (!out && max > 0)) return -EINVAL;
+  const uint64_t last = j->next_seq - 1;
+  const uint64_t oldest = (last >= BQ25792_JOURNAL_CAP) ? last - BQ25792_JOURNAL_CAP + 1 : 1;
+  uint64_t s = after_seq + 1;
+  if (s < oldest) s = oldest;
+  int n = 0;
+  for (; s <= last && n < max; s++) out[n++] = j->ev[s & (BQ25792_JOURNAL_CAP - 1)];
+  return n;
+}
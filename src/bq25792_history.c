@@ -0,0 +1,373 @@
+#include "bq25792_history.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define HIST_MAGIC    0x53484251u /* "QBHS" */
+#define HIST_VERSION  1
+#define HEADER_SIZE   4096u
+
+/* Ring kapasiteleri (kayit). 10 sn ornekle RAW ~11 gun; 1M 31 gun; 1H 2 yil; 1D 10 yil.
+   Toplam ~9 MiB. */
+static const uint32_t tier_capacity[BQ25792_HIST_NTIERS] = { 100000, 44640, 17568, 3660 };
+static const int64_t  tier_res_ms[BQ25792_HIST_NTIERS]   = { 0, 60000LL, 3600000LL, 86400000LL };
+
+/* Henuz kapanmamis aggregate bucket */
+typedef struct {
+  int64_t  bucket_ms;
+  uint32_t count;
+  uint32_t fault_count;
+  int64_t  sum[BQ25792_HIST_NFIELDS];
+  int32_t  min[BQ25792_HIST_NFIELDS];
+  int32_t  max[BQ25792_HIST_NFIELDS];
+} hist_accum_t;
+
+typedef struct {
+  uint32_t rec_size;
+  uint32_t capacity;
+  uint64_t offset;              /* dosya basindan */
+  _Atomic uint64_t head;        /* toplam yazilan kayit sayisi */
+} hist_tier_t;
+
+/* Dosya header'i (HEADER_SIZE icinde). Layout degisirse HIST_VERSION artar. */
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t file_size;
+  int64_t  last_ts_ms;
+  hist_tier_t tier[BQ25792_HIST_NTIERS];
+  hist_accum_t acc[BQ25792_HIST_NTIERS]; /* acc[RAW] kullanilmaz */
+} hist_header_t;
+
+_Static_assert(sizeof(hist_header_t) <= HEADER_SIZE, "history header too large");
+_Static_assert(sizeof(bq25792_hist_sample_t) == 24, "sample layout");
+_Static_assert(sizeof(bq25792_hist_agg_t) == 104, "agg layout");
+
+struct bq25792_history {
+  uint8_t *map;
+  size_t size;
+  int writable;
+};
+
+static hist_header_t* hdr(bq25792_history_t *h) { return (hist_header_t*)h->map; }
+
+static size_t tier_rec_size(int t) {
+  return (t == BQ25792_HIST_RAW) ? sizeof(bq25792_hist_sample_t) : sizeof(bq25792_hist_agg_t);
+}
+
+static size_t layout_size(void) {
+  size_t sz = HEADER_SIZE;
+  for (int t = 0; t < BQ25792_HIST_NTIERS; t++) sz += tier_rec_size(t) * tier_capacity[t];
+  return sz;
+}
+
+static void init_header(hist_header_t *H, size_t size) {
+  memset(H, 0, sizeof(*H));
+  H->version = HIST_VERSION;
+  H->file_size = size;
+  H->last_ts_ms = INT64_MIN;
+  uint64_t off = HEADER_SIZE;
+  for (int t = 0; t < BQ25792_HIST_NTIERS; t++) {
+    H->tier[t].rec_size = (uint32_t)tier_rec_size(t);
+    H->tier[t].capacity = tier_capacity[t];
+    H->tier[t].offset = off;
+    atomic_store(&H->tier[t].head, 0);
+    off += (uint64_t)H->tier[t].rec_size * tier_capacity[t];
+  }
+  /* magic en son: yarim kalmis init gecersiz sayilir */
+  atomic_thread_fence(memory_order_release);
+  H->magic = HIST_MAGIC;
+}
+
+static int header_valid(const hist_header_t *H, size_t size) {
+  if (H->magic != HIST_MAGIC || H->version != HIST_VERSION || H->file_size != size) return 0;
+  for (int t = 0; t < BQ25792_HIST_NTIERS; t++) {
+    if (H->tier[t].rec_size != tier_rec_size(t)) return 0;
+    if (H->tier[t].capacity == 0) return 0;
+    if (H->tier[t].offset + (uint64_t)H->tier[t].rec_size * H->tier[t].capacity > size) return 0;
+  }
+  return 1;
+}
+
+int bq25792_history_open(bq25792_history_t **out, const char *path, bool writable) {
+  if (!out || !path) return -EINVAL;
+  *out = NULL;
+
+  const size_t want = layout_size();
+  int fd = open(path, writable ? (O_RDWR | O_CREAT | O_CLOEXEC) : (O_RDONLY | O_CLOEXEC), 0644);
+  if (fd < 0) return -errno;
+
+  struct stat sb;
+  if (fstat(fd, &sb) < 0) {
+    int e = -errno;
+    close(fd);
+    return e;
+  }
+
+  int fresh = 0;
+  if ((size_t)sb.st_size != want) {
+    if (!writable) {
+      close(fd);
+      return -EPROTO;
+    }
+    /* Yeni (ya da farkli layout'lu) dosya: tum alani simdi ayir, sonradan SIGBUS/parcalanma olmasin */
+    if (ftruncate(fd, 0) < 0) {
+      int e = -errno;
+      close(fd);
+      return e;
+    }
+    /* posix_fallocate errno'yu ayarlamaz, hatayi doner */
+    int rc = posix_fallocate(fd, 0, (off_t)want);
+    if (rc) {
+      close(fd);
+      return -rc;
+    }
+    fresh = 1;
+  }
+
+  void *p = mmap(NULL, want, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+  int e = -errno;
+  close(fd);
+  if (p == MAP_FAILED) return e;
+
+  bq25792_history_t *h = (bq25792_history_t*)calloc(1, sizeof(*h));
+  if (!h) {
+    munmap(p, want);
+    return -ENOMEM;
+  }
+  h->map = (uint8_t*)p;
+  h->size = want;
+  h->writable = writable;
+
+  if (fresh || !header_valid(hdr(h), want)) {
+    if (!writable) {
+      bq25792_history_close(h);
+      return -EPROTO;
+    }
+    init_header(hdr(h), want);
+  }
+
+  *out = h;
+  return 0;
+}
+
+void bq25792_history_close(bq25792_history_t *h) {
+  if (!h) return;
+  if (h->map) {
+    if (h->writable) (void)msync(h->map, h->size, MS_ASYNC);
+    munmap(h->map, h->size);
+  }
+  free(h);
+}
+
+void bq25792_history_sample_from(bq25792_hist_sample_t *o, const bq25792_snapshot_t *snap) {
+  const bq25792_status_t *st = &snap->st;
+  memset(o, 0, sizeof(*o));
+  o->ts_ms = snap->ts_ms;
+  o->ibat_ma = (int16_t)st->ibat_ma;
+  o->ibus_ma = (int16_t)st->ibus_ma;
+  o->vbat_mv = (uint16_t)st->vbat_mv;
+  o->vbus_mv = (uint16_t)st->vbus_mv;
+  o->vsys_mv = (uint16_t)st->vsys_mv;
+  o->tdie_dc = (int16_t)(st->tdie_c * 10.0f);
+  o->soc_pct = (uint8_t)snap->soc_pct;
+  o->chg_stat = st->chg_stat;
+  o->vbus_stat = st->vbus_stat;
+  o->flags = (uint8_t)((st->fault_any ? BQ25792_HIST_F_FAULT : 0) |
+                       (st->pg ? BQ25792_HIST_F_PG : 0) |
+                       (st->vbus_present ? BQ25792_HIST_F_VBUS : 0));
+}
+
+static void sample_fields(const bq25792_hist_sample_t *s, int32_t v[BQ25792_HIST_NFIELDS]) {
+  v[BQ25792_HIST_VBAT] = s->vbat_mv;
+  v[BQ25792_HIST_VSYS] = s->vsys_mv;
+  v[BQ25792_HIST_VBUS] = s->vbus_mv;
+  v[BQ25792_HIST_IBAT] = s->ibat_ma;
+  v[BQ25792_HIST_IBUS] = s->ibus_ma;
+  v[BQ25792_HIST_TDIE] = s->tdie_dc;
+  v[BQ25792_HIST_SOC]  = s->soc_pct;
+}
+
+static void* slot(bq25792_history_t *h, int t, uint64_t idx) {
+  const hist_tier_t *T = &hdr(h)->tier[t];
+  return h->map + T->offset + (idx % T->capacity) * T->rec_size;
+}
+
+/* Kaydi ring'e yaz, sonra head'i yayinla (okuyucu yarim kayit gormesin) */
+static void tier_push(bq25792_history_t *h, int t, const void *rec) {
+  hist_tier_t *T = &hdr(h)->tier[t];
+  const uint64_t head = atomic_load_explicit(&T->head, memory_order_relaxed);
+  memcpy(slot(h, t, head), rec, T->rec_size);
+  atomic_store_explicit(&T->head, head + 1, memory_order_release);
+}
+
+static void accum_to_agg(const hist_accum_t *a, bq25792_hist_agg_t *out) {
+  memset(out, 0, sizeof(*out));
+  out->ts_ms = a->bucket_ms;
+  out->count = a->count;
+  out->fault_count = a->fault_count;
+  for (int f = 0; f < BQ25792_HIST_NFIELDS; f++) {
+    out->f[f].min = a->min[f];
+    out->f[f].max = a->max[f];
+    out->f[f].mean = a->count ? (int32_t)(a->sum[f] / (int64_t)a->count) : 0;
+  }
+}
+
+int bq25792_history_append(bq25792_history_t *h, const bq25792_hist_sample_t *in) {
+  if (!h || !in || !h->writable) return -EINVAL;
+  hist_header_t *H = hdr(h);
+
+  bq25792_hist_sample_t s = *in;
+  if (s.ts_ms < H->last_ts_ms) s.ts_ms = H->last_ts_ms;
+  H->last_ts_ms = s.ts_ms;
+
+  tier_push(h, BQ25792_HIST_RAW, &s);
+
+  int32_t v[BQ25792_HIST_NFIELDS];
+  sample_fields(&s, v);
+
+  for (int t = BQ25792_HIST_1M; t < BQ25792_HIST_NTIERS; t++) {
+    hist_accum_t *a = &H->acc[t];
+    const int64_t bucket = s.ts_ms - (s.ts_ms % tier_res_ms[t]);
+
+    if (a->count > 0 && a->bucket_ms != bucket) {
+      bq25792_hist_agg_t rec;
+      accum_to_agg(a, &rec);
+      tier_push(h, t, &rec);
+      a->count = 0;
+    }
+    if (a->count == 0) {
+      memset(a, 0, sizeof(*a));
+      a->bucket_ms = bucket;
+      for (int f = 0; f < BQ25792_HIST_NFIELDS; f++) {
+        a->min[f] = INT32_MAX;
+        a->max[f] = INT32_MIN;
+      }
+    }
+
+    a->count++;
+    if (s.flags & BQ25792_HIST_F_FAULT) a->fault_count++;
+    for (int f = 0; f < BQ25792_HIST_NFIELDS; f++) {
+      a->sum[f] += v[f];
+      if (v[f] < a->min[f]) a->min[f] = v[f];
+      if (v[f] > a->max[f]) a->max[f] = v[f];
+    }
+  }
+  return 0;
+}
+
+/* Ring'deki gecerli mantiksal aralik [first, head) */
+static void tier_range(bq25792_history_t *h, int t, uint64_t *first, uint64_t *head) {
+  const hist_tier_t *T = &hdr(h)->tier[t];
+  *head = atomic_load_explicit(&T->head, memory_order_acquire);
+  /* yazicinin o an ustune yazabilecegi en eski slotu atla */
+  const uint64_t keep = (T->capacity > 1) ? (uint64_t)T->capacity - 1 : 1;
+  *first = (*head > keep) ? (*head - keep) : 0;
+}
+
+static int64_t rec_ts(bq25792_history_t *h, int t, uint64_t idx) {
+  int64_t ts;
+  memcpy(&ts, slot(h, t, idx), sizeof(ts)); /* her iki kayit tipi de ts_ms ile baslar */
+  return ts;
+}
+
+/* ts >= from olan ilk mantiksal index */
+static uint64_t lower_bound(bq25792_history_t *h, int t, uint64_t lo, uint64_t hi, int64_t from_ms) {
+  while (lo < hi) {
+    uint64_t mid = lo + (hi - lo) / 2;
+    if (rec_ts(h, t, mid) < from_ms) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+int bq25792_history_query_raw(bq25792_history_t *h, int64_t from_ms, int64_t to_ms,
+                              bq25792_hist_raw_cb cb, void *user) {
+  if (!h || !cb) return -EINVAL;
+  uint64_t first, head;
+  tier_range(h, BQ25792_HIST_RAW, &first, &head);
+
+  for (uint64_t i = lower_bound(h, BQ25792_HIST_RAW, first, head, from_ms); i < head; i++) {
+    bq25792_hist_sample_t s;
+    memcpy(&s, slot(h, BQ25792_HIST_RAW, i), sizeof(s));
+    if (s.ts_ms > to_ms) break;
+    if (cb(&s, user)) break;
+  }
+  return 0;
+}
+
+int bq25792_history_query_agg(bq25792_history_t *h, bq25792_hist_res_t res,
+                              int64_t from_ms, int64_t to_ms,
+                              bq25792_hist_agg_cb cb, void *user) {
+  if (!h || !cb || res <= BQ25792_HIST_RAW || res >= BQ25792_HIST_NTIERS) return -EINVAL;
+  uint64_t first, head;
+  tier_range(h, res, &first, &head);
+
+  /* bucket'i from'u iceren kayittan basla */
+  const int64_t from_bucket = from_ms - (from_ms % tier_res_ms[res]);
+  for (uint64_t i = lower_bound(h, res, first, head, from_bucket); i < head; i++) {
+    bq25792_hist_agg_t a;
+    memcpy(&a, slot(h, res, i), sizeof(a));
+    if (a.ts_ms > to_ms) return 0;
+    if (cb(&a, user)) return 0;
+  }
+
+  /* kapanmamis bucket */
+  hist_accum_t acc;
+  memcpy(&acc, &hdr(h)->acc[res], sizeof(acc));
+  if (acc.count > 0 && acc.bucket_ms >= from_bucket && acc.bucket_ms <= to_ms) {
+    bq25792_hist_agg_t a;
+    accum_to_agg(&acc, &a);
+    (void)cb(&a, user);
+  }
+  return 0;
+}
+
+int bq25792_history_span(bq25792_history_t *h, bq25792_hist_res_t res,
+                         uint64_t *count, int64_t *oldest_ms) {
+  if (!h || res < 0 || res >= BQ25792_HIST_NTIERS) return -EINVAL;
+  uint64_t first, head;
+  tier_range(h, res, &first, &head);
+  if (count) *count = head - first;
+  if (head == first) return -ENODATA;
+  if (oldest_ms) *oldest_ms = rec_ts(h, res, first);
+  return 0;
+}
+
+bq25792_hist_res_t bq25792_history_pick_res(bq25792_history_t *h, int64_t from_ms, int64_t to_ms,
+                                            uint64_t max_rows) {
+  for (int t = BQ25792_HIST_RAW; t < BQ25792_HIST_NTIERS; t++) {
+    const hist_tier_t *T = &hdr(h)->tier[t];
+    uint64_t first, head;
+    tier_range(h, t, &first, &head);
+    if (head == first) continue;
+
+    /* ring dolmadiysa eldeki tum gecmis bu tier'da; dolduysa from kapsanmali */
+    const int covers = (rec_ts(h, t, first) <= from_ms) ||
+                       (atomic_load_explicit(&T->head, memory_order_relaxed) < T->capacity);
+    if (!covers) continue;
+
+    const int64_t lo_ts = (t == BQ25792_HIST_RAW) ? from_ms : from_ms - (from_ms % tier_res_ms[t]);
+    const uint64_t lo = lower_bound(h, t, first, head, lo_ts);
+    const uint64_t hi = lower_bound(h, t, lo, head, (to_ms == INT64_MAX) ? to_ms : to_ms + 1);
+    if (hi - lo <= max_rows) return (bq25792_hist_res_t)t;
+  }
+  return BQ25792_HIST_1D;
+}
+
+const char* bq25792_hist_res_str(bq25792_hist_res_t res) {
+  switch (res) {
+    case BQ25792_HIST_RAW: return "raw";
+    case BQ25792_HIST_1M:  return "1m";
+    case BQ25792_HIST_1H:  return "1h";
+    case BQ25792_HIST_1D:  return "1d";
+    default:               return "?";
+  }
+}
@@ -0,0 +1,118 @@
+#include "bq25792_transport.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <i2c/smbus.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+/* Linux i2c-dev transport: /dev/i2c-N + I2C_SLAVE */
+typedef struct {
+  int fd;
+  uint8_t addr;
+  unsigned long funcs; /* I2C_FUNCS: adaptorun destekledigi transfer tipleri */
+} i2c_ctx_t;
+
+/* Smbus block read tek seferde en fazla 32 byte doner */
+#define SMBUS_BLOCK_MAX   32
+
+static int i2c_read_u8(void *ctx, uint8_t reg, uint8_t *val) {
+  i2c_ctx_t *c = (i2c_ctx_t*)ctx;
+  int r = i2c_smbus_read_byte_data(c->fd, reg);
+  if (r < 0) return -errno;
+  *val = (uint8_t)r;
+  return 0;
+}
+
+static int i2c_write_u8(void *ctx, uint8_t reg, uint8_t val) {
+  i2c_ctx_t *c = (i2c_ctx_t*)ctx;
+  int r = i2c_smbus_write_byte_data(c->fd, reg, val);
+  if (r < 0) return -errno;
+  return 0;
+}
+
+/* Ardisik registerlari tek transfer ile okur (register pointer yaz + repeated start + N byte oku).
+   I2C_RDWR yoksa SMBus i2c block read (32 byte parcalar), o da yoksa byte byte okur. */
+static int i2c_read_block(void *ctx, uint8_t reg, uint8_t *buf, size_t len) {
+  i2c_ctx_t *c = (i2c_ctx_t*)ctx;
+
+  if (c->funcs & I2C_FUNC_I2C) {
+    uint8_t start = reg;
+    struct i2c_msg msgs[2] = {
+      { .addr = c->addr, .flags = 0,        .len = 1,             .buf = &start },
+      { .addr = c->addr, .flags = I2C_M_RD, .len = (uint16_t)len, .buf = buf    },
+    };
+    struct i2c_rdwr_ioctl_data xfer = { .msgs = msgs, .nmsgs = 2 };
+    if (ioctl(c->fd, I2C_RDWR, &xfer) < 0) return -errno;
+    return 0;
+  }
+
+  if (c->funcs & I2C_FUNC_SMBUS_READ_I2C_BLOCK) {
+    size_t off = 0;
+    while (off < len) {
+      size_t n = len - off;
+      if (n > SMBUS_BLOCK_MAX) n = SMBUS_BLOCK_MAX;
+      int r = i2c_smbus_read_i2c_block_data(c->fd, (uint8_t)(reg + off), (uint8_t)n, buf + off);
+      if (r < 0) return -errno;
+      if ((size_t)r != n) return -EIO;
+      off += n;
+    }
+    return 0;
+  }
+
+  for (size_t i = 0; i < len; i++) {
+    int rc = i2c_read_u8(ctx, (uint8_t)(reg + i), &buf[i]);
+    if (rc) return rc;
+  }
+  return 0;
+}
+
+static void i2c_close(void *ctx) {
+  i2c_ctx_t *c = (i2c_ctx_t*)ctx;
+  if (c->fd >= 0) close(c->fd);
+  free(c);
+}
+
+static const bq25792_transport_ops_t i2c_ops = {
+  .name = "i2c",
+  .read_u8 = i2c_read_u8,
+  .write_u8 = i2c_write_u8,
+  .read_block = i2c_read_block,
+  .close = i2c_close,
+};
+
+int bq25792_open_i2c(bq25792_dev_t **out, int i2c_bus, uint8_t i2c_addr) {
+  if (!out) return -EINVAL;
+  *out = NULL;
+
+  char devpath[32];
+  snprintf(devpath, sizeof(devpath), "/dev/i2c-%d", i2c_bus);
+
+  int fd = open(devpath, O_RDWR | O_CLOEXEC);
+  if (fd < 0) return -errno;
+
+  if (ioctl(fd, I2C_SLAVE, i2c_addr) < 0) {
+    int e = -errno;
+    close(fd);
+    return e;
+  }
+
+  i2c_ctx_t *c = (i2c_ctx_t*)calloc(1, sizeof(*c));
+  if (!c) {
+    close(fd);
+    return -ENOMEM;
+  }
+  c->fd = fd;
+  c->addr = i2c_addr;
+
+  /* Adaptor I2C_RDWR desteklemiyorsa SMBus block/byte read'e duseriz */
+  if (ioctl(fd, I2C_FUNCS, &c->funcs) < 0) c->funcs = 0;
+
+  int rc = bq25792_open_transport(out, &i2c_ops, c, i2c_bus, i2c_addr);
+  if (rc) i2c_close(c);
+  return rc;
+}
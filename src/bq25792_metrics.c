@@ -0,0 +1,165 @@
+#include "bq25792_metrics.h"
+#include "bq25792_metrics_priv.h"
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/* 10us..1s: tek byte I2C islemi (~100us) ile tam snapshot/fsync arasi */
+const uint32_t bq25792_hist_le_us[BQ25792_HIST_NBUCKETS - 1] = {
+  10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 1000000
+};
+
+int bq25792_hist_bucket(uint64_t ns) {
+  const uint64_t us = ns / 1000u;
+  for (int i = 0; i < BQ25792_HIST_NBUCKETS - 1; i++) {
+    if (us <= bq25792_hist_le_us[i]) return i;
+  }
+  return BQ25792_HIST_NBUCKETS - 1;
+}
+
+void bq25792_hist_observe(bq25792_hist_t *h, uint64_t ns) {
+  h->bucket[bq25792_hist_bucket(ns)]++;
+  h->count++;
+  h->sum_ns += ns;
+}
+
+const char* bq25792_op_str(bq25792_op_t op) {
+  switch (op) {
+    case BQ25792_OP_READ_U8:    return "read_u8";
+    case BQ25792_OP_WRITE_U8:   return "write_u8";
+    case BQ25792_OP_READ_BLOCK: return "read_block";
+    default:                    return "unknown";
+  }
+}
+
+void bq25792_om_init(bq25792_om_t *om, char *buf, size_t len, int prom_text) {
+  om->buf = buf;
+  om->len = len;
+  om->off = 0;
+  om->prom_text = prom_text;
+}
+
+static int om_printf(bq25792_om_t *om, const char *fmt, ...) {
+  if (om->off >= om->len) return -ENOSPC;
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(om->buf + om->off, om->len - om->off, fmt, ap);
+  va_end(ap);
+  if (n < 0) return -EIO;
+  if ((size_t)n >= om->len - om->off) return -ENOSPC;
+  om->off += (size_t)n;
+  return 0;
+}
+
+int bq25792_om_family(bq25792_om_t *om, const char *name, const char *type, const char *help) {
+  /* Prometheus 0.0.4'te aile adi sample adiyla ayni olmali */
+  const char *sfx = (om->prom_text && strcmp(type, "counter") == 0) ? "_total" : "";
+  if (help) {
+    int rc = om_printf(om, "# HELP %s%s %s\n", name, sfx, help);
+    if (rc) return rc;
+  }
+  return om_printf(om, "# TYPE %s%s %s\n", name, sfx, type);
+}
+
+int bq25792_om_sample(bq25792_om_t *om, const char *name, const char *labels, double value) {
+  if (labels && *labels) return om_printf(om, "%s{%s} %.15g\n", name, labels, value);
+  return om_printf(om, "%s %.15g\n", name, value);
+}
+
+int bq25792_om_histogram(bq25792_om_t *om, const char *name, const char *labels, const bq25792_hist_t *h) {
+  const char *sep = (labels && *labels) ? "," : "";
+  if (!labels) labels = "";
+
+  uint64_t cum = 0;
+  for (int i = 0; i < BQ25792_HIST_NBUCKETS; i++) {
+    cum += h->bucket[i];
+    int rc;
+    if (i < BQ25792_HIST_NBUCKETS - 1) {
+      rc = om_printf(om, "%s_bucket{%s%sle=\"%g\"} %llu\n", name, labels, sep,
+                     bq25792_hist_le_us[i] / 1e6, (unsigned long long)cum);
+    } else {
+      rc = om_printf(om, "%s_bucket{%s%sle=\"+Inf\"} %llu\n", name, labels, sep,
+                     (unsigned long long)cum);
+    }
+    if (rc) return rc;
+  }
+  const char *lb = *labels ? "{" : "";
+  const char *le = *labels ? "}" : "";
+  int rc = om_printf(om, "%s_sum%s%s%s %.9f\n", name, lb, labels, le, h->sum_ns / 1e9);
+  if (rc) return rc;
+  return om_printf(om, "%s_count%s%s%s %llu\n", name, lb, labels, le, (unsigned long long)h->count);
+}
+
+static const char* lb_join(char *lb, size_t len, const char *base, const char *extra) {
+  if (!base || !*base) snprintf(lb, len, "%s", extra);
+  else if (!*extra) snprintf(lb, len, "%s", base);
+  else snprintf(lb, len, "%s,%s", base, extra);
+  return lb;
+}
+
+int bq25792_metrics_openmetrics(bq25792_om_t *om, const bq25792_metrics_t *const *m,
+                                const char *const *labels, int n) {
+  char lb[256];
+  char op_lb[32];
+  int rc;
+
+#define OM(call) do { rc = (call); if (rc) return rc; } while (0)
+#define EACH_OP(fam, help, type, EMIT) do { \
+    OM(bq25792_om_family(om, fam, type, help)); \
+    for (int i = 0; i < n; i++) { \
+      for (int op = 0; op < BQ25792_OP_COUNT; op++) { \
+        snprintf(op_lb, sizeof(op_lb), "op=\"%s\"", bq25792_op_str((bq25792_op_t)op)); \
+        lb_join(lb, sizeof(lb), labels ? labels[i] : NULL, op_lb); \
+        EMIT; \
+      } \
+    } \
+  } while (0)
+
+  /* Aile basina tek HELP/TYPE, ardindan tum cihazlarin serileri */
+  EACH_OP("bq25792_i2c_ops", "Successful transport operations", "counter",
+          OM(bq25792_om_sample(om, "bq25792_i2c_ops_total", lb, (double)m[i]->ok[op])));
+  EACH_OP("bq25792_i2c_errors", "Failed transport operations", "counter",
+          OM(bq25792_om_sample(om, "bq25792_i2c_errors_total", lb, (double)m[i]->errors[op])));
+  EACH_OP("bq25792_i2c_bytes", "Data bytes transferred", "counter",
+          OM(bq25792_om_sample(om, "bq25792_i2c_bytes_total", lb, (double)m[i]->bytes[op])));
+  EACH_OP("bq25792_i2c_op_seconds", "Transport operation latency", "histogram",
+          OM(bq25792_om_histogram(om, "bq25792_i2c_op_seconds", lb, &m[i]->latency[op])));
+
+  /* Sadece hata gormus registerlar (seri kardinalitesi sinirli kalsin) */
+  OM(bq25792_om_family(om, "bq25792_i2c_reg_errors", "counter",
+                       "Failed operations by starting register"));
+  for (int i = 0; i < n; i++) {
+    for (int r = 0; r < 256; r++) {
+      if (!m[i]->reg_errors[r]) continue;
+      char reg_lb[16];
+      snprintf(reg_lb, sizeof(reg_lb), "reg=\"0x%02x\"", r);
+      lb_join(lb, sizeof(lb), labels ? labels[i] : NULL, reg_lb);
+      OM(bq25792_om_sample(om, "bq25792_i2c_reg_errors_total", lb, (double)m[i]->reg_errors[r]));
+    }
+  }
+
+  OM(bq25792_om_family(om, "bq25792_status_reads", "counter", "bq25792_read_status calls"));
+  for (int i = 0; i < n; i++)
+    OM(bq25792_om_sample(om, "bq25792_status_reads_total", labels ? labels[i] : NULL, (double)m[i]->status_reads));
+  OM(bq25792_om_family(om, "bq25792_status_errors", "counter", "Failed bq25792_read_status calls"));
+  for (int i = 0; i < n; i++)
+    OM(bq25792_om_sample(om, "bq25792_status_errors_total", labels ? labels[i] : NULL, (double)m[i]->status_errors));
+  OM(bq25792_om_family(om, "bq25792_adc_restarts", "counter", "ADC found disabled and re-enabled"));
+  for (int i = 0; i < n; i++)
+    OM(bq25792_om_sample(om, "bq25792_adc_restarts_total", labels ? labels[i] : NULL, (double)m[i]->adc_restarts));
+  OM(bq25792_om_family(om, "bq25792_cache_hits", "counter", "Register reads served from the handle cache"));
+  for (int i = 0; i < n; i++)
+    OM(bq25792_om_sample(om, "bq25792_cache_hits_total", labels ? labels[i] : NULL, (double)m[i]->cache_hits));
+  OM(bq25792_om_family(om, "bq25792_cache_misses", "counter", "Cacheable register reads that went to the device"));
+  for (int i = 0; i < n; i++)
+    OM(bq25792_om_sample(om, "bq25792_cache_misses_total", labels ? labels[i] : NULL, (double)m[i]->cache_misses));
+  OM(bq25792_om_family(om, "bq25792_writes_skipped", "counter", "Read-modify-write calls that changed nothing"));
+  for (int i = 0; i < n; i++)
+    OM(bq25792_om_sample(om, "bq25792_writes_skipped_total", labels ? labels[i] : NULL, (double)m[i]->writes_skipped));
+
+#undef EACH_OP
+#undef OM
+  return 0;
+}
@@ -0,0 +1,5 @@
+#pragma once
+#include <stdint.h>
+
+/* Kutuphane ici: gecikmenin (ns) dustugu histogram bucket'i */
+int bq25792_hist_bucket(uint64_t ns);
@@ -0,0 +1,182 @@
+#include "bq25792_regs.h"
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+const bq25792_reg_desc_t bq25792_reg_table[] = {
+#define R_DESC(id, addr, width, name) { name, addr, width },
+  BQ25792_REG_MAP(R_DESC)
+#undef R_DESC
+};
+const size_t bq25792_reg_table_len = sizeof(bq25792_reg_table) / sizeof(bq25792_reg_table[0]);
+
+/* 16-bit registerlardaki alanlar hep 8 bitten genis; genislik buradan cikar */
+const bq25792_field_desc_t bq25792_field_table[BQ25792_F_COUNT] = {
+#define F_DESC(id, name, reg, shift, bits, flags, lsb, offset, unit) \
+  { name, reg, ((shift) + (bits) > 8) ? 2 : 1, shift, bits, flags, (float)(lsb), (float)(offset), unit },
+  BQ25792_FIELD_MAP(F_DESC)
+#undef F_DESC
+};
+
+int32_t bq25792_field_raw(const uint8_t *img, bq25792_field_id_t id) {
+  const bq25792_field_desc_t *f = &bq25792_field_table[id];
+  uint32_t v = img[f->reg];
+  if (f->width == 2) v = (v << 8) | img[f->reg + 1];
+  v = (v >> f->shift) & ((1u << f->bits) - 1u);
+  if ((f->flags & BQ25792_FF_SIGNED) && (v & (1u << (f->bits - 1)))) return (int32_t)v - (int32_t)(1u << f->bits);
+  return (int32_t)v;
+}
+
+double bq25792_field_value(const uint8_t *img, bq25792_field_id_t id) {
+  const bq25792_field_desc_t *f = &bq25792_field_table[id];
+  const int32_t raw = bq25792_field_raw(img, id);
+  if (f->lsb == 0.0f) return raw;
+  return raw * (double)f->lsb + (double)f->offset;
+}
+
+#define RAW(id)  bq25792_field_raw(img, BQ25792_F_##id)
+
+void bq25792_decode_status(const uint8_t *img, bq25792_status_t *st) {
+  st->iindpm = RAW(IINDPM_STAT);
+  st->vindpm = RAW(VINDPM_STAT);
+  st->watchdog_expired = RAW(WD_STAT);
+  st->poor_source = RAW(POORSRC_STAT);
+  st->pg = RAW(PG_STAT);
+  st->ac2_present = RAW(AC2_PRESENT_STAT);
+  st->ac1_present = RAW(AC1_PRESENT_STAT);
+  st->vbus_present = RAW(VBUS_PRESENT_STAT);
+
+  st->chg_stat = (uint8_t)RAW(CHG_STAT);
+  st->vbus_stat = (uint8_t)RAW(VBUS_STAT);
+  st->bc12_done = RAW(BC12_DONE_STAT);
+
+  /* Fault flags (bit bazinda alanlar tabloda, burada ham byte) */
+  st->fault0 = img[BQ25792_REG26_FAULT_FLAG_0];
+  st->fault1 = img[BQ25792_REG27_FAULT_FLAG_1];
+  st->fault_any = (st->fault0 != 0) || (st->fault1 != 0) || st->watchdog_expired || st->poor_source;
+
+  st->chg_flag0 = img[BQ25792_REG22_CHG_FLAG_0];
+  st->chg_flag1 = img[BQ25792_REG23_CHG_FLAG_1];
+  st->chg_flag2 = img[BQ25792_REG24_CHG_FLAG_2];
+  st->chg_flag3 = img[BQ25792_REG25_CHG_FLAG_3];
+
+  /* ADC (LSB=1mV/1mA, TDIE=0.5C) */
+  st->ibus_ma = RAW(IBUS_ADC);
+  st->ibat_ma = RAW(IBAT_ADC);
+  st->vbus_mv = RAW(VBUS_ADC);
+  st->vbat_mv = RAW(VBAT_ADC);
+  st->vsys_mv = RAW(VSYS_ADC);
+  st->tdie_c = (float)RAW(TDIE_ADC) * 0.5f;
+
+  /* Cell count from REG0A[7:6] (1s..4s) ve hucre voltajindan kaba SoC */
+  st->cell_count = (uint8_t)(RAW(CELL) + 1);
+  const int vcell = (st->vbat_mv > 0) ? (st->vbat_mv / (int)st->cell_count) : 0;
+  st->soc_pct_est = bq25792_soc_from_vcell_mv(vcell);
+}
+
+#undef RAW
+
+/* Sabit buffer'a ekleyen yazici; tasarsa err = -ENOSPC, sonraki eklemeler yok sayilir */
+typedef struct {
+  char *buf;
+  size_t len;
+  size_t off;
+  int err;
+} wbuf_t;
+
+__attribute__((format(printf, 2, 3)))
+static void wb_printf(wbuf_t *w, const char *fmt, ...) {
+  if (w->err) return;
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(w->buf + w->off, w->len - w->off, fmt, ap);
+  va_end(ap);
+  if (n < 0 || (size_t)n >= w->len - w->off) {
+    w->err = -ENOSPC;
+    return;
+  }
+  w->off += (size_t)n;
+}
+
+/* Fiziksel deger: tam sayiysa tam sayi, degilse kisa ondalik */
+static void wb_value(wbuf_t *w, const uint8_t *img, bq25792_field_id_t id) {
+  const double v = bq25792_field_value(img, id);
+  if (v == (double)(long long)v) wb_printf(w, "%lld", (long long)v);
+  else wb_printf(w, "%.2f", v);
+}
+
+static int reg_in(uint8_t reg, uint8_t first, uint8_t last) {
+  return reg >= first && reg <= last;
+}
+
+int bq25792_regs_dump(const uint8_t *img, uint8_t first, uint8_t last,
+                      bq25792_dump_fmt_t fmt, char *buf, size_t len) {
+  if (!img || !buf || len == 0) return -EINVAL;
+  wbuf_t w = { buf, len, 0, 0 };
+  buf[0] = '\0';
+
+  switch (fmt) {
+    case BQ25792_DUMP_RAW:
+      for (size_t i = 0; i < bq25792_reg_table_len; i++) {
+        const bq25792_reg_desc_t *r = &bq25792_reg_table[i];
+        if (!reg_in(r->addr, first, last)) continue;
+        if (r->width == 2) {
+          wb_printf(&w, "REG%02X %-24s 0x%04X\n", r->addr, r->name, (img[r->addr] << 8) | img[r->addr + 1]);
+        } else {
+          wb_printf(&w, "REG%02X %-24s 0x%02X\n", r->addr, r->name, img[r->addr]);
+        }
+      }
+      break;
+
+    case BQ25792_DUMP_CSV:
+      wb_printf(&w, "reg,field,raw,value,unit\n");
+      for (int id = 0; id < BQ25792_F_COUNT; id++) {
+        const bq25792_field_desc_t *f = &bq25792_field_table[id];
+        if (!reg_in(f->reg, first, last)) continue;
+        wb_printf(&w, "0x%02x,%s,%ld,", f->reg, f->name, (long)bq25792_field_raw(img, (bq25792_field_id_t)id));
+        wb_value(&w, img, (bq25792_field_id_t)id);
+        wb_printf(&w, ",%s\n", f->unit);
+      }
+      break;
+
+    case BQ25792_DUMP_JSON: {
+      const char *sep = "";
+      wb_printf(&w, "{\"regs\":{");
+      for (size_t i = 0; i < bq25792_reg_table_len; i++) {
+        const bq25792_reg_desc_t *r = &bq25792_reg_table[i];
+        if (!reg_in(r->addr, first, last)) continue;
+        const unsigned v = (r->width == 2) ? (unsigned)((img[r->addr] << 8) | img[r->addr + 1]) : img[r->addr];
+        wb_printf(&w, "%s\"0x%02x\":%u", sep, r->addr, v);
+        sep = ",";
+      }
+      sep = "";
+      wb_printf(&w, "},\"fields\":{");
+      for (int id = 0; id < BQ25792_F_COUNT; id++) {
+        const bq25792_field_desc_t *f = &bq25792_field_table[id];
+        if (!reg_in(f->reg, first, last)) continue;
+        wb_printf(&w, "%s\"%s\":", sep, f->name);
+        wb_value(&w, img, (bq25792_field_id_t)id);
+        sep = ",";
+      }
+      wb_printf(&w, "}}\n");
+      break;
+    }
+
+    default:
+      return -EINVAL;
+  }
+
+  if (w.err) return w.err;
+  return (int)w.off;
+}
+
+int bq25792_dump_fmt_parse(const char *s, bq25792_dump_fmt_t *fmt) {
+  if (!s || !fmt) return -EINVAL;
+  if (strcmp(s, "raw") == 0) *fmt = BQ25792_DUMP_RAW;
+  else if (strcmp(s, "csv") == 0) *fmt = BQ25792_DUMP_CSV;
+  else if (strcmp(s, "json") == 0) *fmt = BQ25792_DUMP_JSON;
+  else return -EINVAL;
+  return 0;
+}
@@ -0,0 +1,479 @@
+#define _GNU_SOURCE
+#include "bq25792.h"
+#include "bq25792_history.h"
+#include "bq25792_soc.h"
+
+#include <errno.h>
+#include <getopt.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+  Kayitli ornek izlerini gosterim SoC filtresinden (bq25792_socfilt) gercek
+  zamandan bagimsiz gecirir ve parametre izgarasini referans SoC'ye gore puanlar.
+  Iz: bqctl history CSV'si (ham) ya da dogrudan history.db. Referans: CSV'de
+  soc_ref kolonu varsa o, yoksa iz uzerinde calisan coulomb counter (ilk sarj
+  sonu/dinlenme kalibrasyonundan sonra). Kaba tahmin, yon ve referans izler
+  yuklenirken bir kez hesaplanir; izgara noktasi basina sadece filtre calisir.
+  (nokta, iz) ciftleri thread'lere dagitilir, her thread kendi toplamini tutar.
+*/
+
+#define MAX_AXIS 64
+
+typedef struct {
+  const char *path;
+  size_t n, cap;
+  int64_t *t_ms;
+  int8_t *raw;        /* kaba tahmin (soc_pct_est) */
+  int8_t *dir;        /* +1/0/-1 */
+  uint8_t *seg;       /* 1: yeni parca (ilk ornek ya da bosluk): filtre yeniden baslar */
+  float *ref;         /* referans SoC, < 0 = yok */
+} trace_t;
+
+typedef struct {
+  uint64_t n;
+  uint64_t steps;     /* gosterim degisimi (jitter) */
+  double abs_sum;
+  double sq_sum;
+  float max_err;
+} acc_t;
+
+typedef struct {
+  bq25792_socfilt_config_t cfg;
+  int is_default;
+  acc_t acc;
+} point_t;
+
+/* Yukleme ayarlari */
+typedef struct {
+  int cells;
+  long long max_gap_ms;
+  bq25792_cc_config_t cc;
+} load_cfg_t;
+
+/* Yukleme durumu: iz basina coulomb counter ve yon icin varsayilan filtre */
+typedef struct {
+  const load_cfg_t *lc;
+  trace_t *tr;
+  bq25792_cc_t cc;
+  bq25792_socfilt_t dirf;
+  int64_t last_t;
+  int err;
+} loader_t;
+
+static long long mono_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int trace_grow(trace_t *t) {
+  const size_t cap = t->cap ? t->cap * 2 : 4096;
+  int64_t *tm = realloc(t->t_ms, cap * sizeof(*tm));
+  if (tm) t->t_ms = tm;
+  int8_t *raw = realloc(t->raw, cap);
+  if (raw) t->raw = raw;
+  int8_t *dir = realloc(t->dir, cap);
+  if (dir) t->dir = dir;
+  uint8_t *seg = realloc(t->seg, cap);
+  if (seg) t->seg = seg;
+  float *ref = realloc(t->ref, cap * sizeof(*ref));
+  if (ref) t->ref = ref;
+  if (!tm || !raw || !dir || !seg || !ref) return -ENOMEM;
+  t->cap = cap;
+  return 0;
+}
+
+static void trace_free(trace_t *t) {
+  free(t->t_ms);
+  free(t->raw);
+  free(t->dir);
+  free(t->seg);
+  free(t->ref);
+}
+
+/* Tek ornek: daemon'un yaptigi gibi kaba tahmin ve yon; referans verilmediyse cc */
+static void loader_add(loader_t *L, int64_t t_ms, int vbat_mv, int ibat_ma, int chg_stat, int cells, float ref) {
+  trace_t *t = L->tr;
+  if (t->n == t->cap && trace_grow(t)) {
+    L->err = -ENOMEM;
+    return;
+  }
+  if (cells < 1) cells = L->lc->cells;
+  const int gap = t->n == 0 || t_ms - L->last_t > L->lc->max_gap_ms || t_ms < L->last_t;
+  L->last_t = t_ms;
+
+  const int raw = bq25792_soc_from_vcell_mv(vbat_mv > 0 ? vbat_mv / cells : 0);
+  if (ref < 0.0f) {
+    bq25792_status_t st;
+    memset(&st, 0, sizeof(st));
+    st.vbat_mv = vbat_mv;
+    st.ibat_ma = ibat_ma;
+    st.chg_stat = (uint8_t)chg_stat;
+    st.cell_count = (uint8_t)cells;
+    st.soc_pct_est = raw;
+    const int64_t t_ns = t_ms * 1000000LL;
+    bq25792_cc_update(&L->cc, t_ns, ibat_ma, vbat_mv);
+    bq25792_cc_on_status(&L->cc, t_ns, &st);
+    /* ilk kalibrasyondan once cc sadece OCV tahminini tasir: referans sayilmaz */
+    ref = L->cc.calibrations ? bq25792_cc_soc_pct(&L->cc) : -1.0f;
+  }
+
+  const size_t i = t->n++;
+  t->t_ms[i] = t_ms;
+  t->raw[i] = (int8_t)raw;
+  t->dir[i] = (int8_t)bq25792_socfilt_dir(&L->dirf, ibat_ma);
+  t->seg[i] = (uint8_t)gap;
+  t->ref[i] = ref;
+}
+
+static int hist_row(const bq25792_hist_sample_t *s, void *user) {
+  loader_t *L = (loader_t*)user;
+  loader_add(L, s->ts_ms, s->vbat_mv, s->ibat_ma, s->chg_stat, 0, -1.0f);
+  return L->err;
+}
+
+/* CSV: baslik satirindaki adlara gore; ts_ms, vbat_mv, ibat_ma zorunlu,
+   chg_stat, cell_count, soc_ref istege bagli (bqctl history ciktisi dogrudan okunur) */
+enum { COL_TS, COL_VBAT, COL_IBAT, COL_CHG, COL_CELLS, COL_REF, NCOLS };
+static const char *const col_name[NCOLS] = { "ts_ms", "vbat_mv", "ibat_ma", "chg_stat", "cell_count", "soc_ref" };
+
+static int load_csv(loader_t *L, FILE *f) {
+  char line[1024];
+  if (!fgets(line, sizeof(line), f)) return -ENODATA;
+
+  int idx[NCOLS];
+  for (int c = 0; c < NCOLS; c++) idx[c] = -1;
+  int ncol = 0;
+  for (char *save = NULL, *tok = strtok_r(line, ",\r\n", &save); tok; tok = strtok_r(NULL, ",\r\n", &save), ncol++) {
+    for (int c = 0; c < NCOLS; c++) {
+      if (strcmp(tok, col_name[c]) == 0) idx[c] = ncol;
+    }
+  }
+  if (idx[COL_TS] < 0 || idx[COL_VBAT] < 0 || idx[COL_IBAT] < 0) return -EPROTO;
+
+  while (fgets(line, sizeof(line), f) && !L->err) {
+    double v[NCOLS] = { 0, 0, 0, 0, 0, -1 };
+    char *p = line;
+    for (int k = 0; k < ncol && *p; k++) {
+      char *end;
+      const double x = strtod(p, &end);
+      for (int c = 0; c < NCOLS; c++) {
+        if (idx[c] == k && end != p) v[c] = x;
+      }
+      p = strchr(end, ',');
+      if (!p) break;
+      p++;
+    }
+    loader_add(L, (int64_t)v[COL_TS], (int)v[COL_VBAT], (int)v[COL_IBAT], (int)v[COL_CHG],
+               (int)v[COL_CELLS], (float)v[COL_REF]);
+  }
+  return L->err;
+}
+
+static int load_trace(trace_t *t, const char *path, const load_cfg_t *lc) {
+  memset(t, 0, sizeof(*t));
+  t->path = path;
+
+  loader_t L;
+  memset(&L, 0, sizeof(L));
+  L.lc = lc;
+  L.tr = t;
+  bq25792_cc_init(&L.cc, &lc->cc);
+  bq25792_socfilt_init(&L.dirf, NULL, 0, 0);
+
+  bq25792_history_t *h = NULL;
+  if (bq25792_history_open(&h, path, false) == 0) {
+    int rc = bq25792_history_query_raw(h, INT64_MIN, INT64_MAX, hist_row, &L);
+    bq25792_history_close(h);
+    return rc ? rc : L.err;
+  }
+
+  FILE *f = fopen(path, "r");
+  if (!f) return -errno;
+  int rc = load_csv(&L, f);
+  fclose(f);
+  return rc;
+}
+
+/* Tek iz, tek nokta: bosluklarda filtre yeniden baslar (daemon restart'i gibi) */
+static void run_one(const bq25792_socfilt_config_t *cfg, const trace_t *tr, acc_t *a) {
+  bq25792_socfilt_t f;
+  int prev = -1;
+  for (size_t i = 0; i < tr->n; i++) {
+    if (tr->seg[i]) {
+      bq25792_socfilt_init(&f, cfg, tr->raw[i], tr->t_ms[i]);
+    } else {
+      bq25792_socfilt_update(&f, tr->raw[i], tr->dir[i], tr->t_ms[i]);
+      if (f.soc_display != prev) a->steps++;
+    }
+    prev = f.soc_display;
+
+    const float ref = tr->ref[i];
+    if (ref < 0.0f) continue;
+    const float e = fabsf((float)f.soc_display - ref);
+    a->n++;
+    a->abs_sum += e;
+    a->sq_sum += (double)e * e;
+    if (e > a->max_err) a->max_err = e;
+  }
+}
+
+typedef struct {
+  const trace_t *traces;
+  size_t ntrace;
+  const point_t *points;
+  size_t npoint;
+  _Atomic size_t next;    /* siradaki (nokta, iz) cifti */
+} work_t;
+
+typedef struct {
+  work_t *w;
+  acc_t *acc;             /* npoint, bu thread'in toplamlari */
+  pthread_t th;
+} worker_t;
+
+#define WORK_CHUNK 16
+
+static void *worker_main(void *arg) {
+  worker_t *wk = (worker_t*)arg;
+  work_t *w = wk->w;
+  const size_t total = w->npoint * w->ntrace;
+  for (;;) {
+    const size_t u0 = atomic_fetch_add_explicit(&w->next, WORK_CHUNK, memory_order_relaxed);
+    if (u0 >= total) break;
+    const size_t u1 = (u0 + WORK_CHUNK < total) ? u0 + WORK_CHUNK : total;
+    for (size_t u = u0; u < u1; u++) {
+      const size_t p = u / w->ntrace;
+      run_one(&w->points[p].cfg, &w->traces[u % w->ntrace], &wk->acc[p]);
+    }
+  }
+  return NULL;
+}
+
+/* "a,b,c" ya da "bas:son:adim". Donus: deger sayisi ya da -EINVAL */
+static int parse_list(const char *s, double *out, int max) {
+  double lo, hi, step;
+  char tail;
+  if (sscanf(s, "%lf:%lf:%lf%c", &lo, &hi, &step, &tail) == 3) {
+    if (step <= 0 || hi < lo) return -EINVAL;
+    int n = 0;
+    for (double x = lo; x <= hi + step * 1e-6 && n < max; x += step) out[n++] = x;
+    return n;
+  }
+  int n = 0;
+  const char *p = s;
+  while (*p && n < max) {
+    char *end;
+    out[n++] = strtod(p, &end);
+    if (end == p) return -EINVAL;
+    p = end;
+    if (*p == ',') p++;
+    else if (*p) return -EINVAL;
+  }
+  return n ? n : -EINVAL;
+}
+
+static int cmp_point(const void *a, const void *b) {
+  const point_t *x = (const point_t*)a, *y = (const point_t*)b;
+  const double mx = x->acc.n ? x->acc.abs_sum / (double)x->acc.n : INFINITY;
+  const double my = y->acc.n ? y->acc.abs_sum / (double)y->acc.n : INFINITY;
+  if (mx != my) return (mx < my) ? -1 : 1;
+  return (x->acc.steps > y->acc.steps) - (x->acc.steps < y->acc.steps);
+}
+
+static void print_point(const point_t *p, int rank, int json) {
+  const acc_t *a = &p->acc;
+  const double mae = a->n ? a->abs_sum / (double)a->n : NAN;
+  const double rmse = a->n ? sqrt(a->sq_sum / (double)a->n) : NAN;
+  const bq25792_socfilt_config_t *c = &p->cfg;
+  if (json) {
+    /* referans ornegi yoksa hata alanlari null */
+    char e[64] = "\"mae\":null,\"rmse\":null";
+    if (a->n) snprintf(e, sizeof(e), "\"mae\":%.3f,\"rmse\":%.3f", mae, rmse);
+    printf("{\"rank\":%d,\"alpha\":%.4f,\"step_sec\":%d,\"stable_chg\":%d,\"stable_dis\":%d,\"big_jump\":%d,"
+           "\"default\":%s,\"n\":%llu,%s,\"max_err\":%.1f,\"steps\":%llu}\n",
+           rank, (double)c->alpha, c->min_step_ms / 1000, c->stable_chg, c->stable_dis, c->big_jump,
+           p->is_default ? "true" : "false", (unsigned long long)a->n, e, (double)a->max_err,
+           (unsigned long long)a->steps);
+  } else {
+    printf("%d,%.4f,%d,%d,%d,%d,%d,%llu,%.3f,%.3f,%.1f,%llu\n",
+           rank, (double)c->alpha, c->min_step_ms / 1000, c->stable_chg, c->stable_dis, c->big_jump,
+           p->is_default, (unsigned long long)a->n, mae, rmse, (double)a->max_err,
+           (unsigned long long)a->steps);
+  }
+}
+
+static void print_usage(const char *argv0) {
+  fprintf(stderr,
+    "Usage: %s [--alpha L] [--step-sec L] [--stable-chg L] [--stable-dis L] [--big-jump L]\n"
+    "          [--cells N] [--capacity MAH] [--max-gap-sec N] [--jobs N] [--top N] [--json] IZ...\n"
+    "  IZ: bqctl history CSV'si (ts_ms,vbat_mv,ibat_ma[,chg_stat,cell_count,soc_ref]) ya da history.db\n"
+    "  L : \"0.1,0.15,0.2\" ya da \"0.05:0.3:0.05\" (varsayilan: filtre varsayilani)\n"
+    "  Referans: soc_ref kolonu, yoksa iz uzerinde coulomb counter (ilk kalibrasyondan sonra)\n"
+    "  Cikti: MAE'ye gore sirali izgara (CSV, --json ile NDJSON); varsayilan ayar hep dahil\n",
+    argv0);
+}
+
+int main(int argc, char **argv) {
+  bq25792_socfilt_config_t def;
+  bq25792_socfilt_config_default(&def);
+
+  double ax_alpha[MAX_AXIS] = { def.alpha };
+  double ax_step[MAX_AXIS] = { def.min_step_ms / 1000 };
+  double ax_chg[MAX_AXIS] = { def.stable_chg };
+  double ax_dis[MAX_AXIS] = { def.stable_dis };
+  double ax_jump[MAX_AXIS] = { def.big_jump };
+  int n_alpha = 1, n_step = 1, n_chg = 1, n_dis = 1, n_jump = 1;
+
+  load_cfg_t lc;
+  lc.cells = 1;
+  lc.max_gap_ms = 300 * 1000LL;
+  bq25792_cc_config_default(&lc.cc);
+  int jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  int top = 20;
+  int json = 0;
+
+  static const struct option long_opts[] = {
+    { "alpha",       required_argument, NULL, 'a' },
+    { "step-sec",    required_argument, NULL, 's' },
+    { "stable-chg",  required_argument, NULL, 'c' },
+    { "stable-dis",  required_argument, NULL, 'd' },
+    { "big-jump",    required_argument, NULL, 'b' },
+    { "cells",       required_argument, NULL, 'C' },
+    { "capacity",    required_argument, NULL, 'Q' },
+    { "max-gap-sec", required_argument, NULL, 'g' },
+    { "jobs",        required_argument, NULL, 'j' },
+    { "top",         required_argument, NULL, 'n' },
+    { "json",        no_argument,       NULL, 'J' },
+    { "help",        no_argument,       NULL, 'h' },
+    { NULL, 0, NULL, 0 }
+  };
+
+  int c, bad = 0;
+  while ((c = getopt_long(argc, argv, "a:s:c:d:b:C:Q:g:j:n:Jh", long_opts, NULL)) != -1) {
+    switch (c) {
+      case 'a': bad |= (n_alpha = parse_list(optarg, ax_alpha, MAX_AXIS)) < 0; break;
+      case 's': bad |= (n_step = parse_list(optarg, ax_step, MAX_AXIS)) < 0; break;
+      case 'c': bad |= (n_chg = parse_list(optarg, ax_chg, MAX_AXIS)) < 0; break;
+      case 'd': bad |= (n_dis = parse_list(optarg, ax_dis, MAX_AXIS)) < 0; break;
+      case 'b': bad |= (n_jump = parse_list(optarg, ax_jump, MAX_AXIS)) < 0; break;
+      case 'C': lc.cells = (int)strtol(optarg, NULL, 0); break;
+      case 'Q': lc.cc.design_capacity_mah = strtof(optarg, NULL); break;
+      case 'g': lc.max_gap_ms = strtoll(optarg, NULL, 0) * 1000LL; break;
+      case 'j': jobs = (int)strtol(optarg, NULL, 0); break;
+      case 'n': top = (int)strtol(optarg, NULL, 0); break;
+      case 'J': json = 1; break;
+      case 'h':
+      default:
+        print_usage(argv[0]);
+        return 2;
+    }
+  }
+  if (bad || optind >= argc || lc.cells < 1 || lc.cells > 4) {
+    print_usage(argv[0]);
+    return 2;
+  }
+  if (jobs < 1) jobs = 1;
+  /* iz seyrek olabilir (history 1-60 s): cc ornekleri max-gap'e kadar entegre eder */
+  lc.cc.max_gap_ms = (int)lc.max_gap_ms;
+
+  /* izler */
+  const size_t ntrace = (size_t)(argc - optind);
+  trace_t *traces = calloc(ntrace, sizeof(*traces));
+  if (!traces) return 1;
+  size_t nsamples = 0;
+  const long long t_load = mono_ns();
+  for (size_t i = 0; i < ntrace; i++) {
+    int rc = load_trace(&traces[i], argv[optind + (int)i], &lc);
+    if (rc) {
+      fprintf(stderr, "bq25792_replay: %s okunamadi: %s\n", argv[optind + (int)i], strerror(-rc));
+      return 1;
+    }
+    nsamples += traces[i].n;
+  }
+  const long long t_grid = mono_ns();
+
+  /* izgara: varsayilan ayar her zaman ilk nokta (karsilastirma icin) */
+  const size_t ngrid = (size_t)n_alpha * n_step * n_chg * n_dis * n_jump;
+  point_t *points = calloc(ngrid + 1, sizeof(*points));
+  if (!points) return 1;
+  size_t npoint = 0;
+  points[npoint].cfg = def;
+  points[npoint++].is_default = 1;
+  for (int ia = 0; ia < n_alpha; ia++)
+  for (int is = 0; is < n_step; is++)
+  for (int ic = 0; ic < n_chg; ic++)
+  for (int id = 0; id < n_dis; id++)
+  for (int ij = 0; ij < n_jump; ij++) {
+    bq25792_socfilt_config_t cfg = def;
+    cfg.alpha = (float)ax_alpha[ia];
+    cfg.min_step_ms = (int)lround(ax_step[is] * 1000.0);
+    cfg.stable_chg = (int)lround(ax_chg[ic]);
+    cfg.stable_dis = (int)lround(ax_dis[id]);
+    cfg.big_jump = (int)lround(ax_jump[ij]);
+    if (memcmp(&cfg, &def, sizeof(cfg)) == 0) continue;
+    points[npoint++].cfg = cfg;
+  }
+
+  work_t w;
+  w.traces = traces;
+  w.ntrace = ntrace;
+  w.points = points;
+  w.npoint = npoint;
+  atomic_init(&w.next, 0);
+  if ((size_t)jobs > npoint * ntrace) jobs = (int)(npoint * ntrace);
+
+  worker_t *wk = calloc((size_t)jobs, sizeof(*wk));
+  acc_t *accs = calloc((size_t)jobs * npoint, sizeof(*accs));
+  if (!wk || !accs) return 1;
+  int started = 0;
+  for (int j = 0; j < jobs; j++) {
+    wk[j].w = &w;
+    wk[j].acc = &accs[(size_t)j * npoint];
+    if (j > 0 && pthread_create(&wk[j].th, NULL, worker_main, &wk[j]) != 0) break;
+    started = j + 1;
+  }
+  worker_main(&wk[0]);   /* ana thread de calisir */
+  for (int j = 1; j < started; j++) pthread_join(wk[j].th, NULL);
+
+  for (int j = 0; j < started; j++) {
+    for (size_t p = 0; p < npoint; p++) {
+      const acc_t *a = &wk[j].acc[p];
+      acc_t *t = &points[p].acc;
+      t->n += a->n;
+      t->steps += a->steps;
+      t->abs_sum += a->abs_sum;
+      t->sq_sum += a->sq_sum;
+      if (a->max_err > t->max_err) t->max_err = a->max_err;
+    }
+  }
+  const long long t_done = mono_ns();
+
+  qsort(points, npoint, sizeof(*points), cmp_point);
+  if (!json) printf("rank,alpha,step_sec,stable_chg,stable_dis,big_jump,default,n,mae,rmse,max_err,steps\n");
+  for (size_t p = 0; p < npoint; p++) {
+    /* varsayilan ayar ilk top icinde degilse yine de basilir */
+    if ((int)p < top || points[p].is_default) print_point(&points[p], (int)p + 1, json);
+  }
+
+  const double run_s = (double)(t_done - t_grid) / 1e9;
+  fprintf(stderr, "bq25792_replay: %zu iz, %zu ornek, %zu nokta, %d thread; yukleme %.2f s, "
+          "izgara %.2f s (%.0f M ornek/s)\n",
+          ntrace, nsamples, npoint, started, (double)(t_grid - t_load) / 1e9, run_s,
+          run_s > 0 ? (double)nsamples * (double)npoint / run_s / 1e6 : 0.0);
+
+  for (size_t i = 0; i < ntrace; i++) trace_free(&traces[i]);
+  free(traces);
+  free(points);
+  free(accs);
+  free(wk);
+  return 0;
+}
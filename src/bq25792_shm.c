@@ -0,0 +1,179 @@
+#include "bq25792_shm.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Segment header'i. Alan sirasi/boyutu ABI'dir: degisirse versiyon artar. */
+typedef struct {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t header_size;
+  uint32_t payload_size;     /* sizeof(bq25792_snapshot_t) */
+  _Atomic uint32_t seq;      /* tek: yazim suruyor, 0: henuz yayin yok */
+  uint64_t publish_count;
+} shm_header_t;
+
+typedef struct {
+  shm_header_t hdr;
+  alignas(64) bq25792_snapshot_t snap;
+} shm_layout_t;
+
+struct bq25792_shm {
+  shm_layout_t *map;
+  int writer;
+};
+
+#define READ_SPIN_MAX 1000
+
+int bq25792_shm_create(bq25792_shm_t **out, const char *path) {
+  if (!out || !path) return -EINVAL;
+  *out = NULL;
+
+  int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) return -errno;
+
+  if (ftruncate(fd, sizeof(shm_layout_t)) < 0) {
+    int e = -errno;
+    close(fd);
+    return e;
+  }
+
+  void *p = mmap(NULL, sizeof(shm_layout_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  int e = -errno;
+  close(fd);
+  if (p == MAP_FAILED) return e;
+
+  bq25792_shm_t *shm = (bq25792_shm_t*)calloc(1, sizeof(*shm));
+  if (!shm) {
+    munmap(p, sizeof(shm_layout_t));
+    return -ENOMEM;
+  }
+  shm->map = (shm_layout_t*)p;
+  shm->writer = 1;
+
+  shm_header_t *h = &shm->map->hdr;
+  const uint32_t seq = atomic_load_explicit(&h->seq, memory_order_relaxed);
+  if (h->magic != BQ25792_SHM_MAGIC || h->version != BQ25792_SHM_VERSION ||
+      h->header_size != sizeof(shm_header_t) || h->payload_size != sizeof(bq25792_snapshot_t) ||
+      (seq & 1u)) {
+    /* Yeni ya da uyumsuz segment: okuyuculara "yayin yok" gorunecek sekilde sifirla */
+    atomic_store_explicit(&h->seq, 0, memory_order_relaxed);
+    h->magic = 0;
+    atomic_thread_fence(memory_order_release);
+    memset(&shm->map->snap, 0, sizeof(shm->map->snap));
+    h->version = BQ25792_SHM_VERSION;
+    h->header_size = sizeof(shm_header_t);
+    h->payload_size = sizeof(bq25792_snapshot_t);
+    h->publish_count = 0;
+    atomic_thread_fence(memory_order_release);
+    h->magic = BQ25792_SHM_MAGIC;
+  }
+
+  *out = shm;
+  return 0;
+}
+
+int bq25792_shm_publish(bq25792_shm_t *shm, const bq25792_snapshot_t *snap) {
+  if (!shm || !snap || !shm->writer) return -EINVAL;
+  shm_header_t *h = &shm->map->hdr;
+
+  const uint32_t seq = atomic_load_explicit(&h->seq, memory_order_relaxed);
+  atomic_store_explicit(&h->seq, seq + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+
+  memcpy(&shm->map->snap, snap, sizeof(*snap));
+  h->publish_count++;
+
+  atomic_store_explicit(&h->seq, seq + 2, memory_order_release);
+  return 0;
+}
+
+int bq25792_shm_open(bq25792_shm_t **out, const char *path) {
+  if (!out || !path) return -EINVAL;
+  *out = NULL;
+
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return -errno;
+
+  struct stat sb;
+  if (fstat(fd, &sb) < 0) {
+    int e = -errno;
+    close(fd);
+    return e;
+  }
+  if ((size_t)sb.st_size < sizeof(shm_layout_t)) {
+    close(fd);
+    return -EPROTO;
+  }
+
+  void *p = mmap(NULL, sizeof(shm_layout_t), PROT_READ, MAP_SHARED, fd, 0);
+  int e = -errno;
+  close(fd);
+  if (p == MAP_FAILED) return e;
+
+  const shm_header_t *h = &((const shm_layout_t*)p)->hdr;
+  if (h->magic != BQ25792_SHM_MAGIC || h->version != BQ25792_SHM_VERSION ||
+      h->header_size != sizeof(shm_header_t) || h->payload_size != sizeof(bq25792_snapshot_t)) {
+    munmap(p, sizeof(shm_layout_t));
+    return -EPROTO;
+  }
+
+  bq25792_shm_t *shm = (bq25792_shm_t*)calloc(1, sizeof(*shm));
+  if (!shm) {
+    munmap(p, sizeof(shm_layout_t));
+    return -ENOMEM;
+  }
+  shm->map = (shm_layout_t*)p;
+  shm->writer = 0;
+
+  *out = shm;
+  return 0;
+}
+
+const bq25792_snapshot_t* bq25792_shm_data(const bq25792_shm_t *shm) {
+  return shm ? &shm->map->snap : NULL;
+}
+
+uint32_t bq25792_shm_read_begin(const bq25792_shm_t *shm) {
+  uint32_t s;
+  while ((s = atomic_load_explicit(&shm->map->hdr.seq, memory_order_acquire)) & 1u) {
+    sched_yield();
+  }
+  return s;
+}
+
+bool bq25792_shm_read_retry(const bq25792_shm_t *shm, uint32_t seq) {
+  atomic_thread_fence(memory_order_acquire);
+  return atomic_load_explicit(&shm->map->hdr.seq, memory_order_relaxed) != seq;
+}
+
+int bq25792_shm_read(bq25792_shm_t *shm, bq25792_snapshot_t *snap) {
+  if (!shm || !snap) return -EINVAL;
+  const shm_header_t *h = &shm->map->hdr;
+
+  for (int i = 0; i < READ_SPIN_MAX; i++) {
+    const uint32_t s1 = atomic_load_explicit(&h->seq, memory_order_acquire);
+    if (s1 == 0) return -ENODATA;
+    if (s1 & 1u) continue;
+
+    memcpy(snap, &shm->map->snap, sizeof(*snap));
+
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&h->seq, memory_order_relaxed) == s1) return 0;
+  }
+  return -EBUSY;
+}
+
+void bq25792_shm_close(bq25792_shm_t *shm) {
+  if (!shm) return;
+  if (shm->map) munmap(shm->map, sizeof(shm_layout_t));
+  free(shm);
+}
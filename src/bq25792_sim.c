@@ -0,0 +1,492 @@
+#include "bq25792_sim.h"
+#include "bq25792_transport.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Register dosyasi REG00..REG48 */
+#define SIM_NREGS          0x49
+
+enum {
+  R0A_RECHG_CTRL   = 0x0A,
+  R0F_CHG_CTRL_0   = 0x0F,  /* EN_CHG bit5 */
+  R10_CHG_CTRL_1   = 0x10,  /* WD_RST bit3, WATCHDOG 2:0 */
+  R14_CHG_CTRL_5   = 0x14,  /* EN_IBAT bit5 */
+  R1B_STATUS_0     = 0x1B,
+  R1C_STATUS_1     = 0x1C,
+  R1D_STATUS_2     = 0x1D,
+  R1E_STATUS_3     = 0x1E,
+  R20_FAULT_0      = 0x20,
+  R21_FAULT_1      = 0x21,
+  R22_FLAG_0       = 0x22,
+  R23_FLAG_1       = 0x23,
+  R24_FLAG_2       = 0x24,
+  R27_FFLAG_1      = 0x27,
+  R2E_ADC_CTRL     = 0x2E,
+  R2F_ADC_DIS_0    = 0x2F,
+  R30_ADC_DIS_1    = 0x30,
+  R31_IBUS         = 0x31,
+  R33_IBAT         = 0x33,
+  R35_VBUS         = 0x35,
+  R37_VAC1         = 0x37,
+  R39_VAC2         = 0x39,
+  R3B_VBAT         = 0x3B,
+  R3D_VSYS         = 0x3D,
+  R3F_TS           = 0x3F,
+  R41_TDIE         = 0x41,
+  R43_DP           = 0x43,
+  R45_DM           = 0x45,
+  R48_PART_INFO    = 0x48,
+};
+
+/* Sadece okunur bolgeler: status/flag (REG1B..REG27), ADC sonuclari ve part info */
+static bool reg_read_only(uint8_t reg) {
+  return (reg >= R1B_STATUS_0 && reg <= R27_FFLAG_1) || (reg >= R31_IBUS && reg < SIM_NREGS);
+}
+
+/* POR degerleri (datasheet), hucre sayisi config'den */
+static const uint8_t por_regs[SIM_NREGS] = {
+  [R0F_CHG_CTRL_0] = 0xA2,
+  [R10_CHG_CTRL_1] = 0x85,  /* WATCHDOG=40s */
+  [R14_CHG_CTRL_5] = 0x16,  /* EN_IBAT=0 */
+  [R2E_ADC_CTRL]   = 0x30,  /* ADC kapali, 12-bit */
+  [R48_PART_INFO]  = 0x19,  /* PN=BQ25792, rev 1 */
+};
+
+#define ADC_EN            (1u << 7)
+#define ADC_ONESHOT       (1u << 6)
+#define ADC_DONE_STAT     (1u << 5)   /* REG1E */
+#define ADC_DONE_FLAG     (1u << 5)   /* REG24 */
+#define ADC_CHANNELS      11
+
+static const int adc_conv_ms[4] = { 24, 12, 6, 3 };
+static const double wd_period_s[8] = { 0, 0.5, 1, 2, 20, 40, 80, 160 };
+
+/* Fizik modeli adim boyu (sim zamani) ve verim/termal sabitler */
+#define SIM_MAX_STEP_S    1.0
+#define SIM_EFF           0.92
+#define SIM_THETA_C_PER_W 40.0
+#define SIM_TAU_S         30.0
+#define SIM_VSYSMIN_CELL  3500
+#define SIM_VRECHG_MV     200
+#define SIM_VBUS_MIN_MV   3600
+#define SIM_PRECHG_CELL   3000
+
+struct bq25792_sim {
+  bq25792_sim_config_t cfg;
+  uint8_t reg[SIM_NREGS];
+
+  int64_t t0_ns;          /* CLOCK_MONOTONIC referansi */
+  double t_s;             /* simulasyon zamani */
+  double next_plug_s;
+  int vbus_mv;            /* guncel adaptor voltaji */
+
+  /* pil / guc yolu durumu */
+  double q_mah;
+  double vbat_mv, ibat_ma, vsys_mv, ibus_ma, tdie_c;
+  int chg_stat;
+  bool done;
+  bool iindpm;
+
+  /* ADC */
+  double adc_start_s;     /* <0: calismiyor */
+  double wd_start_s;
+
+  uint32_t noise;         /* ADC gurultusu icin LCG */
+};
+
+static int64_t mono_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/* Hucre OCV egrisi (bq25792_soc_from_vcell_mv tablosunun tersi) */
+static double ocv_cell_mv(double soc_pct) {
+  static const double mv[]  = { 3300, 3400, 3500, 3600, 3650, 3700, 3800, 3900, 4000, 4100, 4200 };
+  if (soc_pct <= 0) return mv[0];
+  if (soc_pct >= 100) return mv[10];
+  const int i = (int)(soc_pct / 10.0);
+  const double x = (soc_pct - i * 10.0) / 10.0;
+  return mv[i] + (mv[i + 1] - mv[i]) * x;
+}
+
+static double soc_pct(const bq25792_sim_t *s) {
+  return (s->cfg.capacity_mah > 0) ? 100.0 * s->q_mah / s->cfg.capacity_mah : 0.0;
+}
+
+static int noise(bq25792_sim_t *s, int amp) {
+  s->noise = s->noise * 1664525u + 1013904223u;
+  return (int)((s->noise >> 16) % (uint32_t)(2 * amp + 1)) - amp;
+}
+
+static void put_u16(bq25792_sim_t *s, uint8_t reg, int v) {
+  const uint16_t u = (uint16_t)(int16_t)v;
+  s->reg[reg] = (uint8_t)(u >> 8);
+  s->reg[reg + 1] = (uint8_t)u;
+}
+
+static void set_bit(uint8_t *r, uint8_t bit, bool on) {
+  if (on) *r |= bit; else *r &= (uint8_t)~bit;
+}
+
+/* Durum registerlarini model durumundan uret, degisen alanlar icin flag set et */
+static void update_status(bq25792_sim_t *s) {
+  const bool vbus = s->vbus_mv >= SIM_VBUS_MIN_MV;
+  const uint8_t s0_old = s->reg[R1B_STATUS_0];
+  const uint8_t s1_old = s->reg[R1C_STATUS_1];
+
+  uint8_t s0 = s0_old & (1u << 5); /* WD_STAT watchdog tarafindan yonetilir */
+  set_bit(&s0, 1u << 7, s->iindpm);
+  set_bit(&s0, 1u << 3, vbus);      /* PG */
+  set_bit(&s0, 1u << 1, vbus);      /* AC1_PRESENT */
+  set_bit(&s0, 1u << 0, vbus);      /* VBUS_PRESENT */
+  s->reg[R1B_STATUS_0] = s0;
+
+  const uint8_t vbus_stat = vbus ? 0x3 : 0x0; /* DCP */
+  s->reg[R1C_STATUS_1] = (uint8_t)(((s->chg_stat & 0x7) << 5) | (vbus_stat << 1) | (vbus ? 1 : 0));
+  s->reg[R1D_STATUS_2] = 0x01;      /* VBAT_PRESENT */
+
+  const uint8_t d0 = s0 ^ s0_old;
+  if (d0 & (1u << 7) && (s0 & (1u << 7))) s->reg[R22_FLAG_0] |= 1u << 7;
+  if (d0 & (1u << 3)) s->reg[R22_FLAG_0] |= 1u << 3;
+  if (d0 & (1u << 1)) s->reg[R22_FLAG_0] |= 1u << 1;
+  if (d0 & (1u << 0)) s->reg[R22_FLAG_0] |= 1u << 0;
+
+  const uint8_t d1 = s->reg[R1C_STATUS_1] ^ s1_old;
+  if (d1 & 0xE0) s->reg[R23_FLAG_1] |= 1u << 7; /* CHG_FLAG */
+  if (d1 & 0x1E) s->reg[R23_FLAG_1] |= 1u << 4; /* VBUS_FLAG */
+  if ((d1 & 0x01) && vbus) s->reg[R23_FLAG_1] |= 1u << 0; /* BC1.2_DONE_FLAG */
+
+  const bool tshut = s->tdie_c >= 150.0;
+  const bool tshut_old = s->reg[R21_FAULT_1] & (1u << 2);
+  set_bit(&s->reg[R21_FAULT_1], 1u << 2, tshut);
+  if (tshut && !tshut_old) s->reg[R27_FFLAG_1] |= 1u << 2;
+}
+
+/* Guc yolu ve pil: dt saniyelik adim */
+static void physics_step(bq25792_sim_t *s, double dt) {
+  const bq25792_sim_config_t *c = &s->cfg;
+  const int n = c->cells;
+  const double r_ohm = c->r_int_mohm / 1000.0;
+  const double ocv = n * ocv_cell_mv(soc_pct(s));
+  const double vsysmin = n * SIM_VSYSMIN_CELL;
+  const bool vbus = s->vbus_mv >= SIM_VBUS_MIN_MV;
+  const bool en_chg = s->reg[R0F_CHG_CTRL_0] & (1u << 5);
+
+  double ibat = 0;
+  int stat = 0;
+  s->iindpm = false;
+
+  if (vbus) {
+    const double vreg = (double)n * c->vreg_mv_cell;
+    if (s->done && ocv < vreg - n * SIM_VRECHG_MV) s->done = false;
+
+    if (en_chg && !s->done) {
+      if (ocv / n < SIM_PRECHG_CELL) {
+        ibat = c->ichg_ma / 10.0;
+        stat = 2;
+      } else if (ocv + c->ichg_ma * r_ohm < vreg) {
+        ibat = c->ichg_ma;
+        stat = 3;
+      } else {
+        ibat = (vreg - ocv) / r_ohm;
+        stat = 4;
+        if (ibat < c->iterm_ma) {
+          s->done = true;
+          ibat = 0;
+        }
+      }
+    }
+    if (s->done) stat = 7;
+
+    double vbat = ocv + ibat * r_ohm;
+    double vsys = (vbat < vsysmin) ? vsysmin + 200 : vbat + 50;
+    double pin_mw = (vbat * ibat + vsys * c->load_ma) / 1000.0 / SIM_EFF;
+    double ibus = pin_mw * 1000.0 / s->vbus_mv;
+    if (ibus > c->iin_lim_ma) {
+      /* IINDPM: sarj akimi duser, gerekirse pil sistemi destekler */
+      s->iindpm = true;
+      const double avail_mw = c->iin_lim_ma * (double)s->vbus_mv / 1000.0 * SIM_EFF;
+      ibat = (avail_mw * 1000.0 - vsys * c->load_ma) / vbat;
+      vbat = ocv + ibat * r_ohm;
+      ibus = c->iin_lim_ma;
+      pin_mw = ibus * s->vbus_mv / 1000.0;
+    }
+    s->vbat_mv = vbat;
+    s->vsys_mv = vsys;
+    s->ibus_ma = ibus;
+
+    const double loss_w = pin_mw * (1.0 - SIM_EFF) / 1000.0;
+    const double target = c->ambient_c + loss_w * SIM_THETA_C_PER_W;
+    s->tdie_c += (target - s->tdie_c) * (1.0 - exp(-dt / SIM_TAU_S));
+  } else {
+    s->done = false;
+    ibat = -(double)c->load_ma;
+    s->vbat_mv = ocv + ibat * r_ohm;
+    s->vsys_mv = s->vbat_mv;
+    s->ibus_ma = 0;
+    s->tdie_c += (c->ambient_c - s->tdie_c) * (1.0 - exp(-dt / SIM_TAU_S));
+  }
+
+  s->ibat_ma = ibat;
+  s->chg_stat = stat;
+  s->q_mah += ibat * dt / 3600.0;
+  if (s->q_mah < 0) s->q_mah = 0;
+  if (s->q_mah > c->capacity_mah) s->q_mah = c->capacity_mah;
+}
+
+static int adc_enabled_channels(const bq25792_sim_t *s) {
+  int dis = 0;
+  for (int b = 1; b <= 7; b++) dis += (s->reg[R2F_ADC_DIS_0] >> b) & 1;
+  for (int b = 4; b <= 7; b++) dis += (s->reg[R30_ADC_DIS_1] >> b) & 1;
+  return ADC_CHANNELS - dis;
+}
+
+static double adc_cycle_s(const bq25792_sim_t *s) {
+  const int sample = (s->reg[R2E_ADC_CTRL] >> 4) & 0x3;
+  int ch = adc_enabled_channels(s);
+  if (ch < 1) ch = 1;
+  return ch * adc_conv_ms[sample] / 1000.0;
+}
+
+/* Bir conversion dongusu tamamlandi: etkin kanallarin sonuclarini yaz */
+static void adc_latch(bq25792_sim_t *s) {
+  const uint8_t d0 = s->reg[R2F_ADC_DIS_0];
+  const uint8_t d1 = s->reg[R30_ADC_DIS_1];
+  const bool vbus = s->vbus_mv >= SIM_VBUS_MIN_MV;
+  const bool en_ibat = s->reg[R14_CHG_CTRL_5] & (1u << 5);
+
+  if (!(d0 & (1u << 7))) put_u16(s, R31_IBUS, vbus ? (int)lround(s->ibus_ma) + noise(s, 3) : 0);
+  if (!(d0 & (1u << 6))) {
+    /* desarj akimi sadece EN_IBAT=1 iken olculur */
+    int ibat = (int)lround(s->ibat_ma) + noise(s, 3);
+    if (s->ibat_ma < 0 && !en_ibat) ibat = 0;
+    put_u16(s, R33_IBAT, ibat);
+  }
+  if (!(d0 & (1u << 5))) put_u16(s, R35_VBUS, vbus ? s->vbus_mv + noise(s, 5) : 0);
+  if (!(d0 & (1u << 4))) put_u16(s, R3B_VBAT, (int)lround(s->vbat_mv) + noise(s, 2));
+  if (!(d0 & (1u << 3))) put_u16(s, R3D_VSYS, (int)lround(s->vsys_mv) + noise(s, 2));
+  if (!(d0 & (1u << 2))) put_u16(s, R3F_TS, 512);  /* ~%50, 10k NTC oda sicakligi */
+  if (!(d0 & (1u << 1))) put_u16(s, R41_TDIE, (int)lround(s->tdie_c * 2.0));
+  if (!(d1 & (1u << 7))) put_u16(s, R43_DP, 0);
+  if (!(d1 & (1u << 6))) put_u16(s, R45_DM, 0);
+  if (!(d1 & (1u << 5))) put_u16(s, R39_VAC2, 0);
+  if (!(d1 & (1u << 4))) put_u16(s, R37_VAC1, vbus ? s->vbus_mv : 0);
+}
+
+static void adc_advance(bq25792_sim_t *s) {
+  if (!(s->reg[R2E_ADC_CTRL] & ADC_EN) || s->adc_start_s < 0) return;
+  const double cyc = adc_cycle_s(s);
+  if (s->t_s < s->adc_start_s + cyc) return;
+
+  adc_latch(s);
+  if (s->reg[R2E_ADC_CTRL] & ADC_ONESHOT) {
+    s->reg[R2E_ADC_CTRL] &= (uint8_t)~ADC_EN;
+    s->reg[R1E_STATUS_3] |= ADC_DONE_STAT;
+    s->reg[R24_FLAG_2] |= ADC_DONE_FLAG;
+    s->adc_start_s = -1;
+  } else {
+    s->adc_start_s += cyc * floor((s->t_s - s->adc_start_s) / cyc);
+  }
+}
+
+static void watchdog_advance(bq25792_sim_t *s) {
+  const double per = wd_period_s[s->reg[R10_CHG_CTRL_1] & 0x7];
+  if (per <= 0 || s->t_s - s->wd_start_s < per) return;
+
+  /* Suresi doldu: WD_STAT/WD_FLAG, registerlar (ADC, EN_IBAT) POR degerine doner */
+  s->reg[R1B_STATUS_0] |= 1u << 5;
+  s->reg[R22_FLAG_0] |= 1u << 5;
+  s->reg[R14_CHG_CTRL_5] = por_regs[R14_CHG_CTRL_5];
+  s->reg[R2E_ADC_CTRL] = por_regs[R2E_ADC_CTRL];
+  s->adc_start_s = -1;
+  s->wd_start_s = s->t_s;
+}
+
+/* Model zamanini gercek zamana (x speed) getir */
+static void advance(bq25792_sim_t *s) {
+  const double t = (double)(mono_ns() - s->t0_ns) * 1e-9 * s->cfg.speed;
+  while (s->t_s < t) {
+    double dt = t - s->t_s;
+    if (dt > SIM_MAX_STEP_S) dt = SIM_MAX_STEP_S;
+    if (s->cfg.plug_period_s > 0 && s->t_s + dt >= s->next_plug_s) {
+      dt = s->next_plug_s - s->t_s;
+      if (dt < 0) dt = 0;
+    }
+    physics_step(s, dt);
+    s->t_s += dt;
+
+    if (s->cfg.plug_period_s > 0 && s->t_s >= s->next_plug_s) {
+      s->vbus_mv = (s->vbus_mv >= SIM_VBUS_MIN_MV) ? 0 : (s->cfg.vbus_mv > 0 ? s->cfg.vbus_mv : 5000);
+      s->next_plug_s += s->cfg.plug_period_s;
+    }
+    update_status(s);
+    watchdog_advance(s);
+    adc_advance(s);
+  }
+}
+
+static int sim_read_block(void *ctx, uint8_t reg, uint8_t *buf, size_t len) {
+  bq25792_sim_t *s = (bq25792_sim_t*)ctx;
+  advance(s);
+  for (size_t i = 0; i < len; i++) {
+    const size_t r = (size_t)reg + i;
+    buf[i] = (r < SIM_NREGS) ? s->reg[r] : 0;
+  }
+  /* REG22..REG27 okununca temizlenir */
+  for (size_t i = 0; i < len; i++) {
+    const size_t r = (size_t)reg + i;
+    if (r >= R22_FLAG_0 && r <= R27_FFLAG_1) s->reg[r] = 0;
+  }
+  return 0;
+}
+
+static int sim_read_u8(void *ctx, uint8_t reg, uint8_t *val) {
+  return sim_read_block(ctx, reg, val, 1);
+}
+
+static int sim_write_u8(void *ctx, uint8_t reg, uint8_t val) {
+  bq25792_sim_t *s = (bq25792_sim_t*)ctx;
+  advance(s);
+  if (reg >= SIM_NREGS) return -EIO;
+  if (reg_read_only(reg)) return 0;
+
+  if (reg == R10_CHG_CTRL_1) {
+    if (val & (1u << 3)) {
+      s->wd_start_s = s->t_s;
+      s->reg[R1B_STATUS_0] &= (uint8_t)~(1u << 5);
+    }
+    val &= (uint8_t)~(1u << 3); /* WD_RST kendiliginden temizlenir */
+    if ((val & 0x7) != (s->reg[reg] & 0x7)) s->wd_start_s = s->t_s;
+  }
+
+  if (reg == R2E_ADC_CTRL) {
+    /* Yeni conversion: ADC_EN yazildiysa dongu bastan baslar */
+    if (val & ADC_EN) {
+      if (!(s->reg[reg] & ADC_EN) || ((val ^ s->reg[reg]) & 0x70)) {
+        s->adc_start_s = s->t_s;
+        s->reg[R1E_STATUS_3] &= (uint8_t)~ADC_DONE_STAT;
+      }
+    } else {
+      s->adc_start_s = -1;
+    }
+  }
+
+  s->reg[reg] = val;
+  return 0;
+}
+
+static void sim_close(void *ctx) {
+  free(ctx);
+}
+
+static const bq25792_transport_ops_t sim_ops = {
+  .name = "sim",
+  .read_u8 = sim_read_u8,
+  .write_u8 = sim_write_u8,
+  .read_block = sim_read_block,
+  .close = sim_close,
+};
+
+void bq25792_sim_config_default(bq25792_sim_config_t *c) {
+  memset(c, 0, sizeof(*c));
+  c->cells = 2;
+  c->capacity_mah = 3000.0f;
+  c->soc0_pct = 50.0f;
+  c->r_int_mohm = 80.0f;
+  c->ichg_ma = 1000;
+  c->iterm_ma = 100;
+  c->vreg_mv_cell = 4200;
+  c->vbus_mv = 5000;
+  c->iin_lim_ma = 3000;
+  c->load_ma = 300;
+  c->ambient_c = 25.0f;
+  c->speed = 1.0f;
+  c->plug_period_s = 0;
+}
+
+static int env_i(const char *name, int defv) {
+  const char *v = getenv(name);
+  return (v && *v) ? (int)strtol(v, NULL, 0) : defv;
+}
+
+static float env_f(const char *name, float defv) {
+  const char *v = getenv(name);
+  return (v && *v) ? strtof(v, NULL) : defv;
+}
+
+void bq25792_sim_config_from_env(bq25792_sim_config_t *c) {
+  bq25792_sim_config_default(c);
+  c->cells = env_i("BQ_SIM_CELLS", c->cells);
+  c->capacity_mah = env_f("BQ_SIM_CAPACITY_MAH", c->capacity_mah);
+  c->soc0_pct = env_f("BQ_SIM_SOC", c->soc0_pct);
+  c->r_int_mohm = env_f("BQ_SIM_RINT_MOHM", c->r_int_mohm);
+  c->ichg_ma = env_i("BQ_SIM_ICHG_MA", c->ichg_ma);
+  c->iterm_ma = env_i("BQ_SIM_ITERM_MA", c->iterm_ma);
+  c->vbus_mv = env_i("BQ_SIM_VBUS_MV", c->vbus_mv);
+  c->iin_lim_ma = env_i("BQ_SIM_IIN_LIM_MA", c->iin_lim_ma);
+  c->load_ma = env_i("BQ_SIM_LOAD_MA", c->load_ma);
+  c->ambient_c = env_f("BQ_SIM_AMBIENT_C", c->ambient_c);
+  c->speed = env_f("BQ_SIM_SPEED", c->speed);
+  c->plug_period_s = env_i("BQ_SIM_PLUG_PERIOD_S", c->plug_period_s);
+}
+
+int bq25792_open_sim(bq25792_dev_t **out, const bq25792_sim_config_t *cfg, bq25792_sim_t **sim_out) {
+  if (!out) return -EINVAL;
+  *out = NULL;
+  if (sim_out) *sim_out = NULL;
+
+  bq25792_sim_config_t c;
+  if (cfg) c = *cfg; else bq25792_sim_config_default(&c);
+  if (c.cells < 1 || c.cells > 4 || c.capacity_mah <= 0 || c.r_int_mohm <= 0 || c.speed <= 0) return -EINVAL;
+
+  bq25792_sim_t *s = (bq25792_sim_t*)calloc(1, sizeof(*s));
+  if (!s) return -ENOMEM;
+  s->cfg = c;
+  memcpy(s->reg, por_regs, sizeof(s->reg));
+  s->reg[R0A_RECHG_CTRL] = (uint8_t)(((c.cells - 1) & 0x3) << 6) | 0x03;
+  s->t0_ns = mono_ns();
+  s->vbus_mv = c.vbus_mv;
+  s->next_plug_s = c.plug_period_s;
+  s->q_mah = c.capacity_mah * (c.soc0_pct < 0 ? 0 : c.soc0_pct > 100 ? 100 : c.soc0_pct) / 100.0;
+  s->tdie_c = c.ambient_c;
+  s->adc_start_s = -1;
+  s->noise = 0x2545F491u;
+  physics_step(s, 0);
+  update_status(s);
+  /* POR: flag'lar temiz baslar */
+  memset(&s->reg[R22_FLAG_0], 0, R27_FFLAG_1 - R22_FLAG_0 + 1);
+
+  int rc = bq25792_open_transport(out, &sim_ops, s, -1, 0x6B);
+  if (rc) {
+    free(s);
+    return rc;
+  }
+  if (sim_out) *sim_out = s;
+  return 0;
+}
+
+void bq25792_sim_set_vbus(bq25792_sim_t *s, int vbus_mv) {
+  advance(s);
+  s->vbus_mv = vbus_mv;
+  physics_step(s, 0);
+  update_status(s);
+}
+
+void bq25792_sim_set_load(bq25792_sim_t *s, int load_ma) {
+  advance(s);
+  s->cfg.load_ma = load_ma;
+  physics_step(s, 0);
+}
+
+float bq25792_sim_soc_pct(const bq25792_sim_t *s) {
+  return (float)soc_pct(s);
+}
+
+double bq25792_sim_time_s(const bq25792_sim_t *s) {
+  return s->t_s;
+}
@@ -0,0 +1,274 @@
+#include "bq25792.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char* jbool(bool v) { return v ? "true" : "false"; }
+
+int bq25792_snapshot_to_json(const bq25792_snapshot_t *snap, char *buf, size_t len) {
+  if (!snap || !buf) return -EINVAL;
+  const bq25792_status_t *st = &snap->st;
+
+  int n = snprintf(buf, len,
+    "{"
+      "\"ts_ms\":%lld,"
+      "\"trigger\":\"%s\","
+      "\"adc_valid\":%s,"
+      "\"bus\":%d,"
+      "\"addr\":\"0x%02x\","
+      "\"vbus_present\":%s,"
+      "\"pg\":%s,"
+      "\"chg_stat\":%u,"
+      "\"chg_stat_str\":\"%s\","
+      "\"vbus_stat\":%u,"
+      "\"vbus_stat_str\":\"%s\","
+      "\"fault_any\":%s,"
+      "\"fault0\":%u,"
+      "\"fault1\":%u,"
+      "\"chg_flag\":[%u,%u,%u,%u],"
+      "\"vbat_mv\":%d,"
+      "\"vsys_mv\":%d,"
+      "\"vbus_mv\":%d,"
+      "\"ibat_ma\":%d,"
+      "\"ibus_ma\":%d,"
+      "\"tdie_c\":%.1f,"
+      "\"cell_count\":%u,"
+      "\"soc_pct\":%d,"
+      "\"soc_raw\":%d,"
+      "\"soc_filt\":%.2f,"
+      "\"soc_cc_pct\":%.1f,"
+      "\"charge_mah\":%.0f,"
+      "\"capacity_mah\":%.0f,"
+      "\"sampler\":{"
+        "\"period_us\":%u,"
+        "\"jitter_max_us\":%u,"
+        "\"jitter_mean_us\":%u,"
+        "\"overruns\":%u,"
+        "\"drops\":%u"
+      "}"
+    "}\n",
+    (long long)snap->ts_ms,
+    (snap->trigger == BQ25792_TRIGGER_INT) ? "int" : (snap->trigger == BQ25792_TRIGGER_LIVE) ? "live" : "timer",
+    jbool(!snap->adc_pending),
+    (int)snap->bus,
+    snap->addr,
+    jbool(st->vbus_present),
+    jbool(st->pg),
+    st->chg_stat,
+    bq25792_chg_stat_str(st->chg_stat),
+    st->vbus_stat,
+    bq25792_vbus_stat_str(st->vbus_stat),
+    jbool(st->fault_any),
+    (unsigned)st->fault0,
+    (unsigned)st->fault1,
+    (unsigned)st->chg_flag0, (unsigned)st->chg_flag1,
+    (unsigned)st->chg_flag2, (unsigned)st->chg_flag3,
+    st->vbat_mv,
+    st->vsys_mv,
+    st->vbus_mv,
+    st->ibat_ma,
+    st->ibus_ma,
+    (double)st->tdie_c,
+    (unsigned)st->cell_count,
+    (int)snap->soc_pct,
+    (int)snap->soc_raw,
+    (double)snap->soc_filt,
+    (double)snap->soc_cc_pct,
+    (double)snap->charge_mah,
+    (double)snap->capacity_mah,
+    (unsigned)snap->sampler.period_us,
+    (unsigned)snap->sampler.jitter_max_us,
+    (unsigned)snap->sampler.jitter_mean_us,
+    (unsigned)snap->sampler.overruns,
+    (unsigned)snap->sampler.drops
+  );
+
+  if (n < 0) return -EIO;
+  if ((size_t)n >= len) return -ENOSPC;
+  return n;
+}
+
+/* ---- ikili format ----
+   ofs  alan
+   0    'B' 'Q' surum uzunluk
+   4    ts_ms i64
+   12   bus i32
+   16   addr, trigger
+   18   durum bitleri u16 (BIN_F_*)
+   20   chg_stat, vbus_stat, cell_count, fault0, fault1, chg_flag[4], 0
+   30   ibus_ma, ibat_ma, vbus_mv, vbat_mv, vsys_mv i32
+   50   tdie_c f32
+   54   soc_pct, soc_raw i32
+   62   soc_filt, soc_cc_pct, charge_mah, capacity_mah f32
+   78   sampler: period_us, jitter_max_us, jitter_mean_us, overruns, drops u32
+   98 */
+
+enum {
+  BIN_F_VBUS_PRESENT = 1u << 0,
+  BIN_F_AC1_PRESENT  = 1u << 1,
+  BIN_F_AC2_PRESENT  = 1u << 2,
+  BIN_F_PG           = 1u << 3,
+  BIN_F_IINDPM       = 1u << 4,
+  BIN_F_VINDPM       = 1u << 5,
+  BIN_F_WD_EXPIRED   = 1u << 6,
+  BIN_F_POOR_SOURCE  = 1u << 7,
+  BIN_F_BC12_DONE    = 1u << 8,
+  BIN_F_FAULT_ANY    = 1u << 9,
+  BIN_F_ADC_PENDING  = 1u << 10,
+};
+
+static uint8_t* put_u16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8);
+  return p + 2;
+}
+
+static uint8_t* put_u32(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+  return p + 4;
+}
+
+static uint8_t* put_f32(uint8_t *p, float f) {
+  uint32_t v;
+  memcpy(&v, &f, sizeof(v));
+  return put_u32(p, v);
+}
+
+static uint16_t get_u16(const uint8_t **p) {
+  const uint8_t *b = *p;
+  *p += 2;
+  return (uint16_t)(b[0] | (b[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t **p) {
+  const uint8_t *b = *p;
+  *p += 4;
+  return (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+}
+
+static float get_f32(const uint8_t **p) {
+  const uint32_t v = get_u32(p);
+  float f;
+  memcpy(&f, &v, sizeof(f));
+  return f;
+}
+
+int bq25792_snapshot_to_bin(const bq25792_snapshot_t *snap, uint8_t *buf, size_t len) {
+  if (!snap || !buf) return -EINVAL;
+  if (len < BQ25792_SNAPSHOT_BIN_LEN) return -ENOSPC;
+  const bq25792_status_t *st = &snap->st;
+
+  uint16_t f = 0;
+  if (st->vbus_present)     f |= BIN_F_VBUS_PRESENT;
+  if (st->ac1_present)      f |= BIN_F_AC1_PRESENT;
+  if (st->ac2_present)      f |= BIN_F_AC2_PRESENT;
+  if (st->pg)               f |= BIN_F_PG;
+  if (st->iindpm)           f |= BIN_F_IINDPM;
+  if (st->vindpm)           f |= BIN_F_VINDPM;
+  if (st->watchdog_expired) f |= BIN_F_WD_EXPIRED;
+  if (st->poor_source)      f |= BIN_F_POOR_SOURCE;
+  if (st->bc12_done)        f |= BIN_F_BC12_DONE;
+  if (st->fault_any)        f |= BIN_F_FAULT_ANY;
+  if (snap->adc_pending)    f |= BIN_F_ADC_PENDING;
+
+  uint8_t *p = buf;
+  *p++ = 'B';
+  *p++ = 'Q';
+  *p++ = BQ25792_SNAPSHOT_BIN_VERSION;
+  *p++ = BQ25792_SNAPSHOT_BIN_LEN;
+  const uint64_t ts = (uint64_t)snap->ts_ms;
+  p = put_u32(p, (uint32_t)ts);
+  p = put_u32(p, (uint32_t)(ts >> 32));
+  p = put_u32(p, (uint32_t)snap->bus);
+  *p++ = snap->addr;
+  *p++ = snap->trigger;
+  p = put_u16(p, f);
+  *p++ = st->chg_stat;
+  *p++ = st->vbus_stat;
+  *p++ = st->cell_count;
+  *p++ = st->fault0;
+  *p++ = st->fault1;
+  *p++ = st->chg_flag0;
+  *p++ = st->chg_flag1;
+  *p++ = st->chg_flag2;
+  *p++ = st->chg_flag3;
+  *p++ = 0;
+  p = put_u32(p, (uint32_t)st->ibus_ma);
+  p = put_u32(p, (uint32_t)st->ibat_ma);
+  p = put_u32(p, (uint32_t)st->vbus_mv);
+  p = put_u32(p, (uint32_t)st->vbat_mv);
+  p = put_u32(p, (uint32_t)st->vsys_mv);
+  p = put_f32(p, st->tdie_c);
+  p = put_u32(p, (uint32_t)snap->soc_pct);
+  p = put_u32(p, (uint32_t)snap->soc_raw);
+  p = put_f32(p, snap->soc_filt);
+  p = put_f32(p, snap->soc_cc_pct);
+  p = put_f32(p, snap->charge_mah);
+  p = put_f32(p, snap->capacity_mah);
+  p = put_u32(p, snap->sampler.period_us);
+  p = put_u32(p, snap->sampler.jitter_max_us);
+  p = put_u32(p, snap->sampler.jitter_mean_us);
+  p = put_u32(p, snap->sampler.overruns);
+  p = put_u32(p, snap->sampler.drops);
+  return (int)(p - buf);
+}
+
+int bq25792_snapshot_from_bin(bq25792_snapshot_t *snap, const uint8_t *buf, size_t len) {
+  if (!snap || !buf) return -EINVAL;
+  if (len < 4) return -EMSGSIZE;
+  if (buf[0] != 'B' || buf[1] != 'Q' || buf[2] != BQ25792_SNAPSHOT_BIN_VERSION) return -EBADMSG;
+  const size_t total = buf[3];
+  if (total < BQ25792_SNAPSHOT_BIN_LEN) return -EBADMSG;
+  if (len < total) return -EMSGSIZE;
+
+  memset(snap, 0, sizeof(*snap));
+  bq25792_status_t *st = &snap->st;
+  const uint8_t *p = buf + 4;
+  const uint64_t lo = get_u32(&p);
+  const uint64_t hi = get_u32(&p);
+  snap->ts_ms = (int64_t)(lo | (hi << 32));
+  snap->bus = (int32_t)get_u32(&p);
+  snap->addr = *p++;
+  snap->trigger = *p++;
+  const uint16_t f = get_u16(&p);
+  st->vbus_present     = (f & BIN_F_VBUS_PRESENT) != 0;
+  st->ac1_present      = (f & BIN_F_AC1_PRESENT) != 0;
+  st->ac2_present      = (f & BIN_F_AC2_PRESENT) != 0;
+  st->pg               = (f & BIN_F_PG) != 0;
+  st->iindpm           = (f & BIN_F_IINDPM) != 0;
+  st->vindpm           = (f & BIN_F_VINDPM) != 0;
+  st->watchdog_expired = (f & BIN_F_WD_EXPIRED) != 0;
+  st->poor_source      = (f & BIN_F_POOR_SOURCE) != 0;
+  st->bc12_done        = (f & BIN_F_BC12_DONE) != 0;
+  st->fault_any        = (f & BIN_F_FAULT_ANY) != 0;
+  snap->adc_pending    = (f & BIN_F_ADC_PENDING) != 0;
+  st->chg_stat = *p++;
+  st->vbus_stat = *p++;
+  st->cell_count = *p++;
+  st->fault0 = *p++;
+  st->fault1 = *p++;
+  st->chg_flag0 = *p++;
+  st->chg_flag1 = *p++;
+  st->chg_flag2 = *p++;
+  st->chg_flag3 = *p++;
+  p++;
+  st->ibus_ma = (int32_t)get_u32(&p);
+  st->ibat_ma = (int32_t)get_u32(&p);
+  st->vbus_mv = (int32_t)get_u32(&p);
+  st->vbat_mv = (int32_t)get_u32(&p);
+  st->vsys_mv = (int32_t)get_u32(&p);
+  st->tdie_c = get_f32(&p);
+  snap->soc_pct = (int32_t)get_u32(&p);
+  snap->soc_raw = (int32_t)get_u32(&p);
+  st->soc_pct_est = snap->soc_raw;
+  snap->soc_filt = get_f32(&p);
+  snap->soc_cc_pct = get_f32(&p);
+  snap->charge_mah = get_f32(&p);
+  snap->capacity_mah = get_f32(&p);
+  snap->sampler.period_us = get_u32(&p);
+  snap->sampler.jitter_max_us = get_u32(&p);
+  snap->sampler.jitter_mean_us = get_u32(&p);
+  snap->sampler.overruns = get_u32(&p);
+  snap->sampler.drops = get_u32(&p);
+  return (int)total;
+}
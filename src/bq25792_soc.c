@@ -0,0 +1,290 @@
+#include "bq25792_soc.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define MAUS_PER_MAH   3600000000LL  /* 1 mAh = 3600 s * 1e6 us */
+#define CHG_STAT_DONE  7
+
+/* Ogrenilen kapasite tasarim degerinin bu araligina sikistirilir */
+#define CAP_MIN_RATIO  0.5
+#define CAP_MAX_RATIO  1.5
+/* Yeni olcum ile mevcut kapasitenin harmanlanmasi */
+#define CAP_LEARN_GAIN 0.3
+
+void bq25792_cc_config_default(bq25792_cc_config_t *cfg) {
+  cfg->design_capacity_mah = 3000.0f;
+  cfg->rest_current_ma = 50;
+  cfg->rest_time_s = 1800;
+  cfg->learn_min_delta_pct = 40.0f;
+  cfg->max_gap_ms = 5000;
+}
+
+static int64_t mah_to_maus(double mah) { return (int64_t)(mah * (double)MAUS_PER_MAH); }
+
+void bq25792_cc_init(bq25792_cc_t *cc, const bq25792_cc_config_t *cfg) {
+  memset(cc, 0, sizeof(*cc));
+  if (cfg) cc->cfg = *cfg;
+  else bq25792_cc_config_default(&cc->cfg);
+  cc->capacity_mAus = mah_to_maus(cc->cfg.design_capacity_mah);
+  cc->cell_count = 1;
+}
+
+static float soc_of(const bq25792_cc_t *cc, int64_t charge) {
+  if (cc->capacity_mAus <= 0) return 0.0f;
+  return (float)((double)charge * 100.0 / (double)cc->capacity_mAus);
+}
+
+/* Bilinen bir SoC noktasina kalibre et; oncekiyle arasinda yeterli fark varsa kapasite ogren */
+static void calibrate(bq25792_cc_t *cc, float soc_pct) {
+  if (cc->anchor_valid) {
+    const float dsoc = soc_pct - cc->anchor_soc_pct;
+    const int64_t dq = cc->charge_mAus - cc->anchor_charge_mAus;
+    /* sarj (dq>0, dsoc>0) ya da desarj (dq<0, dsoc<0) ayni yonde olmali */
+    if ((dsoc >= cc->cfg.learn_min_delta_pct && dq > 0) ||
+        (dsoc <= -cc->cfg.learn_min_delta_pct && dq < 0)) {
+      const double measured = (double)dq * 100.0 / (double)dsoc;
+      const double design = (double)mah_to_maus(cc->cfg.design_capacity_mah);
+      double cap = (1.0 - CAP_LEARN_GAIN) * (double)cc->capacity_mAus + CAP_LEARN_GAIN * measured;
+      if (cap < design * CAP_MIN_RATIO) cap = design * CAP_MIN_RATIO;
+      if (cap > design * CAP_MAX_RATIO) cap = design * CAP_MAX_RATIO;
+      cc->capacity_mAus = (int64_t)cap;
+      cc->learn_count++;
+    }
+  }
+
+  cc->charge_mAus = (int64_t)((double)cc->capacity_mAus * (double)soc_pct / 100.0);
+  cc->anchor_valid = true;
+  cc->anchor_soc_pct = soc_pct;
+  cc->anchor_charge_mAus = cc->charge_mAus;
+  cc->valid = true;
+  cc->calibrations++;
+  cc->dirty = true;
+}
+
+static float ocv_soc(const bq25792_cc_t *cc, int vbat_mv) {
+  const int cells = cc->cell_count ? cc->cell_count : 1;
+  return (float)bq25792_soc_from_vcell_mv(vbat_mv / cells);
+}
+
+void bq25792_cc_update(bq25792_cc_t *cc, int64_t t_ns, int ibat_ma, int vbat_mv) {
+  if (cc->have_last) {
+    const int64_t dt_ns = t_ns - cc->last_t_ns;
+    if (dt_ns > 0 && dt_ns <= (int64_t)cc->cfg.max_gap_ms * 1000000LL) {
+      /* trapez: (i0 + i1) / 2 * dt */
+      /* sinirlama sadece okumada: kapasite ogrenimi olculen yukun tamamini gormeli */
+      cc->charge_mAus += ((int64_t)cc->last_ibat_ma + ibat_ma) * (dt_ns / 1000) / 2;
+    }
+  }
+  cc->have_last = true;
+  cc->last_t_ns = t_ns;
+  cc->last_ibat_ma = ibat_ma;
+  cc->last_vbat_mv = vbat_mv;
+  cc->samples++;
+
+  /* dinlenme: OCV ~ terminal voltaj, bir kez kalibre et */
+  if (abs(ibat_ma) < cc->cfg.rest_current_ma) {
+    if (cc->rest_since_ns == 0) cc->rest_since_ns = t_ns;
+    if (!cc->rest_calibrated && vbat_mv > 0 &&
+        (t_ns - cc->rest_since_ns) >= (int64_t)cc->cfg.rest_time_s * 1000000000LL) {
+      calibrate(cc, ocv_soc(cc, vbat_mv));
+      cc->rest_calibrated = true;
+    }
+  } else {
+    cc->rest_since_ns = 0;
+    cc->rest_calibrated = false;
+  }
+}
+
+void bq25792_cc_on_status(bq25792_cc_t *cc, int64_t t_ns, const bq25792_status_t *st) {
+  (void)t_ns;
+  if (st->cell_count >= 1) cc->cell_count = st->cell_count;
+
+  /* hic referans yoksa kaba OCV tahmini ile basla (ilk kalibrasyon noktasi sayilmaz) */
+  if (!cc->valid && st->vbat_mv > 0) {
+    cc->charge_mAus = (int64_t)((double)cc->capacity_mAus * st->soc_pct_est / 100.0);
+    cc->valid = true;
+  }
+
+  /* sarj sonu kenari: %100 */
+  if (st->chg_stat == CHG_STAT_DONE) {
+    if (!cc->term_latched) calibrate(cc, 100.0f);
+    cc->term_latched = true;
+  } else if (st->chg_stat != 0) {
+    cc->term_latched = false; /* yeni sarj dongusu */
+  }
+}
+
+float bq25792_cc_soc_pct(const bq25792_cc_t *cc) {
+  if (!cc->valid) return -1.0f;
+  float s = soc_of(cc, cc->charge_mAus);
+  return (s < 0.0f) ? 0.0f : (s > 100.0f) ? 100.0f : s;
+}
+
+float bq25792_cc_charge_mah(const bq25792_cc_t *cc) {
+  int64_t q = cc->charge_mAus;
+  if (q < 0) q = 0;
+  if (q > cc->capacity_mAus) q = cc->capacity_mAus;
+  return (float)((double)q / (double)MAUS_PER_MAH);
+}
+
+float bq25792_cc_capacity_mah(const bq25792_cc_t *cc) {
+  return (float)((double)cc->capacity_mAus / (double)MAUS_PER_MAH);
+}
+
+int bq25792_cc_save(bq25792_cc_t *cc, const char *path) {
+  if (!cc || !path) return -EINVAL;
+
+  char tmp[512];
+  snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+  FILE *f = fopen(tmp, "w");
+  if (!f) return -errno;
+
+  fprintf(f, "version=1\n");
+  fprintf(f, "capacity_mAus=%lld\n", (long long)cc->capacity_mAus);
+  fprintf(f, "charge_mAus=%lld\n", (long long)cc->charge_mAus);
+  fprintf(f, "valid=%d\n", cc->valid ? 1 : 0);
+  fprintf(f, "learn_count=%u\n", cc->learn_count);
+
+  fflush(f);
+  int bad = ferror(f);
+  (void)fsync(fileno(f));
+  fclose(f);
+  if (bad || rename(tmp, path) != 0) {
+    int e = bad ? -EIO : -errno;
+    unlink(tmp);
+    return e;
+  }
+  cc->dirty = false;
+  return 0;
+}
+
+int bq25792_cc_load(bq25792_cc_t *cc, const char *path) {
+  if (!cc || !path) return -EINVAL;
+  FILE *f = fopen(path, "r");
+  if (!f) return -errno;
+
+  long long cap = 0, chg = 0;
+  int valid = 0, version = 0;
+  unsigned learn = 0;
+  char line[128];
+  while (fgets(line, sizeof(line), f)) {
+    (void)(sscanf(line, "version=%d", &version) ||
+           sscanf(line, "capacity_mAus=%lld", &cap) ||
+           sscanf(line, "charge_mAus=%lld", &chg) ||
+           sscanf(line, "valid=%d", &valid) ||
+           sscanf(line, "learn_count=%u", &learn));
+  }
+  fclose(f);
+
+  if (version != 1 || cap <= 0) return -EPROTO;
+
+  /* Ogrenilen kapasite her zaman gecerli; kalan yuk kapali kalinan surede degismis olabilir,
+     ilk dinlenme/sarj sonu kalibrasyonunda duzelir. */
+  const double design = (double)mah_to_maus(cc->cfg.design_capacity_mah);
+  if ((double)cap < design * CAP_MIN_RATIO) cap = (long long)(design * CAP_MIN_RATIO);
+  if ((double)cap > design * CAP_MAX_RATIO) cap = (long long)(design * CAP_MAX_RATIO);
+  cc->capacity_mAus = cap;
+  cc->learn_count = learn;
+  if (valid) {
+    cc->charge_mAus = (chg < 0) ? 0 : (chg > cap) ? cap : chg;
+    cc->valid = true;
+  }
+  return 0;
+}
+
+/* ---- gosterim filtresi ---- */
+
+static int clampi(int v, int lo, int hi) { return (v < lo) ? lo : (v > hi) ? hi : v; }
+
+void bq25792_socfilt_config_default(bq25792_socfilt_config_t *cfg) {
+  cfg->alpha = 0.15f;
+  cfg->min_step_ms = 60000;
+  cfg->big_jump = 5;
+  cfg->stable_chg = 6;
+  cfg->stable_dis = 60;
+  cfg->dis_up_mult = 10;
+  cfg->idle_delta = 2;
+  cfg->stable_idle = 6;
+  cfg->dir_ma = 50;
+}
+
+void bq25792_socfilt_init(bq25792_socfilt_t *f, const bq25792_socfilt_config_t *cfg, int soc0, int64_t t_ms) {
+  memset(f, 0, sizeof(*f));
+  if (cfg) f->cfg = *cfg;
+  else bq25792_socfilt_config_default(&f->cfg);
+  f->soc_display = clampi(soc0, 0, 100);
+  f->soc_filt = (float)f->soc_display;
+  f->last_change_ms = t_ms;
+}
+
+int bq25792_socfilt_dir(const bq25792_socfilt_t *f, int ibat_ma) {
+  if (ibat_ma > f->cfg.dir_ma) return +1;
+  if (ibat_ma < -f->cfg.dir_ma) return -1;
+  return 0;
+}
+
+/* Yone uyan adim min_step_ms'de bir; ters yone adim ancak buyuk ve kalici
+   farkta (sarjda stable_chg, desarjda stable_dis ornek ve daha uzun aralik);
+   bostayken kucuk fark kararliysa her iki yone */
+void bq25792_socfilt_update(bq25792_socfilt_t *f, int soc_raw, int dir, int64_t t_ms) {
+  const bq25792_socfilt_config_t *c = &f->cfg;
+  soc_raw = clampi(soc_raw, 0, 100);
+  f->soc_filt = f->soc_filt + c->alpha * ((float)soc_raw - f->soc_filt);
+
+  const int target = clampi((int)(f->soc_filt + 0.5f), 0, 100);
+
+  if (dir != f->last_dir) {
+    f->stable_cnt = 0;
+    f->last_dir = dir;
+  }
+
+  const int diff = target - f->soc_display;
+  if (diff == 0) {
+    f->stable_cnt = 0;
+    return;
+  }
+
+  const int64_t since = t_ms - f->last_change_ms;
+  int step = 0;
+  if (dir > 0) { /* sarj */
+    if (diff > 0) {
+      if (since >= c->min_step_ms) step = 1;
+    } else if (-diff >= c->big_jump) {
+      if (++f->stable_cnt >= c->stable_chg && since >= c->min_step_ms) {
+        step = -1;
+        f->stable_cnt = 0;
+      }
+    } else {
+      f->stable_cnt = 0;
+    }
+  } else if (dir < 0) { /* desarj */
+    if (diff < 0) {
+      if (since >= c->min_step_ms) step = -1;
+    } else if (diff >= c->big_jump) {
+      if (++f->stable_cnt >= c->stable_dis && since >= (int64_t)c->dis_up_mult * c->min_step_ms) {
+        step = 1;
+        f->stable_cnt = 0;
+      }
+    } else {
+      f->stable_cnt = 0;
+    }
+  } else { /* bosta */
+    if (abs(diff) >= c->idle_delta) {
+      if (++f->stable_cnt >= c->stable_idle && since >= c->min_step_ms) {
+        step = (diff > 0) ? 1 : -1;
+        f->stable_cnt = 0;
+      }
+    } else {
+      f->stable_cnt = 0;
+    }
+  }
+
+  if (step) {
+    f->soc_display = clampi(f->soc_display + step, 0, 100);
+    f->last_change_ms = t_ms;
+  }
+}
@@ -0,0 +1,424 @@
+#include "bq25792_stats.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Trapez: (p0 + p1) * dt toplanir, yani kalan 2 * alt birim * us cinsinden */
+#define UWUS2_PER_MWH  (2LL * 3600LL * 1000000LL * 1000LL)  /* 1 mWh = 3.6e12 uW*us */
+#define MAUS2_PER_MAH  (2LL * 3600LL * 1000000LL)           /* 1 mAh = 3.6e9 mA*us */
+
+#define B BQ25792_STATS_BUCKETS
+
+/* ---- Welford ---- */
+
+void bq25792_welford_reset(bq25792_welford_t *w) {
+  memset(w, 0, sizeof(*w));
+}
+
+void bq25792_welford_add(bq25792_welford_t *w, int32_t x) {
+  if (w->n == 0) {
+    w->min = w->max = x;
+  } else {
+    if (x < w->min) w->min = x;
+    if (x > w->max) w->max = x;
+  }
+  w->n++;
+  const double d = (double)x - w->mean;
+  w->mean += d / (double)w->n;
+  w->m2 += d * ((double)x - w->mean);
+}
+
+void bq25792_welford_merge(bq25792_welford_t *dst, const bq25792_welford_t *src) {
+  if (src->n == 0) return;
+  if (dst->n == 0) {
+    *dst = *src;
+    return;
+  }
+  const double na = dst->n, nb = src->n, n = na + nb;
+  const double d = src->mean - dst->mean;
+  dst->mean += d * nb / n;
+  dst->m2 += src->m2 + d * d * na * nb / n;
+  dst->n += src->n;
+  if (src->min < dst->min) dst->min = src->min;
+  if (src->max > dst->max) dst->max = src->max;
+}
+
+/* merge'un tersi: dst = dst - src (min/max geri alinamaz, pencerede deque'lerden) */
+static void welford_remove(bq25792_welford_t *dst, const bq25792_welford_t *src) {
+  if (src->n == 0) return;
+  if (src->n >= dst->n) {
+    bq25792_welford_reset(dst);
+    return;
+  }
+  const double na = dst->n, nb = src->n, n = na - nb;
+  const double mean = (na * dst->mean - nb * src->mean) / n;
+  const double d = src->mean - mean;
+  dst->m2 -= src->m2 + d * d * nb * n / na;
+  if (dst->m2 < 0) dst->m2 = 0;
+  dst->mean = mean;
+  dst->n -= src->n;
+}
+
+double bq25792_welford_stddev(const bq25792_welford_t *w) {
+  return (w->n < 2) ? 0.0 : sqrt(w->m2 / (double)(w->n - 1));
+}
+
+/* ---- monoton deque (dilim minimum/maksimumlari) ---- */
+
+static uint8_t dq_at(const bq25792_stat_deque_t *q, int i) { return q->idx[(q->head + i) % B]; }
+
+/* want_min: on taraf en kucuk; aksi halde en buyuk. v: dilim cur'un yeni uc degeri */
+static void dq_push(bq25792_stat_deque_t *q, const bq25792_welford_t (*bucket)[BQ25792_STAT_NCHAN],
+                    int c, uint8_t cur, int32_t v, int want_min) {
+  while (q->len > 0) {
+    const bq25792_welford_t *back = &bucket[dq_at(q, q->len - 1)][c];
+    if (want_min ? back->min < v : back->max > v) break;
+    q->len--;
+  }
+  q->idx[(q->head + q->len) % B] = cur;
+  q->len++;
+}
+
+static void dq_evict(bq25792_stat_deque_t *q, uint8_t idx) {
+  if (q->len > 0 && q->idx[q->head] == idx) {
+    q->head = (uint8_t)((q->head + 1) % B);
+    q->len--;
+  }
+}
+
+/* ---- pencere ---- */
+
+static void win_clear(bq25792_statwin_t *w, int64_t t_ms) {
+  const int64_t window_ms = w->window_ms, bucket_ms = w->bucket_ms;
+  memset(w, 0, sizeof(*w));
+  w->window_ms = window_ms;
+  w->bucket_ms = bucket_ms;
+  w->cur_start_ms = t_ms;
+  w->first_ms = t_ms;
+  w->started = true;
+}
+
+/* Toplami kapanmis dilimlerden yeniden kur: ters birlestirmenin yuvarlama hatasi birikmesin */
+static void win_rebuild(bq25792_statwin_t *w) {
+  for (int c = 0; c < BQ25792_STAT_NCHAN; c++) {
+    bq25792_welford_reset(&w->agg[c]);
+    for (int i = 0; i < B; i++) {
+      if (i != w->cur) bq25792_welford_merge(&w->agg[c], &w->bucket[i][c]);
+    }
+  }
+}
+
+/* Kapanan dilim toplama eklenir, yeniden kullanilacak (en eski) dilim dusulur */
+static void win_rotate(bq25792_statwin_t *w) {
+  const uint8_t prev = w->cur;
+  w->cur = (uint8_t)((w->cur + 1) % B);
+  w->cur_start_ms += w->bucket_ms;
+  for (int c = 0; c < BQ25792_STAT_NCHAN; c++) {
+    bq25792_welford_t *b = &w->bucket[w->cur][c];
+    bq25792_welford_merge(&w->agg[c], &w->bucket[prev][c]);
+    welford_remove(&w->agg[c], b);
+    dq_evict(&w->dmin[c], w->cur);
+    dq_evict(&w->dmax[c], w->cur);
+    bq25792_welford_reset(b);
+  }
+  if (++w->rotations % B == 0) win_rebuild(w);
+}
+
+static void win_advance(bq25792_statwin_t *w, int64_t t_ms) {
+  if (!w->started) {
+    win_clear(w, t_ms);
+    return;
+  }
+  if (t_ms < w->cur_start_ms + w->bucket_ms) return;
+  const int64_t steps = (t_ms - w->cur_start_ms) / w->bucket_ms;
+  if (steps >= B) {
+    /* pencereden uzun bosluk: hepsi dusuyor */
+    win_clear(w, t_ms);
+    return;
+  }
+  for (int64_t i = 0; i < steps; i++) win_rotate(w);
+}
+
+static void win_add(bq25792_statwin_t *w, int64_t t_ms, const int32_t *v) {
+  const int fresh = !w->started;
+  win_advance(w, t_ms);
+  if (fresh || w->first_ms > t_ms) w->first_ms = t_ms;
+  for (int c = 0; c < BQ25792_STAT_NCHAN; c++) {
+    bq25792_welford_t *b = &w->bucket[w->cur][c];
+    const int first = (b->n == 0);
+    const int32_t omin = b->min, omax = b->max;
+    bq25792_welford_add(b, v[c]);
+    if (first || v[c] < omin) dq_push(&w->dmin[c], (const bq25792_welford_t (*)[BQ25792_STAT_NCHAN])w->bucket, c, w->cur, v[c], 1);
+    if (first || v[c] > omax) dq_push(&w->dmax[c], (const bq25792_welford_t (*)[BQ25792_STAT_NCHAN])w->bucket, c, w->cur, v[c], 0);
+  }
+}
+
+/* ---- sayaclar ---- */
+
+static void fix_add(bq25792_fix_acc_t *a, int64_t v, int64_t unit) {
+  a->rem += v;
+  if (a->rem >= unit) {
+    a->whole += (uint64_t)(a->rem / unit);
+    a->rem %= unit;
+  }
+}
+
+static double fix_value(const bq25792_fix_acc_t *a, int64_t unit) {
+  return (double)a->whole + (double)a->rem / (double)unit;
+}
+
+static int64_t pos(int64_t x) { return x > 0 ? x : 0; }
+
+/* Yonlere ayrilmis trapez: isaret degisen aralikta net toplam trapez ile ayni kalir */
+static void integrate(bq25792_fix_acc_t *in, bq25792_fix_acc_t *out, int64_t a, int64_t b,
+                      int64_t dt_us, int64_t unit) {
+  const int64_t pin = pos(a) + pos(b);
+  const int64_t pout = pos(-a) + pos(-b);
+  if (pin) fix_add(in, pin * dt_us, unit);
+  if (pout) fix_add(out, pout * dt_us, unit);
+}
+
+static int64_t real_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (int64_t)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000LL;
+}
+
+/* ---- genel ---- */
+
+void bq25792_stats_config_default(bq25792_stats_config_t *cfg) {
+  memset(cfg, 0, sizeof(*cfg));
+  cfg->nwin = 3;
+  cfg->window_ms[0] = 10000;
+  cfg->window_ms[1] = 60000;
+  cfg->window_ms[2] = 900000;
+  cfg->max_gap_ms = 5000;
+}
+
+int bq25792_stats_config_parse_windows(bq25792_stats_config_t *cfg, const char *s) {
+  if (!cfg || !s) return -EINVAL;
+  int64_t w[BQ25792_STATS_MAX_WINDOWS];
+  int n = 0;
+  while (*s) {
+    char *end;
+    const long v = strtol(s, &end, 10);
+    if (end == s || v <= 0 || v > 7 * 86400 || n == BQ25792_STATS_MAX_WINDOWS) return -EINVAL;
+    w[n++] = (int64_t)v * 1000;
+    s = end;
+    if (*s == ',') s++;
+    else if (*s) return -EINVAL;
+  }
+  if (n == 0) return -EINVAL;
+  cfg->nwin = n;
+  memcpy(cfg->window_ms, w, sizeof(w[0]) * (size_t)n);
+  return 0;
+}
+
+void bq25792_stats_init(bq25792_stats_t *s, const bq25792_stats_config_t *cfg) {
+  memset(s, 0, sizeof(*s));
+  if (cfg) s->cfg = *cfg;
+  else bq25792_stats_config_default(&s->cfg);
+  if (s->cfg.nwin < 0) s->cfg.nwin = 0;
+  if (s->cfg.nwin > BQ25792_STATS_MAX_WINDOWS) s->cfg.nwin = BQ25792_STATS_MAX_WINDOWS;
+  for (int k = 0; k < s->cfg.nwin; k++) {
+    bq25792_statwin_t *w = &s->win[k];
+    w->window_ms = s->cfg.window_ms[k] > 0 ? s->cfg.window_ms[k] : 60000;
+    w->bucket_ms = w->window_ms / B > 0 ? w->window_ms / B : 1;
+  }
+}
+
+void bq25792_stats_add(bq25792_stats_t *s, int64_t t_ns, int vbat_mv, int ibat_ma, int vbus_mv, int ibus_ma) {
+  const int64_t pbat_uw = (int64_t)vbat_mv * ibat_ma;
+  const int64_t pbus_uw = (int64_t)vbus_mv * ibus_ma;
+  const int32_t v[BQ25792_STAT_NCHAN] = {
+    vbat_mv, ibat_ma, vbus_mv, ibus_ma, (int32_t)(pbat_uw / 1000), (int32_t)(pbus_uw / 1000),
+  };
+
+  const int64_t t_ms = t_ns / 1000000LL;
+  for (int k = 0; k < s->cfg.nwin; k++) win_add(&s->win[k], t_ms, v);
+  for (int c = 0; c < BQ25792_STAT_NCHAN; c++) bq25792_welford_add(&s->total[c], v[c]);
+  s->samples++;
+
+  if (s->have_last) {
+    const int64_t dt_us = (t_ns - s->last_t_ns) / 1000LL;
+    if (dt_us > 0 && dt_us <= (int64_t)s->cfg.max_gap_ms * 1000LL) {
+      integrate(&s->energy[BQ25792_E_BAT_IN], &s->energy[BQ25792_E_BAT_OUT],
+                (int64_t)s->last_vbat_mv * s->last_ibat_ma, pbat_uw, dt_us, UWUS2_PER_MWH);
+      integrate(&s->energy[BQ25792_E_BUS_IN], &s->energy[BQ25792_E_BUS_OUT],
+                (int64_t)s->last_vbus_mv * s->last_ibus_ma, pbus_uw, dt_us, UWUS2_PER_MWH);
+      integrate(&s->charge[BQ25792_Q_BAT_IN], &s->charge[BQ25792_Q_BAT_OUT],
+                s->last_ibat_ma, ibat_ma, dt_us, MAUS2_PER_MAH);
+      s->dirty = true;
+    } else if (dt_us > 0) {
+      s->gaps++;
+    }
+  }
+  if (!s->since_ms) s->since_ms = real_ms();
+  s->have_last = true;
+  s->last_t_ns = t_ns;
+  s->last_vbat_mv = vbat_mv;
+  s->last_ibat_ma = ibat_ma;
+  s->last_vbus_mv = vbus_mv;
+  s->last_ibus_ma = ibus_ma;
+}
+
+int bq25792_stats_window(bq25792_stats_t *s, int k, int64_t t_ns, bq25792_stat_window_t *out) {
+  if (!s || !out || k < 0 || k >= s->cfg.nwin) return -EINVAL;
+  bq25792_statwin_t *w = &s->win[k];
+  const int64_t t_ms = t_ns / 1000000LL;
+  memset(out, 0, sizeof(*out));
+  out->window_ms = w->window_ms;
+  if (!w->started) return 0;
+  win_advance(w, t_ms);
+
+  const int64_t span = t_ms - w->first_ms;
+  out->span_ms = span < 0 ? 0 : span > w->window_ms ? w->window_ms : span;
+  for (int c = 0; c < BQ25792_STAT_NCHAN; c++) {
+    bq25792_welford_t a = w->agg[c];
+    bq25792_welford_merge(&a, &w->bucket[w->cur][c]);
+    bq25792_stat_agg_t *o = &out->ch[c];
+    o->n = a.n;
+    if (a.n == 0) continue;
+    o->mean = a.mean;
+    o->stddev = bq25792_welford_stddev(&a);
+    if (w->dmin[c].len) o->min = w->bucket[dq_at(&w->dmin[c], 0)][c].min;
+    if (w->dmax[c].len) o->max = w->bucket[dq_at(&w->dmax[c], 0)][c].max;
+  }
+  return 0;
+}
+
+void bq25792_stats_energy(const bq25792_stats_t *s, bq25792_energy_t *out) {
+  for (int e = 0; e < BQ25792_E_COUNT; e++) out->wh[e] = fix_value(&s->energy[e], UWUS2_PER_MWH) / 1000.0;
+  for (int q = 0; q < BQ25792_Q_COUNT; q++) out->ah[q] = fix_value(&s->charge[q], MAUS2_PER_MAH) / 1000.0;
+  out->since_ms = s->since_ms;
+}
+
+static const char *const chan_name[BQ25792_STAT_NCHAN] = {
+  "vbat_mv", "ibat_ma", "vbus_mv", "ibus_ma", "pbat_mw", "pbus_mw",
+};
+
+static const char *const energy_name[BQ25792_E_COUNT] = {
+  "bat_in", "bat_out", "bus_in", "bus_out",
+};
+
+const char* bq25792_stat_chan_str(int chan) {
+  return (chan >= 0 && chan < BQ25792_STAT_NCHAN) ? chan_name[chan] : "unknown";
+}
+
+const char* bq25792_energy_kind_str(int kind) {
+  return (kind >= 0 && kind < BQ25792_E_COUNT) ? energy_name[kind] : "unknown";
+}
+
+#define APPEND(...) do { \
+    int n_ = snprintf(buf + off, len - off, __VA_ARGS__); \
+    if (n_ < 0 || (size_t)n_ >= len - off) return -ENOSPC; \
+    off += (size_t)n_; \
+  } while (0)
+
+int bq25792_stats_to_json(bq25792_stats_t *s, int64_t t_ns, char *buf, size_t len) {
+  if (!s || !buf || len == 0) return -EINVAL;
+  size_t off = 0;
+
+  bq25792_energy_t e;
+  bq25792_stats_energy(s, &e);
+  APPEND("\"energy\":{\"since_ms\":%lld", (long long)e.since_ms);
+  for (int k = 0; k < BQ25792_E_COUNT; k++) APPEND(",\"%s_wh\":%.4f", energy_name[k], e.wh[k]);
+  APPEND(",\"bat_in_ah\":%.4f,\"bat_out_ah\":%.4f}", e.ah[BQ25792_Q_BAT_IN], e.ah[BQ25792_Q_BAT_OUT]);
+
+  APPEND(",\"windows\":[");
+  for (int k = 0; k < s->cfg.nwin; k++) {
+    bq25792_stat_window_t w;
+    (void)bq25792_stats_window(s, k, t_ns, &w);
+    APPEND("%s{\"window_s\":%lld,\"span_ms\":%lld,\"n\":%u", k ? "," : "",
+           (long long)(w.window_ms / 1000), (long long)w.span_ms, w.ch[0].n);
+    for (int c = 0; c < BQ25792_STAT_NCHAN; c++) {
+      const bq25792_stat_agg_t *a = &w.ch[c];
+      if (a->n == 0) APPEND(",\"%s\":null", chan_name[c]);
+      else APPEND(",\"%s\":{\"mean\":%.1f,\"min\":%d,\"max\":%d,\"std\":%.2f}",
+                  chan_name[c], a->mean, a->min, a->max, a->stddev);
+    }
+    APPEND("}");
+  }
+  APPEND("]");
+  return (int)off;
+}
+
+int bq25792_stats_save(bq25792_stats_t *s, const char *path) {
+  if (!s || !path) return -EINVAL;
+
+  char tmp[512];
+  snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+  FILE *f = fopen(tmp, "w");
+  if (!f) return -errno;
+
+  fprintf(f, "version=1\n");
+  fprintf(f, "since_ms=%lld\n", (long long)s->since_ms);
+  for (int k = 0; k < BQ25792_E_COUNT; k++) {
+    fprintf(f, "%s_mwh=%llu %lld\n", energy_name[k],
+            (unsigned long long)s->energy[k].whole, (long long)s->energy[k].rem);
+  }
+  fprintf(f, "bat_in_mah=%llu %lld\n", (unsigned long long)s->charge[BQ25792_Q_BAT_IN].whole,
+          (long long)s->charge[BQ25792_Q_BAT_IN].rem);
+  fprintf(f, "bat_out_mah=%llu %lld\n", (unsigned long long)s->charge[BQ25792_Q_BAT_OUT].whole,
+          (long long)s->charge[BQ25792_Q_BAT_OUT].rem);
+
+  fflush(f);
+  int bad = ferror(f);
+  (void)fsync(fileno(f));
+  fclose(f);
+  if (bad || rename(tmp, path) != 0) {
+    int e = bad ? -EIO : -errno;
+    unlink(tmp);
+    return e;
+  }
+  s->dirty = false;
+  return 0;
+}
+
+static int parse_acc(const char *line, const char *key, bq25792_fix_acc_t *a, int64_t unit) {
+  const size_t kl = strlen(key);
+  if (strncmp(line, key, kl) != 0 || line[kl] != '=') return 0;
+  unsigned long long whole;
+  long long rem;
+  if (sscanf(line + kl + 1, "%llu %lld", &whole, &rem) != 2 || rem < 0 || rem >= unit) return -1;
+  a->whole = whole;
+  a->rem = rem;
+  return 1;
+}
+
+int bq25792_stats_load(bq25792_stats_t *s, const char *path) {
+  if (!s || !path) return -EINVAL;
+  FILE *f = fopen(path, "r");
+  if (!f) return -errno;
+
+  bq25792_fix_acc_t energy[BQ25792_E_COUNT], charge[BQ25792_Q_COUNT];
+  memset(energy, 0, sizeof(energy));
+  memset(charge, 0, sizeof(charge));
+  long long since = 0;
+  int version = 0, bad = 0;
+  char line[128], key[32];
+  while (fgets(line, sizeof(line), f)) {
+    if (sscanf(line, "version=%d", &version) == 1 || sscanf(line, "since_ms=%lld", &since) == 1) continue;
+    int r = 0;
+    for (int k = 0; k < BQ25792_E_COUNT && !r; k++) {
+      snprintf(key, sizeof(key), "%s_mwh", energy_name[k]);
+      r = parse_acc(line, key, &energy[k], UWUS2_PER_MWH);
+    }
+    if (!r) r = parse_acc(line, "bat_in_mah", &charge[BQ25792_Q_BAT_IN], MAUS2_PER_MAH);
+    if (!r) r = parse_acc(line, "bat_out_mah", &charge[BQ25792_Q_BAT_OUT], MAUS2_PER_MAH);
+    if (r < 0) bad = 1;
+  }
+  fclose(f);
+
+  if (version != 1 || bad) return -EPROTO;
+  memcpy(s->energy, energy, sizeof(energy));
+  memcpy(s->charge, charge, sizeof(charge));
+  s->since_ms = since;
+  s->dirty = false;
+  return 0;
+}
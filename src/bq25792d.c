@@ -1,32 +1,65 @@
 #include "bq25792.h"
+#include "bq25792_capture.h"
+#include "bq25792_events.h"
+#include "bq25792_history.h"
+#include "bq25792_metrics.h"
+#include "bq25792_regs.h"
+#include "bq25792_shm.h"
+#include "bq25792_soc.h"
+#include "bq25792_stats.h"
+#include "bq25792d_evsrc.h"
+#include "bq25792d_loop.h"
+#include "bq25792d_metrics.h"
+#include "bq25792d_notify.h"
+#include "bq25792d_pack.h"
+#include "bq25792d_publish.h"
+#include "bq25792d_sampler.h"
+#include "bq25792d_sched.h"
+#include "bq25792d_server.h"
 
 #include <errno.h>
+#include <fcntl.h>
+#include <linux/magic.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/signalfd.h>
 #include <sys/stat.h>
+#include <sys/timerfd.h>
+#include <sys/vfs.h>
 #include <time.h>
 #include <unistd.h>
 
-static volatile sig_atomic_t g_stop = 0;
-
-static void on_sig(int sig) {
-  (void)sig;
-  g_stop = 1;
-}
-
 static int env_int(const char *name, int defv) {
   const char *s = getenv(name);
   if (!s || !*s) return defv;
   return (int)strtol(s, NULL, 0);
 }
 
+static float env_float(const char *name, float defv) {
+  const char *s = getenv(name);
+  if (!s || !*s) return defv;
+  return strtof(s, NULL);
+}
+
 static const char* env_str(const char *name, const char *defv) {
   const char *s = getenv(name);
   return (s && *s) ? s : defv;
 }
 
+static long long mono_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000LL;
+}
+
+static long long mono_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
 static long long now_ms(void) {
   struct timespec ts;
   clock_gettime(CLOCK_REALTIME, &ts);
@@ -44,26 +77,32 @@ static int mkdir_p_for_file(const char *path) {
   return -errno;
 }
 
+/* tmp dosyaya yaz + rename. Hedef tmpfs ise (/run) fsync anlamsiz, atlanir. */
 static int atomic_write(const char *path, const char *data, size_t len) {
   (void)mkdir_p_for_file(path);
 
   char tmp[512];
   snprintf(tmp, sizeof(tmp), "%s.tmp", path);
 
-  FILE *f = fopen(tmp, "wb");
-  if (!f) return -errno;
+  int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) return -errno;
 
-  if (fwrite(data, 1, len, f) != len) {
-    int e = -errno;
-    fclose(f);
-    unlink(tmp);
-    return e;
+  size_t off = 0;
+  while (off < len) {
+    ssize_t w = write(fd, data + off, len - off);
+    if (w < 0) {
+      if (errno == EINTR) continue;
+      int e = -errno;
+      close(fd);
+      unlink(tmp);
+      return e;
+    }
+    off += (size_t)w;
   }
 
-  fflush(f);
-  int fd = fileno(f);
-  if (fd >= 0) fsync(fd);
-  fclose(f);
+  struct statfs sfs;
+  if (fstatfs(fd, &sfs) != 0 || sfs.f_type != TMPFS_MAGIC) fsync(fd);
+  close(fd);
 
   if (rename(tmp, path) != 0) {
     int e = -errno;
@@ -73,214 +112,1022 @@ static int atomic_write(const char *path, const char *data, size_t len) {
   return 0;
 }
 
+#define BQD_MAX_DEVICES 8
+/* metrics metni: ~7 KiB ortak + cihaz basina ~7 KiB (etiketli seriler) */
+#define METRICS_CAP(ndev) (16384 + (size_t)(ndev) * 12288)
+
+/* durum dosyasi formatlari (BQ_STATUS_FORMAT) */
+#define STATUS_FMT_JSON 0x1
+#define STATUS_FMT_BIN  0x2
+
+/* Tek sarj cihazi: kendi publisher'i, filtresi, coulomb counter'i ve ciktilari */
 typedef struct {
-  int soc_display;            /* 0..100, third-party */
-  float soc_filt;             /* filter state */
-  long long last_change_ms;   /* rate limiting */
-  int stable_cnt;             /* consecutive stability */
-  int last_dir;               /* -1,0,+1 */
-} soc_filter_t;
-
-static int clampi(int v, int lo, int hi) { return (v < lo) ? lo : (v > hi) ? hi : v; }
-
-static void soc_filter_init(soc_filter_t *f, int soc0) {
-  memset(f, 0, sizeof(*f));
-  f->soc_display = clampi(soc0, 0, 100);
-  f->soc_filt = (float)f->soc_display;
-  f->last_change_ms = now_ms();
-  f->stable_cnt = 0;
-  f->last_dir = 0;
-}
-
-static int infer_dir(const bq25792_status_t *st) {
-  if (st->ibat_ma > 50) return +1;
-  if (st->ibat_ma < -50) return -1;
-  return 0;
+  int bus;
+  int addr;
+  char labels[48];          /* bus="10",addr="0x6b" */
+  char status_path[512];
+  char status_bin_path[512];
+  char cc_state_path[512];  /* bos: kapali */
+  char stats_state_path[512]; /* enerji sayaclari, bos: kalici degil */
+  bq25792_dev_t *dev;       /* NULL: acilamadi; aksi halde bus sampler'inin */
+  bqd_sampler_t *sampler;   /* cihazin bus sampler'i ve oradaki sirasi */
+  int sampler_dev;
+  bq25792_shm_t *shm;
+  bq25792_history_t *hist;
+
+  bqd_publisher_t pub;
+  bq25792_socfilt_t filt;
+  int filt_inited;
+  bq25792_cc_t cc;
+  long long cc_saved_ms;    /* CLOCK_MONOTONIC */
+  bq25792_stats_t stats;    /* pencereli ozetler + enerji/yuk sayaclari */
+  long long stats_saved_ms; /* CLOCK_MONOTONIC */
+  bqd_dev_metrics_t metrics;
+
+  bq25792_snapshot_t snap;  /* son basarili tam ornek */
+  int have_snap;
+  int first_done;           /* ilk tam okuma denendi (basarili ya da degil) */
+  long long snap_mono_ms;
+  char json[1024];
+  int json_len;
+  uint8_t regs[BQ25792_NREGS];  /* son tam ornegin register imaji */
+  uint8_t ev_prev[BQ25792_NREGS];  /* kenar tespiti: son okunan REG1B..REG21 */
+  int have_ev_prev;
+  uint8_t flag_acc[6];      /* olay yoklamasinda okunan REG22..REG27, sonraki snapshot'a eklenir */
+  long long live_req_ns;    /* bekleyen "live" okumasi (CLOCK_MONOTONIC), 0 = yok */
+} device_t;
+
+/* Bus basina bir sampler thread'i; ayni bus'taki cihazlar o thread'de sirayla okunur */
+typedef struct {
+  bqd_watch_t w;            /* ilk uye: epoll data.ptr -> bus_worker_t */
+  int bus;
+  char labels[24];          /* bus="10" */
+  bqd_sampler_t *sampler;
+  bq25792_sampler_stats_t last_stats;
+  int ndev;
+  device_t *devs[BQD_SAMPLER_MAX_DEVS];
+} bus_worker_t;
+
+typedef struct {
+  /* ayarlar */
+  long long interval_ms;
+  bqd_sched_config_t sched;
+  bq25792_socfilt_config_t socfilt;
+  long long int_holdoff_ms;
+  long long live_fresh_ms;  /* "live": bu kadar taze ornek varsa bus'a gidilmez */
+  const char *pack_path;    /* sadece coklu cihazda */
+  int status_fmt;           /* STATUS_FMT_* */
+  int cc_hz;
+  int event_hz;
+  uint32_t adc_channels;
+  const char *metrics_path;
+  long long metrics_interval_ms;
+  int rt_prio;
+  int rt_cpu;
+
+  /* kaynaklar */
+  int epfd;
+  bqd_server_t *srv;
+  bqd_evsrc_t irq;
+  bqd_watch_t w_signal;
+  bqd_watch_t w_irq;
+  bqd_watch_t w_wdog;       /* systemd watchdog timerfd, -1 = yok */
+  long long wdog_usec;
+
+  /* cihazlar (BQ_DEVICES sirasiyla) ve bus worker'lari */
+  int ndev;
+  device_t devs[BQD_MAX_DEVICES];
+  int nworker;
+  bus_worker_t workers[BQD_MAX_DEVICES];
+
+  /* durum */
+  bq25792_journal_t journal;
+  bqd_metrics_t metrics;
+  long long metrics_written_ms; /* CLOCK_MONOTONIC */
+  int ready;                /* 1: READY=1 gonderildi, 2: tum cihazlarda ADC gecerli */
+  int stop;
+} daemon_t;
+
+static int multi(const daemon_t *d) { return d->ndev > 1; }
+
+/* BQ_DEVICES="10:0x6b,11:0x6b" -> (bus, addr) listesi. Donus: cihaz sayisi ya da -EINVAL */
+static int parse_devices(const char *spec, int *bus, int *addr, int max) {
+  int n = 0;
+  const char *p = spec;
+  while (*p) {
+    char *end;
+    long b = strtol(p, &end, 0);
+    if (end == p || *end != ':') return -EINVAL;
+    p = end + 1;
+    long a = strtol(p, &end, 0);
+    if (end == p || b < 0 || a < 0x03 || a > 0x77) return -EINVAL;
+    if (n == max) return -E2BIG;
+    for (int i = 0; i < n; i++) {
+      if (bus[i] == (int)b && addr[i] == (int)a) return -EINVAL;
+    }
+    bus[n] = (int)b;
+    addr[n] = (int)a;
+    n++;
+    p = end;
+    while (*p == ',' || *p == ' ') p++;
+  }
+  return n;
+}
+
+/* Coklu cihazda dosya yollari cihaz basina: status.json -> status-10-0x6b.json */
+static void device_path(char *out, size_t len, const char *path, const device_t *dv, int multi_dev) {
+  if (!multi_dev) {
+    snprintf(out, len, "%s", path);
+    return;
+  }
+  const char *slash = strrchr(path, '/');
+  const char *dot = strrchr(path, '.');
+  if (!dot || (slash && dot < slash)) dot = path + strlen(path);
+  snprintf(out, len, "%.*s-%d-0x%02x%s", (int)(dot - path), path, dv->bus, dv->addr & 0xFF, dot);
 }
 
-/* Stabilizasyon:
-   - EMA (alpha=0.15)
-   - direction-based anti-jitter
-   - rate limit: max 1%/dakika
-*/
-static void soc_filter_update(soc_filter_t *f, int soc_raw, int dir) {
-  soc_raw = clampi(soc_raw, 0, 100);
+/* INT kaynagini ortamdan kur:
+   BQ_INT_GPIOCHIP + BQ_INT_LINE -> GPIO character device line event
+   BQ_INT_FD                      -> miras alinan eventfd/pipe (test icin kenar enjeksiyonu) */
+static void setup_evsrc(bqd_evsrc_t *es) {
+  bqd_evsrc_init(es);
+
+  const int fd = env_int("BQ_INT_FD", -1);
+  if (fd >= 0) {
+    int rc = bqd_evsrc_open_fd(es, fd);
+    if (rc) fprintf(stderr, "bq25792d: BQ_INT_FD=%d kullanilamadi: %s\n", fd, strerror(-rc));
+    return;
+  }
+
+  const char *chip = env_str("BQ_INT_GPIOCHIP", NULL);
+  const int line = env_int("BQ_INT_LINE", -1);
+  if (!chip || line < 0) return;
 
-  const float alpha = 0.15f;
-  f->soc_filt = f->soc_filt + alpha * ((float)soc_raw - f->soc_filt);
+  int rc = bqd_evsrc_open_gpio(es, chip, (unsigned)line);
+  if (rc) {
+    fprintf(stderr, "bq25792d: INT line acilamadi (%s:%d): %s, sadece timer ile devam\n",
+            chip, line, strerror(-rc));
+  }
+}
 
-  int target = (int)(f->soc_filt + 0.5f);
-  target = clampi(target, 0, 100);
+/* Coklu cihaz: son snapshot'lardan pack ozeti -> pack.json + socket (get/subscribe) */
+static void publish_pack(daemon_t *d) {
+  bqd_pack_entry_t e[BQD_MAX_DEVICES];
+  const long long tnow = mono_ms();
+  for (int i = 0; i < d->ndev; i++) {
+    const device_t *dv = &d->devs[i];
+    e[i].bus = dv->bus;
+    e[i].addr = dv->addr;
+    e[i].snap = dv->have_snap ? &dv->snap : NULL;
+    e[i].age_ms = dv->have_snap ? tnow - dv->snap_mono_ms : 0;
+    /* 3 heartbeat boyunca basarili ornek yoksa bus takili say */
+    e[i].stale = dv->have_snap && e[i].age_ms > 3 * d->sched.max_ms;
+  }
 
-  if (dir != f->last_dir) {
-    f->stable_cnt = 0;
-    f->last_dir = dir;
+  static char buf[4096];
+  int n = bqd_pack_to_json(e, d->ndev, now_ms(), buf, sizeof(buf));
+  if (n <= 0) return;
+  if (atomic_write(d->pack_path, buf, (size_t)n) != 0) {
+    fprintf(stderr, "bq25792d: pack yazilamadi (%s)\n", d->pack_path);
   }
+  bqd_server_broadcast(d->srv, buf, (size_t)n);
+  d->metrics.broadcasts++;
+}
 
-  int disp = f->soc_display;
-  int diff = target - disp;
-  if (diff == 0) {
-    f->stable_cnt = 0;
+/* Sampler'dan gelen tam ornek: filtre, cc, shm/history/status.json/socket.
+   Hizli baslangic ornegi (adc_pending) sadece durum/flag tasir: filtre, cc ve
+   history'ye girmez, SoC alanlari -1 (cc'nin kayitli durumu haric). */
+static void publish_sample(daemon_t *d, bus_worker_t *bw, device_t *dv, const bqd_sample_t *smp) {
+  dv->first_done = 1;
+  dv->metrics.samples_full++;
+  if (smp->rc) {
+    dv->metrics.sample_errors_full++;
+    fprintf(stderr, "bq25792d: read_status failed (bus=%d addr=0x%02x): %s\n",
+            dv->bus, dv->addr & 0xFF, strerror(-smp->rc));
     return;
   }
+  dv->metrics.last_ok_ts_ms = smp->ts_ms;
+  bq25792_status_t st = smp->st;
 
-  long long t = now_ms();
-  const long long min_step_ms = 60 * 1000LL;
-  const int big_jump = 5;
+  /* aradaki olay yoklamalarinda okunup temizlenen flag'lar snapshot'ta kaybolmasin */
+  st.chg_flag0 |= dv->flag_acc[0];
+  st.chg_flag1 |= dv->flag_acc[1];
+  st.chg_flag2 |= dv->flag_acc[2];
+  st.chg_flag3 |= dv->flag_acc[3];
+  st.fault0 |= dv->flag_acc[4];
+  st.fault1 |= dv->flag_acc[5];
+  st.fault_any = st.fault_any || st.fault0 || st.fault1;
+  if (smp->adc_pending) {
+    /* okunup temizlenen flag'lar hemen ardindan gelen tam snapshot'ta da gorunsun */
+    const uint8_t acc[6] = { st.chg_flag0, st.chg_flag1, st.chg_flag2, st.chg_flag3, st.fault0, st.fault1 };
+    memcpy(dv->flag_acc, acc, sizeof(acc));
+  } else {
+    memset(dv->flag_acc, 0, sizeof(dv->flag_acc));
 
-  if (dir > 0) { /* charging */
-    if (diff > 0) {
-      if ((t - f->last_change_ms) >= min_step_ms) {
-        f->soc_display += 1;
-        f->last_change_ms = t;
-      }
-    } else { /* diff < 0 */
-      if ((-diff) >= big_jump) {
-        f->stable_cnt++;
-        if (f->stable_cnt >= 6 && (t - f->last_change_ms) >= min_step_ms) {
-          f->soc_display -= 1;
-          f->last_change_ms = t;
-          f->stable_cnt = 0;
-        }
-      } else {
-        f->stable_cnt = 0;
-      }
+    /* tam snapshot da coulomb counter icin bir ornek (okuma zamaniyla) */
+    bq25792_cc_update(&dv->cc, smp->t_ns, st.ibat_ma, st.vbat_mv);
+    bq25792_cc_on_status(&dv->cc, smp->t_ns, &st);
+    bq25792_stats_add(&dv->stats, smp->t_ns, st.vbat_mv, st.ibat_ma, st.vbus_mv, st.ibus_ma);
+
+    /* filtre saati ornegin okuma zamani (CLOCK_MONOTONIC) */
+    const int64_t t_ms = smp->t_ns / 1000000LL;
+    if (!dv->filt_inited) {
+      bq25792_socfilt_init(&dv->filt, &d->socfilt, st.soc_pct_est, t_ms);
+      dv->filt_inited = 1;
+    } else {
+      bq25792_socfilt_update(&dv->filt, st.soc_pct_est, bq25792_socfilt_dir(&dv->filt, st.ibat_ma), t_ms);
     }
-  } else if (dir < 0) { /* discharging */
-    if (diff < 0) {
-      if ((t - f->last_change_ms) >= min_step_ms) {
-        f->soc_display -= 1;
-        f->last_change_ms = t;
-      }
-    } else { /* diff > 0 */
-      if (diff >= big_jump) {
-        f->stable_cnt++;
-        if (f->stable_cnt >= 60 && (t - f->last_change_ms) >= (10 * min_step_ms)) {
-          f->soc_display += 1;
-          f->last_change_ms = t;
-          f->stable_cnt = 0;
-        }
-      } else {
-        f->stable_cnt = 0;
-      }
+  }
+
+  bq25792_snapshot_t *snap = &dv->snap;
+  memset(snap, 0, sizeof(*snap));
+  snap->ts_ms = smp->ts_ms;
+  snap->bus = dv->bus;
+  snap->addr = (uint8_t)dv->addr;
+  snap->trigger = smp->trigger;
+  snap->adc_pending = smp->adc_pending;
+  snap->st = st;
+  memcpy(dv->regs, smp->regs, sizeof(dv->regs));
+  dv->regs[BQ25792_REG22_CHG_FLAG_0] = st.chg_flag0;
+  dv->regs[BQ25792_REG23_CHG_FLAG_1] = st.chg_flag1;
+  dv->regs[BQ25792_REG24_CHG_FLAG_2] = st.chg_flag2;
+  dv->regs[BQ25792_REG25_CHG_FLAG_3] = st.chg_flag3;
+  dv->regs[BQ25792_REG26_FAULT_FLAG_0] = st.fault0;
+  dv->regs[BQ25792_REG27_FAULT_FLAG_1] = st.fault1;
+  if (smp->adc_pending) {
+    snap->st.soc_pct_est = -1;
+    snap->soc_pct = -1;
+    snap->soc_raw = -1;
+    snap->soc_filt = -1.0f;
+  } else {
+    snap->soc_pct = dv->filt.soc_display;
+    snap->soc_raw = st.soc_pct_est;
+    snap->soc_filt = dv->filt.soc_filt;
+  }
+  snap->soc_cc_pct = bq25792_cc_soc_pct(&dv->cc);
+  snap->charge_mah = bq25792_cc_charge_mah(&dv->cc);
+  snap->capacity_mah = bq25792_cc_capacity_mah(&dv->cc);
+  bqd_sampler_stats(bw->sampler, dv->sampler_dev, &snap->sampler);
+  bw->last_stats = snap->sampler;
+  dv->have_snap = 1;
+  const long long tnow = mono_ms();
+  dv->snap_mono_ms = tnow;
+
+  /* shm her ornekte guncellenir (okuyucu uyandirmaz, maliyeti yok) */
+  if (dv->shm) (void)bq25792_shm_publish(dv->shm, snap);
+
+  /* gecmis: her ornek ham ring'e + 1m/1h/1d aggregate'lere (O(1)) */
+  if (dv->hist && !smp->adc_pending) {
+    bq25792_hist_sample_t hs;
+    bq25792_history_sample_from(&hs, snap);
+    (void)bq25792_history_append(dv->hist, &hs);
+  }
+
+  int n = bq25792_snapshot_to_json(snap, dv->json, sizeof(dv->json));
+  if (n <= 0) return;
+  dv->json_len = n;
+  if (!multi(d)) bqd_server_set_latest(d->srv, dv->json, (size_t)n);
+
+  /* status.json ve abonelere push: sadece anlamli degisimde ya da heartbeat'te.
+     Coklu cihazda abonelere cihaz satiri yerine pack ozeti gider. */
+  if (bqd_publisher_check(&dv->pub, snap, tnow)) {
+    if (d->status_fmt & STATUS_FMT_JSON) {
+      if (atomic_write(dv->status_path, dv->json, (size_t)n) == 0) dv->metrics.status_writes++;
+      else dv->metrics.status_write_errors++;
+    }
+    if (d->status_fmt & STATUS_FMT_BIN) {
+      uint8_t bin[BQ25792_SNAPSHOT_BIN_LEN];
+      const int bn = bq25792_snapshot_to_bin(snap, bin, sizeof(bin));
+      if (bn > 0 && atomic_write(dv->status_bin_path, (const char*)bin, (size_t)bn) == 0) dv->metrics.status_writes++;
+      else dv->metrics.status_write_errors++;
+    }
+    if (multi(d)) {
+      publish_pack(d);
+    } else {
+      bqd_server_broadcast(d->srv, dv->json, (size_t)n);
+      d->metrics.broadcasts++;
+    }
+    bqd_publisher_commit(&dv->pub, snap, tnow);
+  }
+}
+
+/* Ogrenilen kapasite/kalan yuk: kalibrasyondan sonra hemen, yoksa 10 dk'da bir */
+#define CC_SAVE_PERIOD_MS (10LL * 60LL * 1000LL)
+
+static void cc_maybe_save(device_t *dv, int force) {
+  if (!dv->cc_state_path[0] || !dv->cc.valid) return;
+  const long long t = mono_ms();
+  if (!force && !dv->cc.dirty && (t - dv->cc_saved_ms) < CC_SAVE_PERIOD_MS) return;
+  (void)mkdir_p_for_file(dv->cc_state_path);
+  int rc = bq25792_cc_save(&dv->cc, dv->cc_state_path);
+  if (rc) fprintf(stderr, "bq25792d: cc state yazilamadi (%s): %s\n", dv->cc_state_path, strerror(-rc));
+  dv->cc_saved_ms = t;
+}
+
+/* Enerji/yuk sayaclari: ayni periyotla, sadece artis varsa (SD karta gereksiz yazim yok) */
+static void stats_maybe_save(device_t *dv, int force) {
+  if (!dv->stats_state_path[0] || !dv->stats.dirty) return;
+  const long long t = mono_ms();
+  if (!force && (t - dv->stats_saved_ms) < CC_SAVE_PERIOD_MS) return;
+  (void)mkdir_p_for_file(dv->stats_state_path);
+  int rc = bq25792_stats_save(&dv->stats, dv->stats_state_path);
+  if (rc) fprintf(stderr, "bq25792d: enerji sayaclari yazilamadi (%s): %s\n", dv->stats_state_path, strerror(-rc));
+  dv->stats_saved_ms = t;
+}
+
+static int render_metrics(daemon_t *d, char *buf, size_t len, int prom_text) {
+  bq25792_metrics_t lib[BQD_MAX_DEVICES];
+  bqd_sched_stats_t sched[BQD_MAX_DEVICES];
+  bq25792_energy_t energy[BQD_MAX_DEVICES];
+  bqd_metrics_dev_view_t dv[BQD_MAX_DEVICES];
+  bqd_metrics_bus_view_t bv[BQD_MAX_DEVICES];
+  for (int i = 0; i < d->ndev; i++) {
+    dv[i].d = &d->devs[i].metrics;
+    dv[i].sched = NULL;
+    dv[i].labels = d->devs[i].labels;
+    bq25792_stats_energy(&d->devs[i].stats, &energy[i]);
+    dv[i].energy = d->devs[i].stats.since_ms ? &energy[i] : NULL;
+    /* cihaz sampler thread'inde; sayaclar atomic, okumak guvenli */
+    dv[i].lib = (d->devs[i].dev && bq25792_get_metrics(d->devs[i].dev, &lib[i]) == 0) ? &lib[i] : NULL;
+  }
+  for (int i = 0; i < d->nworker; i++) {
+    bv[i].stats = &d->workers[i].last_stats;
+    bv[i].labels = d->workers[i].labels;
+    for (int k = 0; k < d->workers[i].ndev; k++) {
+      const int j = (int)(d->workers[i].devs[k] - d->devs);
+      bqd_sampler_sched_stats(d->workers[i].sampler, k, &sched[j]);
+      dv[j].sched = &sched[j];
     }
-  } else { /* idle */
-    if (abs(diff) >= 2) {
-      f->stable_cnt++;
-      if (f->stable_cnt >= 6 && (t - f->last_change_ms) >= min_step_ms) {
-        f->soc_display += (diff > 0) ? 1 : -1;
-        f->last_change_ms = t;
-        f->stable_cnt = 0;
+  }
+
+  bqd_metrics_view_t v;
+  memset(&v, 0, sizeof(v));
+  v.d = &d->metrics;
+  v.devs = dv;
+  v.ndev = d->ndev;
+  v.buses = bv;
+  v.nbus = d->nworker;
+  v.clients = bqd_server_client_count(d->srv);
+  return bqd_metrics_render(&v, buf, len, prom_text);
+}
+
+/* node_exporter textfile collector (Prometheus 0.0.4): BQ_METRICS_INTERVAL_SEC'de bir, atomik */
+static void metrics_maybe_write(daemon_t *d) {
+  if (!d->metrics_path) return;
+  const long long t = mono_ms();
+  if (d->metrics_written_ms && (t - d->metrics_written_ms) < d->metrics_interval_ms) return;
+  d->metrics_written_ms = t;
+
+  static char buf[METRICS_CAP(BQD_MAX_DEVICES)];
+  int n = render_metrics(d, buf, sizeof(buf), 1);
+  if (n <= 0) return;
+  int rc = atomic_write(d->metrics_path, buf, (size_t)n);
+  if (rc) fprintf(stderr, "bq25792d: metrics yazilamadi (%s): %s\n", d->metrics_path, strerror(-rc));
+}
+
+static device_t* find_device(daemon_t *d, int bus, int addr) {
+  for (int i = 0; i < d->ndev; i++) {
+    if (d->devs[i].bus == bus && d->devs[i].addr == addr) return &d->devs[i];
+  }
+  return NULL;
+}
+
+/* "events [seq]": journal'da seq'ten sonraki olaylar (NDJSON), sigdigi kadar;
+   son satir {"end":<son gonderilen seq>,"last_seq":<journal'daki son seq>} */
+static int events_reply(daemon_t *d, const char *arg, char *out, size_t len) {
+  static bq25792_event_t ev[BQ25792_JOURNAL_CAP];
+  const uint64_t after = (arg && *arg) ? strtoull(arg, NULL, 10) : 0;
+  const int n = bq25792_journal_read(&d->journal, after, ev, BQ25792_JOURNAL_CAP);
+  const size_t tail = 64;  /* bitis satiri icin */
+  if (len <= tail) return -ENOSPC;
+
+  size_t off = 0;
+  uint64_t end = after;
+  for (int i = 0; i < n; i++) {
+    int m = bq25792_event_to_json(&ev[i], out + off, len - tail - off);
+    if (m < 0) break;
+    off += (size_t)m;
+    end = ev[i].seq;
+  }
+  off += (size_t)snprintf(out + off, len - off, "{\"end\":%llu,\"last_seq\":%llu}\n",
+                          (unsigned long long)end, (unsigned long long)bq25792_journal_last_seq(&d->journal));
+  return (int)off;
+}
+
+/* "live" cevabi: son tam ornegin register imaji (hex, REG00..REG48); istemci
+   bq25792_decode_status/bq25792_regs_dump ile dogrudan okumadaki gibi cozer */
+static int live_reply(const device_t *dv, char *out, size_t len) {
+  static const char hex[] = "0123456789abcdef";
+  const size_t need = 128 + 2 * BQ25792_NREGS;
+  if (len < need) return -ENOSPC;
+  int n = snprintf(out, len, "{\"bus\":%d,\"addr\":\"0x%02x\",\"ts_ms\":%lld,\"age_ms\":%lld,\"trigger\":\"%s\",\"regs\":\"",
+                   dv->bus, dv->addr & 0xFF, (long long)dv->snap.ts_ms, mono_ms() - dv->snap_mono_ms,
+                   (dv->snap.trigger == BQ25792_TRIGGER_INT) ? "int" :
+                   (dv->snap.trigger == BQ25792_TRIGGER_LIVE) ? "live" : "timer");
+  size_t off = (size_t)n;
+  for (int r = 0; r < BQ25792_NREGS; r++) {
+    out[off++] = hex[dv->regs[r] >> 4];
+    out[off++] = hex[dv->regs[r] & 0xF];
+  }
+  memcpy(out + off, "\"}\n", 4);
+  return (int)off + 3;
+}
+
+/* "live [<bus>:<addr>] [max_age_ms]": son ornek max_age_ms'den (varsayilan
+   BQ_LIVE_FRESH_MS) tazeyse hemen cevaplanir; degilse cihazin sampler'indan tam
+   okuma istenir ve cevap ornek gelince verilir. Okuma surerken gelen istekler ayni
+   okumayi bekler (bus'a tek erisim). */
+static int live_command(daemon_t *d, const char *arg, char *out, size_t len) {
+  int bus = d->devs[0].bus, addr = d->devs[0].addr;
+  long long max_age = d->live_fresh_ms;
+  char tok[32];
+  int used;
+  while (arg && sscanf(arg, " %31s%n", tok, &used) == 1) {
+    arg += used;
+    if (strchr(tok, ':')) {
+      if (parse_devices(tok, &bus, &addr, 1) != 1) bus = -1;
+    } else {
+      max_age = strtoll(tok, NULL, 10);
+    }
+  }
+  device_t *dv = find_device(d, bus, addr);
+  if (!dv) return snprintf(out, len, "{\"error\":\"no such device\"}\n");
+  if (!dv->sampler) return snprintf(out, len, "{\"error\":\"device not open\"}\n");
+  dv->metrics.live_requests++;
+
+  if (dv->have_snap && mono_ms() - dv->snap_mono_ms <= max_age) {
+    dv->metrics.live_fresh++;
+    return live_reply(dv, out, len);
+  }
+  bqd_server_defer(d->srv, (int)(dv - d->devs));
+  if (!dv->live_req_ns) {
+    dv->live_req_ns = mono_ns();
+    dv->metrics.live_reads++;
+    bqd_sampler_request(dv->sampler, dv->sampler_dev);
+  }
+  return BQD_SERVER_DEFERRED;
+}
+
+/* Bekleyen "live" istekleri: istekten sonra biten ilk tam ornekle cevaplanir
+   (hizli baslangic ornegi degil; ADC'li okuma hemen arkasindan gelir) */
+static void live_complete(daemon_t *d, device_t *dv, const bqd_sample_t *smp) {
+  if (!dv->live_req_ns || smp->t_ns < dv->live_req_ns || smp->adc_pending) return;
+  dv->live_req_ns = 0;
+  char line[512];
+  int n;
+  if (smp->rc) n = snprintf(line, sizeof(line), "{\"error\":\"read failed: %s\"}\n", strerror(-smp->rc));
+  else n = live_reply(dv, line, sizeof(line));
+  if (n > 0) (void)bqd_server_complete(d->srv, (int)(dv - d->devs), line, (size_t)n);
+}
+
+/* "stats [<bus>:<addr>]": kayan pencere ozetleri (ortalama/min/max/std) ve
+   enerji/yuk sayaclari; pencereler sorgu anina gore kaydirilir */
+static int stats_reply(daemon_t *d, const char *arg, char *out, size_t len) {
+  int bus = d->devs[0].bus, addr = d->devs[0].addr;
+  if (arg && *arg && parse_devices(arg, &bus, &addr, 1) != 1) bus = -1;
+  device_t *dv = find_device(d, bus, addr);
+  if (!dv) return snprintf(out, len, "{\"error\":\"no such device\"}\n");
+  if (!dv->stats.samples) return snprintf(out, len, "{\"error\":\"no data yet\"}\n");
+
+  int n = snprintf(out, len, "{\"bus\":%d,\"addr\":\"0x%02x\",\"ts_ms\":%lld,\"samples\":%llu,\"gaps\":%llu,",
+                   dv->bus, dv->addr & 0xFF, now_ms(), (unsigned long long)dv->stats.samples,
+                   (unsigned long long)dv->stats.gaps);
+  if (n < 0 || (size_t)n >= len) return -ENOSPC;
+  size_t off = (size_t)n;
+  n = bq25792_stats_to_json(&dv->stats, mono_ns(), out + off, len - off);
+  if (n < 0) return n;
+  off += (size_t)n;
+  if (len - off < 3) return -ENOSPC;
+  memcpy(out + off, "}\n", 3);
+  return (int)off + 2;
+}
+
+/* socket: "metrics" -> OpenMetrics metni, "get <bus>:<addr>" -> tek cihazin son snapshot'i,
+   "regs [<bus>:<addr>]" -> son ornegin tam register/alan dokumu (JSON), "events [seq]",
+   "live [<bus>:<addr>] [max_age_ms]" -> taze register imaji, "stats [<bus>:<addr>]" */
+static int on_command(void *ctx, const char *cmd, char *out, size_t len) {
+  daemon_t *d = (daemon_t*)ctx;
+  if (strcmp(cmd, "metrics") == 0) return render_metrics(d, out, len, 0);
+  if (strncmp(cmd, "get ", 4) == 0) {
+    int bus, addr;
+    const device_t *dv = (parse_devices(cmd + 4, &bus, &addr, 1) == 1) ? find_device(d, bus, addr) : NULL;
+    if (!dv) return snprintf(out, len, "{\"error\":\"no such device\"}\n");
+    if (!dv->json_len) return snprintf(out, len, "{\"error\":\"no data yet\"}\n");
+    if ((size_t)dv->json_len > len) return -ENOSPC;
+    memcpy(out, dv->json, (size_t)dv->json_len);
+    return dv->json_len;
+  }
+  if (strcmp(cmd, "events") == 0 || strncmp(cmd, "events ", 7) == 0) {
+    return events_reply(d, cmd[6] ? cmd + 7 : NULL, out, len);
+  }
+  if (strcmp(cmd, "live") == 0 || strncmp(cmd, "live ", 5) == 0) {
+    return live_command(d, cmd + 4, out, len);
+  }
+  if (strcmp(cmd, "stats") == 0 || strncmp(cmd, "stats ", 6) == 0) {
+    return stats_reply(d, cmd[5] ? cmd + 6 : NULL, out, len);
+  }
+  if (strcmp(cmd, "regs") == 0 || strncmp(cmd, "regs ", 5) == 0) {
+    int bus = d->devs[0].bus, addr = d->devs[0].addr;
+    if (cmd[4] == ' ' && parse_devices(cmd + 5, &bus, &addr, 1) != 1) bus = -1;
+    const device_t *dv = find_device(d, bus, addr);
+    if (!dv) return snprintf(out, len, "{\"error\":\"no such device\"}\n");
+    if (!dv->have_snap) return snprintf(out, len, "{\"error\":\"no data yet\"}\n");
+    return bq25792_regs_dump(dv->regs, 0x00, BQ25792_NREGS - 1, BQ25792_DUMP_JSON, out, len);
+  }
+  return 0;
+}
+
+/* REG1B..REG27 okumasi (tam ornek ya da yoklama): flag'lar ve durum kenarlari
+   journal'a ve "events follow" abonelerine; gecikme okuma zamanindan olculur */
+static void on_events(daemon_t *d, device_t *dv, const bqd_sample_t *smp) {
+  bq25792_event_t ev[64];
+  int n = bq25792_events_detect(dv->have_ev_prev ? dv->ev_prev : NULL, smp->regs, ev, 64);
+  if (n > 64) n = 64;
+  memcpy(&dv->ev_prev[BQ25792_EVENT_WIN_FIRST], &smp->regs[BQ25792_EVENT_WIN_FIRST],
+         BQ25792_EVENT_WIN_LAST - BQ25792_EVENT_WIN_FIRST + 1);
+  dv->have_ev_prev = 1;
+
+  for (int i = 0; i < n; i++) {
+    ev[i].t_ns = smp->t_ns;
+    ev[i].ts_ms = smp->ts_ms;
+    ev[i].bus = dv->bus;
+    ev[i].addr = (uint8_t)dv->addr;
+    bq25792_journal_append(&d->journal, &ev[i]);
+    d->metrics.events++;
+    char line[256];
+    int len = bq25792_event_to_json(&ev[i], line, sizeof(line));
+    if (len > 0) bqd_server_broadcast_event(d->srv, line, (size_t)len);
+  }
+  if (n > 0) bq25792_hist_observe(&d->metrics.event_latency, (uint64_t)(mono_ns() - smp->t_ns));
+}
+
+/* systemd: acilan tum cihazlarin ilk okumasi bitip en az bir snapshot yayinlaninca
+   READY=1 (hizli baslangic ornegi yeterli); ADC'li snapshot'lar gelince STATUS guncellenir */
+static void notify_progress(daemon_t *d) {
+  if (d->ready == 2) return;
+  int nopen = 0, ndone = 0, nsnap = 0, nfull = 0;
+  for (int i = 0; i < d->ndev; i++) {
+    const device_t *dv = &d->devs[i];
+    if (!dv->dev) continue;
+    nopen++;
+    ndone += dv->first_done;
+    nsnap += dv->have_snap;
+    nfull += dv->have_snap && !dv->snap.adc_pending;
+  }
+  if (ndone < nopen || nsnap == 0) return;
+  const int all_full = (nfull == nsnap);
+  if (d->ready == 1 && !all_full) return;
+
+  char msg[128];
+  snprintf(msg, sizeof(msg), "%sSTATUS=%d/%d cihaz yayinda%s", d->ready ? "" : "READY=1\n",
+           nsnap, nopen, all_full ? "" : ", ADC bekleniyor");
+  (void)bqd_notify(msg);
+  d->ready = all_full ? 2 : 1;
+}
+
+/* Ring'i bosalt. BATT ornekleri sadece coulomb counter'a ve istatistiklere gider
+   (entegrasyon sampler'in okuma zamanlariyla yapilir, publisher gecikmesi hataya girmez). */
+static void on_sampler(daemon_t *d, bus_worker_t *bw) {
+  bqd_sampler_ack(bw->sampler);
+
+  bqd_sample_t smp;
+  while (bqd_sampler_pop(bw->sampler, &smp)) {
+    if (smp.dev >= bw->ndev) continue;
+    device_t *dv = bw->devs[smp.dev];
+    if (smp.kind == BQD_SAMPLE_FULL) {
+      const long long t0 = mono_ns();
+      if (smp.rc == 0) on_events(d, dv, &smp);
+      publish_sample(d, bw, dv, &smp);
+      live_complete(d, dv, &smp);
+      bq25792_hist_observe(&d->metrics.publish, (uint64_t)(mono_ns() - t0));
+    } else if (smp.kind == BQD_SAMPLE_EVENT) {
+      dv->metrics.samples_event++;
+      if (smp.rc) {
+        dv->metrics.sample_errors_event++;
+        continue;
       }
+      on_events(d, dv, &smp);
+      for (int r = 0; r < 6; r++) dv->flag_acc[r] |= smp.regs[BQ25792_REG22_CHG_FLAG_0 + r];
     } else {
-      f->stable_cnt = 0;
+      dv->metrics.samples_batt++;
+      if (smp.rc) {
+        dv->metrics.sample_errors_batt++;
+        continue;
+      }
+      bq25792_cc_update(&dv->cc, smp.t_ns, smp.ibat_ma, smp.vbat_mv);
+      bq25792_stats_add(&dv->stats, smp.t_ns, smp.vbat_mv, smp.ibat_ma, smp.vbus_mv, smp.ibus_ma);
     }
   }
+  for (int i = 0; i < bw->ndev; i++) {
+    cc_maybe_save(bw->devs[i], 0);
+    stats_maybe_save(bw->devs[i], 0);
+  }
+  metrics_maybe_write(d);
+  notify_progress(d);
+}
 
-  f->soc_display = clampi(f->soc_display, 0, 100);
+/* WatchdogSec/2'de bir keepalive; sadece tum sampler thread'leri planli uyanmalarina
+   yetisiyorsa. I2C'de takilan thread keepalive'i keser, systemd servisi yeniden baslatir. */
+static void on_watchdog(daemon_t *d) {
+  uint64_t exp;
+  (void)!read(d->w_wdog.fd, &exp, sizeof(exp));
+  const long long limit_ns = d->wdog_usec * 1000LL / 2;
+  for (int i = 0; i < d->nworker; i++) {
+    const long long late = bqd_sampler_overdue_ns(d->workers[i].sampler);
+    if (late > limit_ns) {
+      fprintf(stderr, "bq25792d: sampler takildi (bus=%d, %lld ms gecikme), watchdog beslenmiyor\n",
+              d->workers[i].bus, late / 1000000LL);
+      return;
+    }
+  }
+  (void)bqd_notify("WATCHDOG=1");
 }
 
-static void sleep_ms(int ms) {
-  struct timespec ts;
-  ts.tv_sec = ms / 1000;
-  ts.tv_nsec = (ms % 1000) * 1000000L;
-  nanosleep(&ts, NULL);
+/* INT kenari: holdoff'u sampler uygular (INT firtinasinda bus'i bogmamak icin).
+   Tek INT hatti tum cihazlarda wire-OR olabilir; her bus'a haber verilir. */
+static void on_irq(daemon_t *d) {
+  int r = bqd_evsrc_consume(&d->irq);
+  if (r < 0) {
+    fprintf(stderr, "bq25792d: INT kaynagi kapandi: %s, sadece timer ile devam\n", strerror(-r));
+    bqd_loop_del(d->epfd, &d->w_irq);
+    bqd_evsrc_close(&d->irq);
+    return;
+  }
+  if (r > 0) {
+    for (int i = 0; i < d->nworker; i++) bqd_sampler_kick(d->workers[i].sampler);
+  }
+}
+
+static void on_signal(daemon_t *d) {
+  struct signalfd_siginfo si;
+  while (read(d->w_signal.fd, &si, sizeof(si)) == (ssize_t)sizeof(si)) {
+    if (si.ssi_signo == SIGINT || si.ssi_signo == SIGTERM) d->stop = 1;
+  }
+}
+
+static int setup_loop(daemon_t *d) {
+  d->epfd = epoll_create1(EPOLL_CLOEXEC);
+  if (d->epfd < 0) return -errno;
+
+  sigset_t mask;
+  sigemptyset(&mask);
+  sigaddset(&mask, SIGINT);
+  sigaddset(&mask, SIGTERM);
+  sigprocmask(SIG_BLOCK, &mask, NULL);
+  signal(SIGPIPE, SIG_IGN);
+
+  d->w_signal.kind = BQD_W_SIGNAL;
+  d->w_signal.fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+  if (d->w_signal.fd < 0) return -errno;
+  int rc = bqd_loop_add(d->epfd, &d->w_signal, EPOLLIN);
+  if (rc) return rc;
+
+  for (int i = 0; i < d->nworker; i++) {
+    bus_worker_t *bw = &d->workers[i];
+    bw->w.kind = BQD_W_SAMPLER;
+    bw->w.fd = bqd_sampler_fd(bw->sampler);
+    rc = bqd_loop_add(d->epfd, &bw->w, EPOLLIN);
+    if (rc) return rc;
+  }
+
+  d->w_irq.kind = BQD_W_IRQ;
+  d->w_irq.fd = d->irq.fd;
+  if (d->irq.fd >= 0 && bqd_loop_add(d->epfd, &d->w_irq, EPOLLIN) != 0) {
+    bqd_evsrc_close(&d->irq);
+  }
+  return 0;
+}
+
+/* systemd WatchdogSec= ayarliysa yarisinda bir tetiklenen timerfd */
+static int setup_watchdog(daemon_t *d) {
+  d->wdog_usec = bqd_watchdog_usec();
+  if (d->wdog_usec <= 0) return 0;
+  d->w_wdog.kind = BQD_W_TIMER;
+  d->w_wdog.fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (d->w_wdog.fd < 0) return -errno;
+  const long long half = d->wdog_usec / 2;
+  struct itimerspec its;
+  memset(&its, 0, sizeof(its));
+  its.it_interval.tv_sec = (time_t)(half / 1000000LL);
+  its.it_interval.tv_nsec = (long)(half % 1000000LL) * 1000L;
+  its.it_value = its.it_interval;
+  if (timerfd_settime(d->w_wdog.fd, 0, &its, NULL) < 0) return -errno;
+  return bqd_loop_add(d->epfd, &d->w_wdog, EPOLLIN);
+}
+
+/* Acilan cihazlari bus'a gore grupla, bus basina bir sampler baslat */
+static int start_workers(daemon_t *d) {
+  for (int i = 0; i < d->ndev; i++) {
+    device_t *dv = &d->devs[i];
+    if (!dv->dev) continue;
+    bus_worker_t *bw = NULL;
+    for (int j = 0; j < d->nworker; j++) {
+      if (d->workers[j].bus == dv->bus) bw = &d->workers[j];
+    }
+    if (!bw) {
+      bw = &d->workers[d->nworker++];
+      bw->bus = dv->bus;
+      snprintf(bw->labels, sizeof(bw->labels), "bus=\"%d\"", dv->bus);
+    }
+    dv->sampler_dev = bw->ndev;
+    bw->devs[bw->ndev++] = dv;
+  }
+
+  /* Cihaz handle'lari bundan sonra sadece sampler thread'lerinde kullanilir.
+     Ilk tam ornekler hemen alinir, ring'de epoll dongusunu bekler. */
+  for (int j = 0; j < d->nworker; j++) {
+    bus_worker_t *bw = &d->workers[j];
+    bqd_sampler_config_t scfg;
+    memset(&scfg, 0, sizeof(scfg));
+    for (int k = 0; k < bw->ndev; k++) scfg.devs[k] = bw->devs[k]->dev;
+    scfg.ndev = bw->ndev;
+    scfg.interval_ms = d->interval_ms;
+    scfg.sched = d->sched;
+    scfg.int_holdoff_ms = d->int_holdoff_ms;
+    scfg.batt_hz = d->cc_hz;
+    scfg.event_hz = d->event_hz;
+    scfg.adc_channels = d->adc_channels;
+    scfg.rt_prio = d->rt_prio;
+    scfg.cpu = d->rt_cpu;
+    int rc = bqd_sampler_start(&bw->sampler, &scfg);
+    if (rc) {
+      fprintf(stderr, "bq25792d: sampler baslatilamadi (bus=%d): %s\n", bw->bus, strerror(-rc));
+      return rc;
+    }
+    for (int k = 0; k < bw->ndev; k++) bw->devs[k]->sampler = bw->sampler;
+  }
+  return 0;
+}
+
+/* Capture/replay transport'u varsa kapanista ozet (replay sapmalari, kayit hatalari) */
+static void log_transport_stats(const device_t *dv) {
+  bq25792_capreplay_stats_t rs;
+  bq25792_capture_stats_t cs;
+  if (bq25792_capreplay_get_stats(dv->dev, &rs) == 0) {
+    fprintf(stderr, "bq25792d: replay bus=%d addr=0x%02x: %llu/%llu islem eslesti, atlanan=%llu "
+            "goruntuden=%llu eslesmeyen=%llu\n", dv->bus, dv->addr & 0xFF,
+            (unsigned long long)rs.matched, (unsigned long long)rs.total, (unsigned long long)rs.skipped,
+            (unsigned long long)rs.shadow, (unsigned long long)rs.mismatched);
+  } else if (bq25792_capture_get_stats(dv->dev, &cs) == 0 && cs.write_errors) {
+    fprintf(stderr, "bq25792d: capture bus=%d addr=0x%02x: %llu chunk yazilamadi\n",
+            dv->bus, dv->addr & 0xFF, (unsigned long long)cs.write_errors);
+  }
 }
 
 int main(void) {
-  signal(SIGINT, on_sig);
-  signal(SIGTERM, on_sig);
+  static daemon_t d;
+  memset(&d, 0, sizeof(d));
+  d.epfd = -1;
+  d.w_signal.fd = -1;
+  d.w_wdog.fd = -1;
+
+  /* BQ_DEVICES="bus:addr,..." (en fazla 8) ya da tek cihaz: BQ_I2C_BUS/BQ_I2C_ADDR */
+  int bus[BQD_MAX_DEVICES], addr[BQD_MAX_DEVICES];
+  const char *devices = env_str("BQ_DEVICES", NULL);
+  if (devices) {
+    d.ndev = parse_devices(devices, bus, addr, BQD_MAX_DEVICES);
+    if (d.ndev <= 0) {
+      fprintf(stderr, "bq25792d: BQ_DEVICES gecersiz (\"%s\"): bus:addr[,bus:addr...], en fazla %d\n",
+              devices, BQD_MAX_DEVICES);
+      return 1;
+    }
+  } else {
+    d.ndev = 1;
+    bus[0] = env_int("BQ_I2C_BUS", 10);
+    addr[0] = env_int("BQ_I2C_ADDR", 0x6B);
+  }
+
+  d.interval_ms = (long long)env_int("BQ_INTERVAL_SEC", 10) * 1000LL;
+  d.int_holdoff_ms = env_int("BQ_INT_HOLDOFF_MS", 20);
+  /* "live" (bqctl status/raw): bu pencere icindeki ornek paylasilir */
+  d.live_fresh_ms = env_int("BQ_LIVE_FRESH_MS", 250);
 
-  const int bus = env_int("BQ_I2C_BUS", 10);
-  const int addr = env_int("BQ_I2C_ADDR", 0x6B);
-  const int interval_sec = env_int("BQ_INTERVAL_SEC", 10);
+  /* Tam ornek periyodu: BQ_SCHED=adaptive (varsayilan) ile durumdan; gecislerde
+     BQ_INTERVAL_MIN_MS, kararli durumda iki katina cikarak BQ_INTERVAL_MAX_SEC'e kadar.
+     BQ_SCHED=fixed: her zaman BQ_INTERVAL_SEC. BQ_SCHED verilmeyip BQ_INTERVAL_SEC
+     acikca ayarlandiysa fixed (ayar sessizce yok sayilmasin). */
+  const char *sched_s = env_str("BQ_SCHED", env_str("BQ_INTERVAL_SEC", NULL) ? "fixed" : "adaptive");
+  if (strcmp(sched_s, "fixed") == 0) {
+    bqd_sched_config_fixed(&d.sched, d.interval_ms);
+  } else {
+    if (strcmp(sched_s, "adaptive") != 0) {
+      fprintf(stderr, "bq25792d: BQ_SCHED gecersiz (\"%s\"), adaptive kullaniliyor\n", sched_s);
+    }
+    d.sched.min_ms = env_int("BQ_INTERVAL_MIN_MS", 1000);
+    d.sched.max_ms = (long long)env_int("BQ_INTERVAL_MAX_SEC", 60) * 1000LL;
+    d.sched.busy_ms = env_int("BQ_SCHED_BUSY_MS", 2000);
+    d.sched.ibat_step_ma = env_int("BQ_SCHED_IBAT_STEP_MA", 300);
+    d.sched.ibat_high_ma = env_int("BQ_SCHED_IBAT_HIGH_MA", 1500);
+    if (d.sched.min_ms < 100) d.sched.min_ms = 100;
+    if (d.sched.max_ms < d.sched.min_ms) d.sched.max_ms = d.sched.min_ms;
+  }
   const char *out_path = env_str("BQ_STATUS_PATH", "/run/bq25792/status.json");
+  const char *bin_path = env_str("BQ_STATUS_BIN_PATH", "/run/bq25792/status.bin");
+  /* BQ_STATUS_FORMAT: json (varsayilan), bin (bq25792_snapshot_to_bin) ya da both */
+  const char *fmt_s = env_str("BQ_STATUS_FORMAT", "json");
+  if (strcmp(fmt_s, "bin") == 0) d.status_fmt = STATUS_FMT_BIN;
+  else if (strcmp(fmt_s, "both") == 0) d.status_fmt = STATUS_FMT_JSON | STATUS_FMT_BIN;
+  else {
+    if (strcmp(fmt_s, "json") != 0) fprintf(stderr, "bq25792d: BQ_STATUS_FORMAT gecersiz (\"%s\"), json kullaniliyor\n", fmt_s);
+    d.status_fmt = STATUS_FMT_JSON;
+  }
+  d.pack_path = env_str("BQ_PACK_PATH", "/run/bq25792/pack.json");
+  const char *shm_path = env_str("BQ_SHM_PATH", BQ25792_SHM_DEFAULT_PATH);
+  const char *sock_path = env_str("BQ_SOCK_PATH", "/run/bq25792/bq25792.sock");
+  const char *hist_path = env_str("BQ_HISTORY_PATH", BQ25792_HISTORY_DEFAULT_PATH);
+  /* Kendi actigimiz soketin grubu (0660), off = sadece root */
+  const char *sock_group = env_str("BQ_SOCK_GROUP", "bq25792");
+  if (strcmp(sock_group, "off") == 0) sock_group = NULL;
+  const int max_clients = env_int("BQ_SOCK_MAX_CLIENTS", 512);
 
-  bq25792_dev_t *dev = NULL;
-  int rc = bq25792_open(&dev, bus, (uint8_t)addr);
-  if (rc) {
-    fprintf(stderr, "bq25792d: open failed (bus=%d addr=0x%02x): %s\n", bus, addr & 0xFF, strerror(-rc));
-    return 1;
+  /* OpenMetrics textfile (node_exporter), varsayilan kapali */
+  d.metrics_path = env_str("BQ_METRICS_PATH", NULL);
+  if (d.metrics_path && strcmp(d.metrics_path, "off") == 0) d.metrics_path = NULL;
+  d.metrics_interval_ms = (long long)env_int("BQ_METRICS_INTERVAL_SEC", 15) * 1000LL;
+  d.metrics.start_ts_ms = now_ms();
+
+  /* Coulomb counting: BQ_CC_HZ (0 = kapali, 1..100) hizinda VBAT/IBAT ornegi */
+  d.cc_hz = env_int("BQ_CC_HZ", 10);
+  if (d.cc_hz < 0) d.cc_hz = 0;
+  if (d.cc_hz > 100) d.cc_hz = 100;
+
+  /* BQ_ADC_CHANNELS: donusturulecek ADC kanallari ("status" = sadece snapshot'takiler,
+     TS/VAC/D+/D- kapanir), tanimsizsa cihazdaki ayar korunur */
+  const char *adc_s = env_str("BQ_ADC_CHANNELS", NULL);
+  if (adc_s && bq25792_adc_channels_parse(adc_s, &d.adc_channels) != 0) {
+    fprintf(stderr, "bq25792d: BQ_ADC_CHANNELS gecersiz (\"%s\"), yok sayiliyor\n", adc_s);
+    d.adc_channels = 0;
+  }
+
+  /* Ornekleme thread'leri: BQ_RT_PRIO>0 ise SCHED_FIFO, BQ_RT_CPU>=0 ise CPU sabitleme */
+  d.rt_prio = env_int("BQ_RT_PRIO", 0);
+  d.rt_cpu = env_int("BQ_RT_CPU", -1);
+
+  /* Gosterim SoC filtresi; sabitler bq25792_replay ile kayitli izler uzerinde ayarlanir */
+  bq25792_socfilt_config_default(&d.socfilt);
+  d.socfilt.alpha = env_float("BQ_SOC_ALPHA", d.socfilt.alpha);
+  d.socfilt.min_step_ms = env_int("BQ_SOC_STEP_SEC", d.socfilt.min_step_ms / 1000) * 1000;
+  d.socfilt.stable_chg = env_int("BQ_SOC_STABLE_CHG", d.socfilt.stable_chg);
+  d.socfilt.stable_dis = env_int("BQ_SOC_STABLE_DIS", d.socfilt.stable_dis);
+  d.socfilt.big_jump = env_int("BQ_SOC_BIG_JUMP", d.socfilt.big_jump);
+
+  bq25792_cc_config_t ccfg;
+  bq25792_cc_config_default(&ccfg);
+  ccfg.design_capacity_mah = env_float("BQ_CAPACITY_MAH", ccfg.design_capacity_mah);
+  ccfg.rest_current_ma = env_int("BQ_CC_REST_MA", ccfg.rest_current_ma);
+  ccfg.rest_time_s = env_int("BQ_CC_REST_SEC", ccfg.rest_time_s);
+  const char *cc_state_path = env_str("BQ_CC_STATE_PATH", "/var/lib/bq25792/soc_cc.state");
+  if (strcmp(cc_state_path, "off") == 0) cc_state_path = NULL;
+
+  /* Akan istatistik: BQ_STATS_WINDOWS kayan pencereleri (saniye), enerji/yuk sayaclari
+     BQ_ENERGY_STATE_PATH'e (off = sadece bellekte). Daha uzun ornek boslugu entegre edilmez. */
+  bq25792_stats_config_t scfg;
+  bq25792_stats_config_default(&scfg);
+  const char *win_s = env_str("BQ_STATS_WINDOWS", NULL);
+  if (win_s && bq25792_stats_config_parse_windows(&scfg, win_s) != 0) {
+    fprintf(stderr, "bq25792d: BQ_STATS_WINDOWS gecersiz (\"%s\"), varsayilan kullaniliyor\n", win_s);
+    bq25792_stats_config_default(&scfg);
   }
+  if (d.cc_hz == 0 && 2 * d.sched.max_ms > scfg.max_gap_ms) scfg.max_gap_ms = (int)(2 * d.sched.max_ms);
+  const char *energy_path = env_str("BQ_ENERGY_STATE_PATH", "/var/lib/bq25792/energy.state");
+  if (strcmp(energy_path, "off") == 0) energy_path = NULL;
+
+  /* status.json sadece anlamli degisimde (ya da BQ_MAX_STALE_SEC dolunca) yazilir */
+  bqd_deadband_t db;
+  db.mv = env_int("BQ_DB_MV", 20);
+  db.ma = env_int("BQ_DB_MA", 20);
+  db.tdie_c = env_float("BQ_DB_TDIE_C", 1.0f);
+  db.max_stale_ms = (long long)env_int("BQ_MAX_STALE_SEC", 60) * 1000LL;
 
-  soc_filter_t filt;
-  int filt_inited = 0;
+  /* Acilamayan cihaz atlanir (pack'te ok:false kalir); hicbiri acilmazsa cikis */
+  int nopen = 0;
+  for (int i = 0; i < d.ndev; i++) {
+    device_t *dv = &d.devs[i];
+    dv->bus = bus[i];
+    dv->addr = addr[i];
+    snprintf(dv->labels, sizeof(dv->labels), "bus=\"%d\",addr=\"0x%02x\"", dv->bus, dv->addr & 0xFF);
+    device_path(dv->status_path, sizeof(dv->status_path), out_path, dv, multi(&d));
+    device_path(dv->status_bin_path, sizeof(dv->status_bin_path), bin_path, dv, multi(&d));
+    if (cc_state_path) device_path(dv->cc_state_path, sizeof(dv->cc_state_path), cc_state_path, dv, multi(&d));
+    bqd_publisher_init(&dv->pub, &db);
+    bq25792_cc_init(&dv->cc, &ccfg);
+    if (dv->cc_state_path[0]) (void)bq25792_cc_load(&dv->cc, dv->cc_state_path);
+    if (energy_path) device_path(dv->stats_state_path, sizeof(dv->stats_state_path), energy_path, dv, multi(&d));
+    bq25792_stats_init(&dv->stats, &scfg);
+    if (dv->stats_state_path[0]) (void)bq25792_stats_load(&dv->stats, dv->stats_state_path);
 
-  while (!g_stop) {
-    bq25792_status_t st;
-    rc = bq25792_read_status(dev, &st, true);
+    int rc = bq25792_open(&dv->dev, dv->bus, (uint8_t)dv->addr);
     if (rc) {
-      fprintf(stderr, "bq25792d: read_status failed: %s\n", strerror(-rc));
-      sleep_ms(interval_sec * 1000);
+      fprintf(stderr, "bq25792d: open failed (bus=%d addr=0x%02x): %s\n", dv->bus, dv->addr & 0xFF, strerror(-rc));
+      dv->dev = NULL;
       continue;
     }
+    nopen++;
+  }
+  if (nopen == 0) return 1;
 
-    int dir = infer_dir(&st);
-    if (!filt_inited) {
-      soc_filter_init(&filt, st.soc_pct_est);
-      filt_inited = 1;
-    } else {
-      soc_filter_update(&filt, st.soc_pct_est, dir);
+  setup_evsrc(&d.irq);
+
+  /* Olay yoklamasi (REG1B..REG27, 13 byte): INT hatti varsa flag'lar zaten aninda
+     okunur, varsayilan kapali; yoksa 10 Hz (BQ_EVENT_HZ, 0 = sadece tam ornekler) */
+  bq25792_journal_init(&d.journal);
+  d.event_hz = env_int("BQ_EVENT_HZ", (d.irq.fd >= 0) ? 0 : 10);
+  if (d.event_hz < 0) d.event_hz = 0;
+  if (d.event_hz > 100) d.event_hz = 100;
+
+  int rc = start_workers(&d);
+  if (rc) return 1;
+
+  rc = setup_loop(&d);
+  if (rc) {
+    fprintf(stderr, "bq25792d: epoll kurulamadi: %s\n", strerror(-rc));
+    return 1;
+  }
+  rc = setup_watchdog(&d);
+  if (rc) fprintf(stderr, "bq25792d: watchdog timer kurulamadi: %s\n", strerror(-rc));
+
+  for (int i = 0; i < d.ndev; i++) {
+    device_t *dv = &d.devs[i];
+    if (!dv->dev) continue;
+    char path[512];
+
+    /* BQ_SHM_PATH=off ile kapatilabilir */
+    if (strcmp(shm_path, "off") != 0) {
+      device_path(path, sizeof(path), shm_path, dv, multi(&d));
+      (void)mkdir_p_for_file(path);
+      rc = bq25792_shm_create(&dv->shm, path);
+      if (rc) fprintf(stderr, "bq25792d: shm olusturulamadi (%s): %s\n", path, strerror(-rc));
+    }
+
+    /* BQ_HISTORY_PATH=off ile kapatilabilir */
+    if (strcmp(hist_path, "off") != 0) {
+      device_path(path, sizeof(path), hist_path, dv, multi(&d));
+      (void)mkdir_p_for_file(path);
+      rc = bq25792_history_open(&dv->hist, path, true);
+      if (rc) fprintf(stderr, "bq25792d: history acilamadi (%s): %s\n", path, strerror(-rc));
     }
+  }
 
-    char json[1024];
-    long long tms = now_ms();
-    int n = snprintf(json, sizeof(json),
-      "{"
-        "\"ts_ms\":%lld,"
-        "\"bus\":%d,"
-        "\"addr\":\"0x%02x\","
-        "\"vbus_present\":%s,"
-        "\"pg\":%s,"
-        "\"chg_stat\":%u,"
-        "\"chg_stat_str\":\"%s\","
-        "\"vbus_stat\":%u,"
-        "\"vbus_stat_str\":\"%s\","
-        "\"fault_any\":%s,"
-        "\"fault0\":%u,"
-        "\"fault1\":%u,"
-        "\"vbat_mv\":%d,"
-        "\"vsys_mv\":%d,"
-        "\"vbus_mv\":%d,"
-        "\"ibat_ma\":%d,"
-        "\"ibus_ma\":%d,"
-        "\"tdie_c\":%.1f,"
-        "\"cell_count\":%u,"
-        "\"soc_pct\":%d,"
-        "\"soc_raw\":%d,"
-        "\"soc_filt\":%.2f"
-      "}\n",
-      tms,
-      bus,
-      addr & 0xFF,
-      st.vbus_present ? "true" : "false",
-      st.pg ? "true" : "false",
-      st.chg_stat,
-      bq25792_chg_stat_str(st.chg_stat),
-      st.vbus_stat,
-      bq25792_vbus_stat_str(st.vbus_stat),
-      st.fault_any ? "true" : "false",
-      (unsigned)st.fault0,
-      (unsigned)st.fault1,
-      st.vbat_mv,
-      st.vsys_mv,
-      st.vbus_mv,
-      st.ibat_ma,
-      st.ibus_ma,
-      st.tdie_c,
-      (unsigned)st.cell_count,
-      filt.soc_display,
-      st.soc_pct_est,
-      (double)filt.soc_filt
-    );
-
-    if (n > 0 && (size_t)n < sizeof(json)) {
-      (void)atomic_write(out_path, json, (size_t)n);
+  /* Socket activation (bq25792d.socket): systemd'nin actigi soket devralinir; daemon
+     baslarken baglanan istemciler backlog'da bekler. Yoksa BQ_SOCK_PATH (off = kapali). */
+  const int listen_fd = bqd_listen_fd();
+  if (listen_fd >= 0) {
+    rc = bqd_server_open_fd(&d.srv, d.epfd, listen_fd, max_clients, METRICS_CAP(d.ndev));
+    if (rc) {
+      fprintf(stderr, "bq25792d: devralinan socket kullanilamadi: %s\n", strerror(-rc));
+      close(listen_fd);
     }
+    bqd_server_set_command_handler(d.srv, on_command, &d);
+  } else if (strcmp(sock_path, "off") != 0) {
+    (void)mkdir_p_for_file(sock_path);
+    rc = bqd_server_open(&d.srv, d.epfd, sock_path, sock_group, max_clients, METRICS_CAP(d.ndev));
+    if (rc) fprintf(stderr, "bq25792d: socket acilamadi (%s): %s\n", sock_path, strerror(-rc));
+    bqd_server_set_command_handler(d.srv, on_command, &d);
+  }
 
-    sleep_ms(interval_sec * 1000);
+  struct epoll_event evs[64];
+  while (!d.stop) {
+    int n = epoll_wait(d.epfd, evs, 64, -1);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      fprintf(stderr, "bq25792d: epoll_wait: %s\n", strerror(errno));
+      break;
+    }
+    const long long t0 = mono_ns();
+    d.metrics.loop_iterations++;
+    for (int i = 0; i < n && !d.stop; i++) {
+      bqd_watch_t *w = (bqd_watch_t*)evs[i].data.ptr;
+      switch (w->kind) {
+        case BQD_W_SAMPLER: on_sampler(&d, (bus_worker_t*)w); break;
+        case BQD_W_SIGNAL: on_signal(&d); break;
+        case BQD_W_IRQ:    on_irq(&d); break;
+        case BQD_W_TIMER:  on_watchdog(&d); break;
+        case BQD_W_LISTEN:
+        case BQD_W_CLIENT: bqd_server_handle(d.srv, w, evs[i].events); break;
+      }
+    }
+    bqd_server_reap(d.srv);
+    bq25792_hist_observe(&d.metrics.loop, (uint64_t)(mono_ns() - t0));
   }
 
-  bq25792_close(dev);
+  (void)bqd_notify("STOPPING=1");
+  for (int j = 0; j < d.nworker; j++) bqd_sampler_stop(d.workers[j].sampler);
+  for (int i = 0; i < d.ndev; i++) {
+    cc_maybe_save(&d.devs[i], 1);
+    stats_maybe_save(&d.devs[i], 1);
+  }
+  bqd_server_close(d.srv);
+  for (int i = 0; i < d.ndev; i++) {
+    bq25792_history_close(d.devs[i].hist);
+    bq25792_shm_close(d.devs[i].shm);
+  }
+  bqd_evsrc_close(&d.irq);
+  if (d.w_signal.fd >= 0) close(d.w_signal.fd);
+  if (d.w_wdog.fd >= 0) close(d.w_wdog.fd);
+  if (d.epfd >= 0) close(d.epfd);
+  for (int i = 0; i < d.ndev; i++) {
+    log_transport_stats(&d.devs[i]);
+    bq25792_close(d.devs[i].dev);
+  }
   return 0;
 }
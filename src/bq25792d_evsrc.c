@@ -0,0 +1,94 @@
+#include "bq25792d_evsrc.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/gpio.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+void bqd_evsrc_init(bqd_evsrc_t *es) {
+  es->kind = BQD_EVSRC_NONE;
+  es->fd = -1;
+}
+
+static int set_nonblock(int fd) {
+  int fl = fcntl(fd, F_GETFL);
+  if (fl < 0 || fcntl(fd, F_SETFL, fl | O_NONBLOCK) < 0) return -errno;
+  return 0;
+}
+
+int bqd_evsrc_open_gpio(bqd_evsrc_t *es, const char *chip, unsigned line) {
+  if (!es || !chip) return -EINVAL;
+
+  char path[64];
+  if (chip[0] == '/') snprintf(path, sizeof(path), "%s", chip);
+  else snprintf(path, sizeof(path), "/dev/%s", chip);
+
+  int cfd = open(path, O_RDWR | O_CLOEXEC);
+  if (cfd < 0) return -errno;
+
+  /* INT open-drain, aktif low: falling edge */
+  struct gpio_v2_line_request req;
+  memset(&req, 0, sizeof(req));
+  req.offsets[0] = line;
+  req.num_lines = 1;
+  snprintf(req.consumer, sizeof(req.consumer), "bq25792d");
+  req.config.flags = GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_FALLING |
+                     GPIO_V2_LINE_FLAG_BIAS_PULL_UP;
+
+  int r = ioctl(cfd, GPIO_V2_GET_LINE_IOCTL, &req);
+  if (r < 0) {
+    /* Bias desteklemeyen controller: harici pull-up varsayip tekrar dene */
+    req.config.flags &= ~(uint64_t)GPIO_V2_LINE_FLAG_BIAS_PULL_UP;
+    r = ioctl(cfd, GPIO_V2_GET_LINE_IOCTL, &req);
+  }
+  int e = -errno;
+  close(cfd);
+  if (r < 0) return e;
+
+  (void)fcntl(req.fd, F_SETFD, FD_CLOEXEC);
+  (void)set_nonblock(req.fd);
+  es->kind = BQD_EVSRC_GPIO;
+  es->fd = req.fd;
+  return 0;
+}
+
+int bqd_evsrc_open_fd(bqd_evsrc_t *es, int fd) {
+  if (!es || fd < 0) return -EINVAL;
+  int rc = set_nonblock(fd);
+  if (rc) return rc;
+  es->kind = BQD_EVSRC_FD;
+  es->fd = fd;
+  return 0;
+}
+
+/* Bekleyen tum olaylari oku: INT pulse'lari bir okumada birlesir.
+   Buffer hem gpio_v2_line_event hem eventfd (8 byte) okumasina uygun. */
+int bqd_evsrc_consume(bqd_evsrc_t *es) {
+  if (!es || es->fd < 0) return -EBADF;
+
+  struct gpio_v2_line_event evs[16];
+  int got = 0;
+  for (;;) {
+    ssize_t n = read(es->fd, evs, sizeof(evs));
+    if (n > 0) {
+      got = 1;
+      continue;
+    }
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+    /* EOF (pipe yazan taraf kapandi) ya da hata */
+    return got ? 1 : ((n == 0) ? -EPIPE : -errno);
+  }
+  return got;
+}
+
+void bqd_evsrc_close(bqd_evsrc_t *es) {
+  if (!es) return;
+  if (es->fd >= 0) close(es->fd);
+  es->fd = -1;
+  es->kind = BQD_EVSRC_NONE;
+}
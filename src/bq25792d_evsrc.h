@@ -0,0 +1,29 @@
+#pragma once
+/* bq25792d olay kaynagi: BQ25792 INT hatti (GPIO character device) ya da
+   test icin disaridan verilen bir fd (eventfd/pipe). Kaynak yoksa sadece timer. */
+
+typedef enum {
+  BQD_EVSRC_NONE = 0,
+  BQD_EVSRC_GPIO,   /* /dev/gpiochipN line event (falling edge) */
+  BQD_EVSRC_FD,     /* eventfd / pipe: her yazma bir "kenar" sayilir */
+} bqd_evsrc_kind_t;
+
+typedef struct {
+  bqd_evsrc_kind_t kind;
+  int fd;           /* poll edilen fd, -1 = yok */
+} bqd_evsrc_t;
+
+void bqd_evsrc_init(bqd_evsrc_t *es);
+
+/* chip: "/dev/gpiochip0" ya da "gpiochip0"; line: chip uzerindeki offset */
+int  bqd_evsrc_open_gpio(bqd_evsrc_t *es, const char *chip, unsigned line);
+
+/* Hazir bir fd'yi olay kaynagi olarak kullan (sahipligi alinir) */
+int  bqd_evsrc_open_fd(bqd_evsrc_t *es, int fd);
+
+/* es->fd hazir oldugunda (epoll) cagrilir; bekleyen tum olaylari tuketir.
+   1: en az bir kenar, 0: olay yok, <0: kaynak kullanilamaz (pipe kapandi vb.),
+   cagiran epoll'dan cikarip bqd_evsrc_close() yapmali. */
+int  bqd_evsrc_consume(bqd_evsrc_t *es);
+
+void bqd_evsrc_close(bqd_evsrc_t *es);
@@ -0,0 +1,35 @@
+#pragma once
+/* bq25792d epoll dongusu: epoll'a kayitli her nesne bqd_watch_t ile baslar,
+   epoll_event.data.ptr ona isaret eder; dongu kind'a gore dagitir. */
+
+#include <errno.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+
+typedef enum {
+  BQD_W_SAMPLER = 0, /* sampler ring'inde yeni ornek (eventfd) */
+  BQD_W_SIGNAL,      /* signalfd: SIGINT/SIGTERM */
+  BQD_W_IRQ,         /* BQ25792 INT olay kaynagi */
+  BQD_W_LISTEN,      /* unix socket listener */
+  BQD_W_CLIENT,      /* bagli istemci */
+  BQD_W_TIMER,       /* timerfd: systemd watchdog keepalive */
+} bqd_watch_kind_t;
+
+typedef struct {
+  int fd;
+  bqd_watch_kind_t kind;
+} bqd_watch_t;
+
+static inline int bqd_loop_add(int epfd, bqd_watch_t *w, uint32_t events) {
+  struct epoll_event ev = { .events = events, .data.ptr = w };
+  return (epoll_ctl(epfd, EPOLL_CTL_ADD, w->fd, &ev) < 0) ? -errno : 0;
+}
+
+static inline int bqd_loop_mod(int epfd, bqd_watch_t *w, uint32_t events) {
+  struct epoll_event ev = { .events = events, .data.ptr = w };
+  return (epoll_ctl(epfd, EPOLL_CTL_MOD, w->fd, &ev) < 0) ? -errno : 0;
+}
+
+static inline void bqd_loop_del(int epfd, bqd_watch_t *w) {
+  (void)epoll_ctl(epfd, EPOLL_CTL_DEL, w->fd, NULL);
+}
@@ -0,0 +1,173 @@
+#include "bq25792d_metrics.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#define OM(call) do { int rc_ = (call); if (rc_) return rc_; } while (0)
+
+static const char* lb_kind(char *kl, size_t len, const char *lb, const char *kind) {
+  snprintf(kl, len, "%s%skind=\"%s\"", lb ? lb : "", (lb && *lb) ? "," : "", kind);
+  return kl;
+}
+
+static const char* lb_dir(char *kl, size_t len, const char *lb, const char *path, const char *dir) {
+  snprintf(kl, len, "%s%s%s%s%sdir=\"%s\"", lb ? lb : "", (lb && *lb) ? "," : "",
+           path ? "path=\"" : "", path ? path : "", path ? "\"," : "", dir);
+  return kl;
+}
+
+static const char* lb_state(char *kl, size_t len, const char *lb, int state) {
+  snprintf(kl, len, "%s%sstate=\"%s\"", lb ? lb : "", (lb && *lb) ? "," : "", bqd_sched_state_str(state));
+  return kl;
+}
+
+/* Cihaz basina counter ailesi: tek baslik, cihaz sayisi kadar seri */
+#define DEV_COUNTER(family, help, field) do { \
+    OM(bq25792_om_family(om, family, "counter", help)); \
+    for (int i = 0; i < v->ndev; i++) \
+      OM(bq25792_om_sample(om, family "_total", v->devs[i].labels, (double)v->devs[i].d->field)); \
+  } while (0)
+
+int bqd_metrics_render(const bqd_metrics_view_t *v, char *buf, size_t len, int prom_text) {
+  const bqd_metrics_t *m = v->d;
+  bq25792_om_t o;
+  bq25792_om_t *om = &o;
+  bq25792_om_init(om, buf, len, prom_text);
+
+  /* kutuphane metrikleri sadece handle'i acik cihazlar icin */
+  const bq25792_metrics_t *lib[64];
+  const char *lib_lb[64];
+  int nlib = 0;
+  for (int i = 0; i < v->ndev && nlib < 64; i++) {
+    if (!v->devs[i].lib) continue;
+    lib[nlib] = v->devs[i].lib;
+    lib_lb[nlib++] = v->devs[i].labels;
+  }
+  if (nlib) OM(bq25792_metrics_openmetrics(om, lib, lib_lb, nlib));
+
+  OM(bq25792_om_family(om, "bq25792d_loop_iterations", "counter", "epoll_wait wakeups"));
+  OM(bq25792_om_sample(om, "bq25792d_loop_iterations_total", NULL, (double)m->loop_iterations));
+  OM(bq25792_om_family(om, "bq25792d_loop_seconds", "histogram", "Event processing time per wakeup"));
+  OM(bq25792_om_histogram(om, "bq25792d_loop_seconds", NULL, &m->loop));
+  OM(bq25792_om_family(om, "bq25792d_publish_seconds", "histogram", "Full sample publish time"));
+  OM(bq25792_om_histogram(om, "bq25792d_publish_seconds", NULL, &m->publish));
+
+  char kl[256];
+  OM(bq25792_om_family(om, "bq25792d_samples", "counter", "Samples received from the sampler thread"));
+  for (int i = 0; i < v->ndev; i++) {
+    const bqd_dev_metrics_t *dm = v->devs[i].d;
+    OM(bq25792_om_sample(om, "bq25792d_samples_total", lb_kind(kl, sizeof(kl), v->devs[i].labels, "full"),
+                         (double)dm->samples_full));
+    OM(bq25792_om_sample(om, "bq25792d_samples_total", lb_kind(kl, sizeof(kl), v->devs[i].labels, "batt"),
+                         (double)dm->samples_batt));
+    OM(bq25792_om_sample(om, "bq25792d_samples_total", lb_kind(kl, sizeof(kl), v->devs[i].labels, "event"),
+                         (double)dm->samples_event));
+  }
+
+  OM(bq25792_om_family(om, "bq25792d_sample_errors", "counter", "Samples that failed on the bus"));
+  for (int i = 0; i < v->ndev; i++) {
+    const bqd_dev_metrics_t *dm = v->devs[i].d;
+    OM(bq25792_om_sample(om, "bq25792d_sample_errors_total", lb_kind(kl, sizeof(kl), v->devs[i].labels, "full"),
+                         (double)dm->sample_errors_full));
+    OM(bq25792_om_sample(om, "bq25792d_sample_errors_total", lb_kind(kl, sizeof(kl), v->devs[i].labels, "batt"),
+                         (double)dm->sample_errors_batt));
+    OM(bq25792_om_sample(om, "bq25792d_sample_errors_total", lb_kind(kl, sizeof(kl), v->devs[i].labels, "event"),
+                         (double)dm->sample_errors_event));
+  }
+
+  DEV_COUNTER("bq25792d_status_writes", "status.json writes", status_writes);
+  DEV_COUNTER("bq25792d_status_write_errors", "Failed status.json writes", status_write_errors);
+  DEV_COUNTER("bq25792d_live_requests", "Live read requests from socket clients", live_requests);
+  DEV_COUNTER("bq25792d_live_fresh", "Live requests answered from a sample within the freshness window", live_fresh);
+  DEV_COUNTER("bq25792d_live_reads", "Bus reads triggered by live requests", live_reads);
+  OM(bq25792_om_family(om, "bq25792d_broadcasts", "counter", "Snapshots pushed to subscribers"));
+  OM(bq25792_om_sample(om, "bq25792d_broadcasts_total", NULL, (double)m->broadcasts));
+  OM(bq25792_om_family(om, "bq25792d_events", "counter", "Flag/status events added to the journal"));
+  OM(bq25792_om_sample(om, "bq25792d_events_total", NULL, (double)m->events));
+  OM(bq25792_om_family(om, "bq25792d_event_latency_seconds", "histogram", "Event register read to subscriber push"));
+  OM(bq25792_om_histogram(om, "bq25792d_event_latency_seconds", NULL, &m->event_latency));
+
+  OM(bq25792_om_family(om, "bq25792d_sampler_overruns", "counter", "Sampler ticks missed"));
+  for (int i = 0; i < v->nbus; i++)
+    OM(bq25792_om_sample(om, "bq25792d_sampler_overruns_total", v->buses[i].labels,
+                         (double)v->buses[i].stats->overruns));
+  OM(bq25792_om_family(om, "bq25792d_sampler_drops", "counter", "Samples dropped on a full ring"));
+  for (int i = 0; i < v->nbus; i++)
+    OM(bq25792_om_sample(om, "bq25792d_sampler_drops_total", v->buses[i].labels,
+                         (double)v->buses[i].stats->drops));
+  OM(bq25792_om_family(om, "bq25792d_sampler_jitter_max_seconds", "gauge", "Worst wakeup lateness, last window"));
+  for (int i = 0; i < v->nbus; i++)
+    OM(bq25792_om_sample(om, "bq25792d_sampler_jitter_max_seconds", v->buses[i].labels,
+                         v->buses[i].stats->jitter_max_us / 1e6));
+
+  /* uyarlamali ornekleme: durum basina kalis ve ornek sayisi, su anki periyot */
+  OM(bq25792_om_family(om, "bq25792d_sched_dwell_seconds", "counter", "Time spent per charger state"));
+  for (int i = 0; i < v->ndev; i++) {
+    const bqd_sched_stats_t *ss = v->devs[i].sched;
+    if (!ss) continue;
+    for (int k = 0; k < BQD_SCHED_NSTATES; k++) {
+      OM(bq25792_om_sample(om, "bq25792d_sched_dwell_seconds_total", lb_state(kl, sizeof(kl), v->devs[i].labels, k),
+                           ss->dwell_ms[k] / 1e3));
+    }
+  }
+  OM(bq25792_om_family(om, "bq25792d_sched_samples", "counter", "Full samples taken per charger state"));
+  for (int i = 0; i < v->ndev; i++) {
+    const bqd_sched_stats_t *ss = v->devs[i].sched;
+    if (!ss) continue;
+    for (int k = 0; k < BQD_SCHED_NSTATES; k++) {
+      OM(bq25792_om_sample(om, "bq25792d_sched_samples_total", lb_state(kl, sizeof(kl), v->devs[i].labels, k),
+                           (double)ss->samples[k]));
+    }
+  }
+  OM(bq25792_om_family(om, "bq25792d_sched_transients", "counter", "Samples that reset the period to the minimum"));
+  for (int i = 0; i < v->ndev; i++)
+    if (v->devs[i].sched)
+      OM(bq25792_om_sample(om, "bq25792d_sched_transients_total", v->devs[i].labels,
+                           (double)v->devs[i].sched->transients));
+  OM(bq25792_om_family(om, "bq25792d_sched_interval_seconds", "gauge", "Current full sample period"));
+  for (int i = 0; i < v->ndev; i++)
+    if (v->devs[i].sched)
+      OM(bq25792_om_sample(om, "bq25792d_sched_interval_seconds", v->devs[i].labels,
+                           v->devs[i].sched->interval_ms / 1e3));
+
+  /* enerji/yuk sayaclari (kalici, bq25792_stats): pil ve giris yonlerine ayri */
+  OM(bq25792_om_family(om, "bq25792d_energy_joules", "counter", "Integrated battery and input energy"));
+  for (int i = 0; i < v->ndev; i++) {
+    const bq25792_energy_t *e = v->devs[i].energy;
+    if (!e) continue;
+    OM(bq25792_om_sample(om, "bq25792d_energy_joules_total", lb_dir(kl, sizeof(kl), v->devs[i].labels, "bat", "in"),
+                         e->wh[BQ25792_E_BAT_IN] * 3600.0));
+    OM(bq25792_om_sample(om, "bq25792d_energy_joules_total", lb_dir(kl, sizeof(kl), v->devs[i].labels, "bat", "out"),
+                         e->wh[BQ25792_E_BAT_OUT] * 3600.0));
+    OM(bq25792_om_sample(om, "bq25792d_energy_joules_total", lb_dir(kl, sizeof(kl), v->devs[i].labels, "bus", "in"),
+                         e->wh[BQ25792_E_BUS_IN] * 3600.0));
+    OM(bq25792_om_sample(om, "bq25792d_energy_joules_total", lb_dir(kl, sizeof(kl), v->devs[i].labels, "bus", "out"),
+                         e->wh[BQ25792_E_BUS_OUT] * 3600.0));
+  }
+  OM(bq25792_om_family(om, "bq25792d_charge_coulombs", "counter", "Integrated battery charge"));
+  for (int i = 0; i < v->ndev; i++) {
+    const bq25792_energy_t *e = v->devs[i].energy;
+    if (!e) continue;
+    OM(bq25792_om_sample(om, "bq25792d_charge_coulombs_total", lb_dir(kl, sizeof(kl), v->devs[i].labels, NULL, "in"),
+                         e->ah[BQ25792_Q_BAT_IN] * 3600.0));
+    OM(bq25792_om_sample(om, "bq25792d_charge_coulombs_total", lb_dir(kl, sizeof(kl), v->devs[i].labels, NULL, "out"),
+                         e->ah[BQ25792_Q_BAT_OUT] * 3600.0));
+  }
+
+  OM(bq25792_om_family(om, "bq25792d_clients", "gauge", "Connected socket clients"));
+  OM(bq25792_om_sample(om, "bq25792d_clients", NULL, (double)v->clients));
+  OM(bq25792_om_family(om, "bq25792d_start_time_seconds", "gauge", "Daemon start time"));
+  OM(bq25792_om_sample(om, "bq25792d_start_time_seconds", NULL, m->start_ts_ms / 1e3));
+  OM(bq25792_om_family(om, "bq25792d_last_sample_time_seconds", "gauge", "Last successful full sample"));
+  for (int i = 0; i < v->ndev; i++)
+    OM(bq25792_om_sample(om, "bq25792d_last_sample_time_seconds", v->devs[i].labels,
+                         v->devs[i].d->last_ok_ts_ms / 1e3));
+
+  if (!prom_text) {
+    if (om->len - om->off < sizeof("# EOF\n")) return -ENOSPC;
+    memcpy(om->buf + om->off, "# EOF\n", sizeof("# EOF\n"));
+    om->off += sizeof("# EOF\n") - 1;
+  }
+  return (int)om->off;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bq25792.h"
+#include "bq25792_metrics.h"
+#include "bq25792_stats.h"
+#include "bq25792d_sched.h"
+
+/*
+  Daemon sagligi (sadece epoll thread'i yazar): dongu ve yayin sureleri,
+  ornek/yazma sayaclari. Kutuphane I2C metrikleriyle birlikte OpenMetrics
+  olarak node_exporter textfile'ina ve socket "metrics" komutuna verilir.
+*/
+typedef struct {
+  uint64_t loop_iterations;
+  bq25792_hist_t loop;            /* epoll olaylarinin islenme suresi */
+  bq25792_hist_t publish;         /* tam ornek -> shm/history/status.json/socket */
+  uint64_t broadcasts;
+  uint64_t events;                /* journal'a eklenen olaylar */
+  bq25792_hist_t event_latency;   /* olay okunmasi -> abonelere push */
+  int64_t start_ts_ms;
+} bqd_metrics_t;
+
+/* Cihaz basina (coklu cihazda bus/addr etiketiyle ayri seriler) */
+typedef struct {
+  uint64_t samples_full;
+  uint64_t samples_batt;
+  uint64_t sample_errors_full;
+  uint64_t sample_errors_batt;
+  uint64_t samples_event;
+  uint64_t sample_errors_event;
+  uint64_t status_writes;
+  uint64_t status_write_errors;
+  uint64_t live_requests;         /* socket "live" istekleri */
+  uint64_t live_fresh;            /* tazelik penceresindeki son ornekle cevaplanan */
+  uint64_t live_reads;            /* istek icin yapilan tam okumalar (esit zamanlilar paylasir) */
+  int64_t last_ok_ts_ms;          /* son basarili tam ornek (CLOCK_REALTIME) */
+} bqd_dev_metrics_t;
+
+typedef struct {
+  const bqd_dev_metrics_t *d;
+  const bq25792_metrics_t *lib;   /* NULL olabilir */
+  const bqd_sched_stats_t *sched; /* NULL olabilir */
+  const bq25792_energy_t *energy; /* NULL olabilir */
+  const char *labels;             /* ornegin bus="10",addr="0x6b" */
+} bqd_metrics_dev_view_t;
+
+typedef struct {
+  const bq25792_sampler_stats_t *stats;
+  const char *labels;             /* ornegin bus="10" */
+} bqd_metrics_bus_view_t;
+
+typedef struct {
+  const bqd_metrics_t *d;
+  const bqd_metrics_dev_view_t *devs;
+  int ndev;
+  const bqd_metrics_bus_view_t *buses;  /* sampler thread'leri */
+  int nbus;
+  int clients;
+} bqd_metrics_view_t;
+
+/* Tam dokuman: OpenMetrics ("# EOF" ile biter) ya da prom_text=1 ile Prometheus 0.0.4.
+   Donus: uzunluk ya da -ENOSPC */
+int bqd_metrics_render(const bqd_metrics_view_t *v, char *buf, size_t len, int prom_text);
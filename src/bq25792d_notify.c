@@ -0,0 +1,62 @@
+#include "bq25792d_notify.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define LISTEN_FDS_START 3
+
+int bqd_notify(const char *state) {
+  const char *path = getenv("NOTIFY_SOCKET");
+  if (!path || !*path || !state) return 0;
+
+  struct sockaddr_un sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sun_family = AF_UNIX;
+  const size_t plen = strlen(path);
+  if (plen >= sizeof(sa.sun_path)) return -ENAMETOOLONG;
+  memcpy(sa.sun_path, path, plen);
+  /* '@' ile baslayan: abstract namespace */
+  if (sa.sun_path[0] == '@') sa.sun_path[0] = '\0';
+  const socklen_t salen = (socklen_t)(offsetof(struct sockaddr_un, sun_path) + plen);
+
+  int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) return -errno;
+  ssize_t n = sendto(fd, state, strlen(state), MSG_NOSIGNAL, (struct sockaddr*)&sa, salen);
+  int rc = (n < 0) ? -errno : 1;
+  close(fd);
+  return rc;
+}
+
+/* LISTEN_PID/WATCHDOG_PID tanimliysa bizim pid'imiz olmali */
+static int pid_matches(const char *name) {
+  const char *s = getenv(name);
+  if (!s || !*s) return 1;
+  return strtol(s, NULL, 10) == (long)getpid();
+}
+
+long long bqd_watchdog_usec(void) {
+  const char *s = getenv("WATCHDOG_USEC");
+  if (!s || !*s || !pid_matches("WATCHDOG_PID")) return 0;
+  const long long us = strtoll(s, NULL, 10);
+  return (us > 0) ? us : 0;
+}
+
+int bqd_listen_fd(void) {
+  const char *s = getenv("LISTEN_FDS");
+  int fd = -1;
+  if (s && *s && getenv("LISTEN_PID") && pid_matches("LISTEN_PID") && strtol(s, NULL, 10) >= 1) {
+    fd = LISTEN_FDS_START;
+    int fl = fcntl(fd, F_GETFD);
+    if (fl < 0 || fcntl(fd, F_SETFD, fl | FD_CLOEXEC) < 0) fd = -1;
+  }
+  unsetenv("LISTEN_PID");
+  unsetenv("LISTEN_FDS");
+  unsetenv("LISTEN_FDNAMES");
+  return fd;
+}
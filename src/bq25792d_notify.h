@@ -0,0 +1,16 @@
+#pragma once
+#include <stddef.h>
+/* systemd entegrasyonu, libsystemd'siz: sd_notify protokolu (NOTIFY_SOCKET'e
+   datagram) ve socket activation (LISTEN_PID/LISTEN_FDS, ilk fd 3). systemd
+   altinda calismiyorsa fonksiyonlar bir sey yapmaz. */
+
+/* "READY=1", "WATCHDOG=1", "STATUS=..." gibi satirlar ('\n' ile ayrilmis).
+   Donus: 1 gonderildi, 0 NOTIFY_SOCKET yok, <0 hata */
+int bqd_notify(const char *state);
+
+/* WatchdogSec= ayarliysa ve bu surece aitse keepalive periyodu (us), degilse 0 */
+long long bqd_watchdog_usec(void);
+
+/* Socket activation ile gelen ilk dinleme fd'si (CLOEXEC yapilir), yoksa -1.
+   Ortam degiskenleri temizlenir (alt surecler devralmaz). */
+int bqd_listen_fd(void);
@@ -0,0 +1,100 @@
+#include "bq25792d_pack.h"
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+static int jprintf(char *buf, size_t len, size_t *off, const char *fmt, ...) {
+  if (*off >= len) return -ENOSPC;
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(buf + *off, len - *off, fmt, ap);
+  va_end(ap);
+  if (n < 0) return -EIO;
+  if ((size_t)n >= len - *off) return -ENOSPC;
+  *off += (size_t)n;
+  return 0;
+}
+
+static const char* jbool(bool v) { return v ? "true" : "false"; }
+
+/* CHG_STAT 1..6: trickle/pre/CC/CV/top-off */
+static bool is_charging(const bq25792_status_t *st) {
+  return st->chg_stat >= 1 && st->chg_stat <= 6;
+}
+
+int bqd_pack_to_json(const bqd_pack_entry_t *e, int n, long long ts_ms, char *buf, size_t len) {
+  int online = 0;
+  int vmin = 0, vmax = 0;
+  long ibat = 0, ibus = 0;
+  bool vbus = false, charging = false, fault = false;
+  float tmax = 0.0f;
+  double soc_w = 0.0, w_sum = 0.0;
+  double charge = 0.0, cap = 0.0;
+  bool cc_all = true;
+
+  for (int i = 0; i < n; i++) {
+    if (!e[i].snap || e[i].stale) continue;
+    const bq25792_snapshot_t *s = e[i].snap;
+    const bq25792_status_t *st = &s->st;
+    if (online == 0 || st->vbat_mv < vmin) vmin = st->vbat_mv;
+    if (online == 0 || st->vbat_mv > vmax) vmax = st->vbat_mv;
+    if (online == 0 || st->tdie_c > tmax) tmax = st->tdie_c;
+    online++;
+    ibat += st->ibat_ma;
+    ibus += st->ibus_ma;
+    vbus |= st->vbus_present;
+    charging |= is_charging(st);
+    fault |= st->fault_any;
+    if (s->soc_cc_pct < 0) cc_all = false;
+  }
+
+  for (int i = 0; i < n; i++) {
+    if (!e[i].snap || e[i].stale) continue;
+    const bq25792_snapshot_t *s = e[i].snap;
+    const double w = (cc_all && s->capacity_mah > 0) ? s->capacity_mah : 1.0;
+    soc_w += w * s->soc_pct;
+    w_sum += w;
+    if (cc_all) {
+      charge += s->charge_mah;
+      cap += s->capacity_mah;
+    }
+  }
+  const int soc = (w_sum > 0) ? (int)(soc_w / w_sum + 0.5) : -1;
+
+  size_t off = 0;
+  int rc = jprintf(buf, len, &off,
+    "{\"ts_ms\":%lld,\"pack\":{"
+      "\"devices\":%d,\"online\":%d,"
+      "\"vbat_mv_min\":%d,\"vbat_mv_max\":%d,"
+      "\"ibat_ma\":%ld,\"ibus_ma\":%ld,"
+      "\"vbus_present\":%s,\"charging\":%s,\"fault_any\":%s,"
+      "\"tdie_c_max\":%.1f,\"soc_pct\":%d,"
+      "\"charge_mah\":%.0f,\"capacity_mah\":%.0f"
+    "},\"devices\":[",
+    ts_ms, n, online, vmin, vmax, ibat, ibus,
+    jbool(vbus), jbool(charging), jbool(fault), (double)tmax, soc,
+    charge, cap);
+  if (rc) return rc;
+
+  for (int i = 0; i < n; i++) {
+    const bq25792_snapshot_t *s = e[i].snap;
+    const char *sep = i ? "," : "";
+    if (!s) {
+      rc = jprintf(buf, len, &off, "%s{\"bus\":%d,\"addr\":\"0x%02x\",\"ok\":false}",
+                   sep, e[i].bus, e[i].addr & 0xFF);
+    } else {
+      rc = jprintf(buf, len, &off,
+        "%s{\"bus\":%d,\"addr\":\"0x%02x\",\"ok\":%s,\"age_ms\":%lld,"
+        "\"chg_stat\":%u,\"vbus_present\":%s,\"fault_any\":%s,"
+        "\"vbat_mv\":%d,\"ibat_ma\":%d,\"ibus_ma\":%d,\"tdie_c\":%.1f,\"soc_pct\":%d}",
+        sep, (int)s->bus, s->addr, jbool(!e[i].stale), e[i].age_ms,
+        s->st.chg_stat, jbool(s->st.vbus_present), jbool(s->st.fault_any),
+        s->st.vbat_mv, s->st.ibat_ma, s->st.ibus_ma, (double)s->st.tdie_c, (int)s->soc_pct);
+    }
+    if (rc) return rc;
+  }
+  rc = jprintf(buf, len, &off, "]}\n");
+  if (rc) return rc;
+  return (int)off;
+}
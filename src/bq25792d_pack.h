@@ -0,0 +1,22 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "bq25792.h"
+
+/*
+  Coklu sarj cihazi: cihaz basina son snapshot'lardan pack ozeti.
+  Akimlar toplanir (paralel paketler), SoC kapasiteyle agirliklandirilir
+  (coulomb counter gecersizse esit agirlik). Eski (stale) ya da hic
+  okunamamis cihazlar ozetten dusulur ama listede kalir.
+*/
+typedef struct {
+  int bus;
+  int addr;
+  const bq25792_snapshot_t *snap;  /* NULL: henuz okunamadi */
+  bool stale;                      /* son basarili ornek cok eski (bus takili olabilir) */
+  long long age_ms;
+} bqd_pack_entry_t;
+
+/* Tek satir JSON ('\n' ile). Donus: uzunluk ya da -ENOSPC */
+int bqd_pack_to_json(const bqd_pack_entry_t *e, int n, long long ts_ms, char *buf, size_t len);
@@ -0,0 +1,63 @@
+#include "bq25792d_publish.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+void bqd_publisher_init(bqd_publisher_t *p, const bqd_deadband_t *db) {
+  memset(p, 0, sizeof(*p));
+  p->db = *db;
+}
+
+static int over(int a, int b, int band) { return abs(a - b) > band; }
+
+/* Status/fault bitleri: birebir */
+static int bits_changed(const bq25792_status_t *a, const bq25792_status_t *b) {
+  return a->vbus_present != b->vbus_present ||
+         a->ac1_present != b->ac1_present ||
+         a->ac2_present != b->ac2_present ||
+         a->pg != b->pg ||
+         a->iindpm != b->iindpm ||
+         a->vindpm != b->vindpm ||
+         a->watchdog_expired != b->watchdog_expired ||
+         a->poor_source != b->poor_source ||
+         a->chg_stat != b->chg_stat ||
+         a->vbus_stat != b->vbus_stat ||
+         a->bc12_done != b->bc12_done ||
+         a->fault0 != b->fault0 ||
+         a->fault1 != b->fault1 ||
+         a->fault_any != b->fault_any ||
+         a->chg_flag0 != b->chg_flag0 ||
+         a->chg_flag1 != b->chg_flag1 ||
+         a->chg_flag2 != b->chg_flag2 ||
+         a->chg_flag3 != b->chg_flag3 ||
+         a->cell_count != b->cell_count;
+}
+
+/* ADC alanlari: deadband */
+static int adc_changed(const bq25792_status_t *a, const bq25792_status_t *b, const bqd_deadband_t *db) {
+  return over(a->vbus_mv, b->vbus_mv, db->mv) ||
+         over(a->vbat_mv, b->vbat_mv, db->mv) ||
+         over(a->vsys_mv, b->vsys_mv, db->mv) ||
+         over(a->ibus_ma, b->ibus_ma, db->ma) ||
+         over(a->ibat_ma, b->ibat_ma, db->ma) ||
+         fabsf(a->tdie_c - b->tdie_c) > db->tdie_c;
+}
+
+int bqd_publisher_check(bqd_publisher_t *p, const bq25792_snapshot_t *snap, long long now_mono_ms) {
+  int pub = !p->have_last ||
+            (now_mono_ms - p->last_pub_ms) >= p->db.max_stale_ms ||
+            snap->adc_pending != p->last.adc_pending ||
+            snap->soc_pct != p->last.soc_pct ||
+            bits_changed(&snap->st, &p->last.st) ||
+            adc_changed(&snap->st, &p->last.st, &p->db);
+  if (!pub) p->suppressed++;
+  return pub;
+}
+
+void bqd_publisher_commit(bqd_publisher_t *p, const bq25792_snapshot_t *snap, long long now_mono_ms) {
+  p->last = *snap;
+  p->last_pub_ms = now_mono_ms;
+  p->have_last = 1;
+  p->published++;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "bq25792.h"
+
+/* Degisim tabanli yayin: yeni snapshot son YAYINLANAN ile karsilastirilir.
+   ADC alanlari deadband ile, status/fault bitleri birebir karsilastirilir.
+   Hic degisim yoksa bile max_stale_ms dolunca heartbeat olarak yayinlanir. */
+
+typedef struct {
+  int mv;            /* VBUS/VBAT/VSYS deadband (mV) */
+  int ma;            /* IBUS/IBAT deadband (mA) */
+  float tdie_c;      /* TDIE deadband (C) */
+  long long max_stale_ms;
+} bqd_deadband_t;
+
+typedef struct {
+  bqd_deadband_t db;
+  int have_last;
+  bq25792_snapshot_t last;
+  long long last_pub_ms;     /* CLOCK_MONOTONIC */
+  unsigned long long published;
+  unsigned long long suppressed;
+} bqd_publisher_t;
+
+void bqd_publisher_init(bqd_publisher_t *p, const bqd_deadband_t *db);
+
+/* 1: yayinlanmali (degisim ya da heartbeat), 0: bastir */
+int  bqd_publisher_check(bqd_publisher_t *p, const bq25792_snapshot_t *snap, long long now_mono_ms);
+
+/* Yayin yapildiktan sonra referansi guncelle */
+void bqd_publisher_commit(bqd_publisher_t *p, const bq25792_snapshot_t *snap, long long now_mono_ms);
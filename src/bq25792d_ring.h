@@ -0,0 +1,68 @@
+#pragma once
+/* Tek uretici / tek tuketici kilitsiz ring (sampler thread -> publisher).
+   head sadece uretici, tail sadece tuketici tarafindan yazilir; ayri cache
+   satirlarinda tutulur. Boyut 2'nin kuvveti. */
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "bq25792.h"
+#include "bq25792_regs.h"
+
+typedef enum {
+  BQD_SAMPLE_FULL = 0,   /* tam snapshot (read_status) */
+  BQD_SAMPLE_BATT,       /* IBUS..VBAT burst (coulomb/enerji sayaci) */
+  BQD_SAMPLE_EVENT,      /* REG1B..REG27 durum + flag (olay yoklamasi) */
+} bqd_sample_kind_t;
+
+typedef struct {
+  uint8_t kind;          /* bqd_sample_kind_t */
+  uint8_t trigger;       /* bq25792_trigger_t (FULL) */
+  uint8_t dev;           /* sampler icindeki cihaz sirasi */
+  uint8_t adc_pending;   /* FULL: hizli baslangic ornegi, ADC alanlari gecersiz */
+  int32_t rc;            /* okuma hatasi (0 = ok) */
+  int64_t t_ns;          /* okuma zamani, CLOCK_MONOTONIC */
+  int64_t ts_ms;         /* okuma zamani, CLOCK_REALTIME */
+  int32_t vbat_mv;       /* BATT */
+  int32_t ibat_ma;       /* BATT */
+  int32_t vbus_mv;       /* BATT */
+  int32_t ibus_ma;       /* BATT */
+  bq25792_status_t st;   /* FULL */
+  uint8_t regs[BQ25792_NREGS]; /* FULL: ayni okumanin register imaji, EVENT: REG1B..REG27 */
+} bqd_sample_t;
+
+#define BQD_RING_SIZE 256u
+
+typedef struct {
+  alignas(64) _Atomic size_t head;
+  alignas(64) _Atomic size_t tail;
+  alignas(64) bqd_sample_t buf[BQD_RING_SIZE];
+} bqd_ring_t;
+
+static inline void bqd_ring_init(bqd_ring_t *r) {
+  atomic_init(&r->head, 0);
+  atomic_init(&r->tail, 0);
+}
+
+/* Uretici. Dolu ise false (ornek dusurulur, cagiran sayar) */
+static inline bool bqd_ring_push(bqd_ring_t *r, const bqd_sample_t *s) {
+  const size_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+  const size_t tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+  if (head - tail >= BQD_RING_SIZE) return false;
+  memcpy(&r->buf[head & (BQD_RING_SIZE - 1)], s, sizeof(*s));
+  atomic_store_explicit(&r->head, head + 1, memory_order_release);
+  return true;
+}
+
+/* Tuketici. Bos ise false */
+static inline bool bqd_ring_pop(bqd_ring_t *r, bqd_sample_t *s) {
+  const size_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+  const size_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+  if (tail == head) return false;
+  memcpy(s, &r->buf[tail & (BQD_RING_SIZE - 1)], sizeof(*s));
+  atomic_store_explicit(&r->tail, tail + 1, memory_order_release);
+  return true;
+}
@@ -0,0 +1,404 @@
+#define _GNU_SOURCE
+#include "bq25792d_sampler.h"
+#include "bq25792_events.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Kick sinyali: sampler thread'i clock_nanosleep'ten erken uyandirir */
+#define BQD_SAMPLER_SIG SIGUSR1
+
+#define NS_PER_MS 1000000LL
+#define NS_PER_S  1000000000LL
+
+struct bqd_sampler {
+  bqd_sampler_config_t cfg;
+  pthread_t thr;
+  int started;
+  int efd;
+  bqd_ring_t ring;
+
+  _Atomic int stop;
+  _Atomic int kick;
+  _Atomic uint32_t live_req;   /* bqd_sampler_request: cihaz bit maskesi */
+  _Atomic int64_t due_ns;      /* siradaki planli uyanma (watchdog saglik kontrolu) */
+
+  /* istatistik: thread yazar, publisher okur (relaxed yeterli). Jitter penceresi
+     cihaz basina: ayni bus'taki her cihazin yayini kendi penceresini sifirlar */
+  _Atomic uint64_t win_late_sum_ns[BQD_SAMPLER_MAX_DEVS];
+  _Atomic uint32_t win_late_max_ns[BQD_SAMPLER_MAX_DEVS];
+  _Atomic uint32_t win_ticks[BQD_SAMPLER_MAX_DEVS];
+  _Atomic uint32_t overruns;
+  _Atomic uint32_t drops;
+  uint32_t period_us;
+
+  /* zamanlayici: durum sadece thread'de, istatistik kopyasi kilitle paylasilir */
+  bqd_sched_t sched[BQD_SAMPLER_MAX_DEVS];
+  pthread_mutex_t sched_mu;
+  bqd_sched_stats_t sched_pub[BQD_SAMPLER_MAX_DEVS];
+};
+
+/* Sinyal handler'i sadece kendi thread'inin uyku hedefini sifirlar:
+   kick bayragi kontrolu ile clock_nanosleep arasinda gelen sinyal kaybolmaz. */
+static __thread struct timespec tls_sleep_until;
+
+static void on_kick_signal(int sig) {
+  (void)sig;
+  tls_sleep_until.tv_sec = 0;
+  tls_sleep_until.tv_nsec = 0;
+}
+
+static int64_t mono_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * NS_PER_S + ts.tv_nsec;
+}
+
+static int64_t real_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / NS_PER_MS;
+}
+
+static void push(bqd_sampler_t *s, const bqd_sample_t *smp) {
+  if (!bqd_ring_push(&s->ring, smp)) {
+    atomic_fetch_add_explicit(&s->drops, 1, memory_order_relaxed);
+    return;
+  }
+  const uint64_t one = 1;
+  (void)!write(s->efd, &one, sizeof(one));
+}
+
+static void record_late(bqd_sampler_t *s, int64_t late_ns) {
+  if (late_ns < 0) late_ns = 0;
+  if (late_ns > UINT32_MAX) late_ns = UINT32_MAX;
+  for (int i = 0; i < s->cfg.ndev; i++) {
+    atomic_fetch_add_explicit(&s->win_late_sum_ns[i], (uint64_t)late_ns, memory_order_relaxed);
+    atomic_fetch_add_explicit(&s->win_ticks[i], 1, memory_order_relaxed);
+    uint32_t cur = atomic_load_explicit(&s->win_late_max_ns[i], memory_order_relaxed);
+    while ((uint32_t)late_ns > cur &&
+           !atomic_compare_exchange_weak_explicit(&s->win_late_max_ns[i], &cur, (uint32_t)late_ns,
+                                                  memory_order_relaxed, memory_order_relaxed)) {}
+  }
+}
+
+/* ADC continuous modda calisiyor: pencere degerleri gecerli */
+static int adc_running(const uint8_t *img) {
+  return bq25792_field_raw(img, BQ25792_F_ADC_EN) && !bq25792_field_raw(img, BQ25792_F_ADC_RATE);
+}
+
+static void apply_rt(const bqd_sampler_config_t *cfg) {
+  if (cfg->cpu >= 0) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cfg->cpu, &set);
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc) fprintf(stderr, "bq25792d: sampler CPU%d'e sabitlenemedi: %s\n", cfg->cpu, strerror(rc));
+  }
+  if (cfg->rt_prio > 0) {
+    struct sched_param sp;
+    memset(&sp, 0, sizeof(sp));
+    sp.sched_priority = cfg->rt_prio;
+    int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp);
+    if (rc) fprintf(stderr, "bq25792d: SCHED_FIFO(%d) ayarlanamadi: %s, normal oncelikle devam\n",
+                    cfg->rt_prio, strerror(rc));
+  }
+}
+
+static void* sampler_main(void *arg) {
+  bqd_sampler_t *s = (bqd_sampler_t*)arg;
+  const bqd_sampler_config_t *cfg = &s->cfg;
+
+  sigset_t un;
+  sigemptyset(&un);
+  sigaddset(&un, BQD_SAMPLER_SIG);
+  pthread_sigmask(SIG_UNBLOCK, &un, NULL);
+
+  apply_rt(cfg);
+
+  /* Kullanilmayan ADC kanallarini kapat: donusum dongusu kisalir, VBAT/IBAT daha taze */
+  if (cfg->adc_channels) {
+    for (int i = 0; i < cfg->ndev; i++) {
+      int rc = bq25792_adc_set_channels(cfg->devs[i], cfg->adc_channels | BQ25792_ADC_STATUS);
+      if (rc) fprintf(stderr, "bq25792d: ADC kanallari ayarlanamadi: %s\n", strerror(-rc));
+    }
+  }
+
+  const int64_t period_ns = (cfg->batt_hz > 0) ? NS_PER_S / cfg->batt_hz : 0;
+  const int64_t event_ns = (cfg->event_hz > 0) ? NS_PER_S / cfg->event_hz : 0;
+  const int64_t holdoff_ns = cfg->int_holdoff_ms * NS_PER_MS;
+  const int ndev = cfg->ndev;
+
+  int64_t now = mono_ns();
+  atomic_store_explicit(&s->due_ns, now, memory_order_relaxed);
+  int64_t next_tick = now + period_ns;
+  int64_t next_event = now + event_ns;
+  int64_t next_full[BQD_SAMPLER_MAX_DEVS];   /* ilk tam ornek hemen */
+  int64_t last_full[BQD_SAMPLER_MAX_DEVS];
+  int int_pending[BQD_SAMPLER_MAX_DEVS];
+  int live_pending[BQD_SAMPLER_MAX_DEVS];
+  int adc_seen[BQD_SAMPLER_MAX_DEVS];        /* ADC'li tam ornek alindi */
+  for (int i = 0; i < ndev; i++) {
+    bqd_sched_init(&s->sched[i], &cfg->sched, now);
+    next_full[i] = now;
+    last_full[i] = now - holdoff_ns;
+    int_pending[i] = 0;
+    live_pending[i] = 0;
+    adc_seen[i] = 0;
+  }
+
+  while (!atomic_load_explicit(&s->stop, memory_order_acquire)) {
+    now = mono_ns();
+    if (atomic_exchange_explicit(&s->kick, 0, memory_order_acq_rel)) {
+      for (int i = 0; i < ndev; i++) int_pending[i] = 1;
+    }
+    const uint32_t live = atomic_exchange_explicit(&s->live_req, 0, memory_order_acq_rel);
+    for (int i = 0; i < ndev; i++) {
+      if (live & (1u << i)) live_pending[i] = 1;
+    }
+
+    const int batt_due = period_ns > 0 && now >= next_tick;
+    const int event_due = event_ns > 0 && now >= next_event;
+
+    for (int i = 0; i < ndev; i++) {
+      const int int_due = int_pending[i] && now - last_full[i] >= holdoff_ns;
+      const int sched_due = (now >= next_full[i]) || int_due;
+      bqd_sample_t smp;
+
+      if (sched_due || live_pending[i]) {
+        memset(&smp, 0, sizeof(smp));
+        smp.kind = BQD_SAMPLE_FULL;
+        smp.dev = (uint8_t)i;
+        smp.trigger = !sched_due ? BQ25792_TRIGGER_LIVE : int_pending[i] ? BQ25792_TRIGGER_INT : BQ25792_TRIGGER_TIMER;
+        /* REG22..REG27 flag'lari da okunur ve temizlenir (INT kaynagi) */
+        int done = 0;
+        if (!adc_seen[i]) {
+          /* Hizli baslangic: ADC henuz continuous degilse ilk donusumu (kanal sayisi x
+             donusum suresi) yayinin onune koyma; once durum/flag ile eksik bir ornek,
+             ardindan ayni turda ADC'li tam ornek */
+          smp.rc = bq25792_read_status_regs(cfg->devs[i], &smp.st, false, smp.regs);
+          if (smp.rc == 0 && adc_running(smp.regs)) {
+            done = 1;
+          } else if (smp.rc == 0) {
+            smp.adc_pending = 1;
+            smp.t_ns = mono_ns();
+            smp.ts_ms = real_ms();
+            push(s, &smp);
+            smp.adc_pending = 0;
+          }
+        }
+        if (!done) smp.rc = bq25792_read_status_regs(cfg->devs[i], &smp.st, true, smp.regs);
+        if (smp.rc == 0) adc_seen[i] = 1;
+        smp.t_ns = mono_ns();
+        smp.ts_ms = real_ms();
+        push(s, &smp);
+        last_full[i] = now;
+        live_pending[i] = 0;
+        /* sonraki tam ornek son tam ornekten itibaren; INT gelirse hemen okunur.
+           Okuma hatasinda periyot degismez. Sadece canli istek icin yapilan okuma
+           zamanlamaya girmez (sik bqctl cagrilari periyodu uzatmasin). */
+        if (sched_due) {
+          if (smp.rc == 0) {
+            bqd_sched_update(&s->sched[i], &smp.st, int_pending[i], smp.t_ns);
+            pthread_mutex_lock(&s->sched_mu);
+            s->sched_pub[i] = s->sched[i].stats;
+            pthread_mutex_unlock(&s->sched_mu);
+          }
+          next_full[i] = now + s->sched[i].interval_ms * NS_PER_MS;
+          int_pending[i] = 0;
+        }
+        continue;
+      }
+      if (event_due) {
+        /* tam ornek zaten REG1B..REG27'yi okur; arada sadece durum + flag */
+        memset(&smp, 0, sizeof(smp));
+        smp.kind = BQD_SAMPLE_EVENT;
+        smp.dev = (uint8_t)i;
+        smp.rc = bq25792_read_event_regs(cfg->devs[i], smp.regs);
+        smp.t_ns = mono_ns();
+        smp.ts_ms = real_ms();
+        push(s, &smp);
+        /* sarj/VBUS durumu degisti ya da fault: tam ornek hemen */
+        if (smp.rc == 0 && bqd_sched_poke(&s->sched[i], smp.regs)) next_full[i] = smp.t_ns;
+      }
+      if (batt_due) {
+        memset(&smp, 0, sizeof(smp));
+        smp.kind = BQD_SAMPLE_BATT;
+        smp.dev = (uint8_t)i;
+        bq25792_power_t pw;
+        smp.rc = bq25792_read_power(cfg->devs[i], &pw);
+        if (smp.rc == 0) {
+          smp.vbat_mv = pw.vbat_mv;
+          smp.ibat_ma = pw.ibat_ma;
+          smp.vbus_mv = pw.vbus_mv;
+          smp.ibus_ma = pw.ibus_ma;
+        }
+        smp.t_ns = mono_ns();
+        smp.ts_ms = real_ms();
+        push(s, &smp);
+      }
+    }
+
+    /* olay yoklamasi: kacirilan periyotlar atlanir */
+    if (event_due) {
+      next_event += event_ns;
+      const int64_t t = mono_ns();
+      if (next_event <= t) next_event += ((t - next_event) / event_ns + 1) * event_ns;
+    }
+
+    /* tam ornek de bir tick sayilir; kacirilan tick'ler atlanir (catch-up yok) */
+    if (batt_due) {
+      next_tick += period_ns;
+      const int64_t t = mono_ns();
+      if (next_tick <= t) {
+        const int64_t missed = (t - next_tick) / period_ns + 1;
+        atomic_fetch_add_explicit(&s->overruns, (uint32_t)missed, memory_order_relaxed);
+        next_tick += missed * period_ns;
+      }
+    }
+
+    int64_t target = INT64_MAX;
+    if (period_ns > 0) target = next_tick;
+    if (event_ns > 0 && next_event < target) target = next_event;
+    for (int i = 0; i < ndev; i++) {
+      if (next_full[i] < target) target = next_full[i];
+      if (int_pending[i] && last_full[i] + holdoff_ns < target) target = last_full[i] + holdoff_ns;
+    }
+
+    atomic_store_explicit(&s->due_ns, target, memory_order_relaxed);
+    tls_sleep_until.tv_sec = (time_t)(target / NS_PER_S);
+    tls_sleep_until.tv_nsec = (long)(target % NS_PER_S);
+    atomic_signal_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&s->kick, memory_order_acquire) ||
+        atomic_load_explicit(&s->live_req, memory_order_acquire) ||
+        atomic_load_explicit(&s->stop, memory_order_acquire)) continue;
+
+    int rc;
+    do {
+      rc = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &tls_sleep_until, NULL);
+    } while (rc == EINTR && tls_sleep_until.tv_sec != 0);
+
+    /* sadece zamanlanmis uyanmalar jitter'a sayilir */
+    if (rc == 0 && tls_sleep_until.tv_sec != 0) record_late(s, mono_ns() - target);
+  }
+  return NULL;
+}
+
+int bqd_sampler_start(bqd_sampler_t **out, const bqd_sampler_config_t *cfg) {
+  if (!out || !cfg || cfg->ndev < 1 || cfg->ndev > BQD_SAMPLER_MAX_DEVS) return -EINVAL;
+  for (int i = 0; i < cfg->ndev; i++) {
+    if (!cfg->devs[i]) return -EINVAL;
+  }
+  *out = NULL;
+
+  bqd_sampler_t *s = (bqd_sampler_t*)calloc(1, sizeof(*s));
+  if (!s) return -ENOMEM;
+  s->cfg = *cfg;
+  if (s->cfg.interval_ms < 1) s->cfg.interval_ms = 1;
+  if (s->cfg.sched.min_ms <= 0) bqd_sched_config_fixed(&s->cfg.sched, s->cfg.interval_ms);
+  pthread_mutex_init(&s->sched_mu, NULL);
+  if (s->cfg.int_holdoff_ms < 0) s->cfg.int_holdoff_ms = 0;
+  bqd_ring_init(&s->ring);
+  s->period_us = (uint32_t)((s->cfg.batt_hz > 0) ? 1000000 / s->cfg.batt_hz : s->cfg.interval_ms * 1000);
+
+  s->efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (s->efd < 0) {
+    int e = -errno;
+    free(s);
+    return e;
+  }
+
+  struct sigaction sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = on_kick_signal;
+  sigemptyset(&sa.sa_mask);
+  (void)sigaction(BQD_SAMPLER_SIG, &sa, NULL);
+
+  /* Thread kick sinyali disindaki her seyi bloklu baslar (SIGINT/SIGTERM signalfd'de kalir) */
+  sigset_t all, old;
+  sigfillset(&all);
+  pthread_sigmask(SIG_SETMASK, &all, &old);
+  int rc = pthread_create(&s->thr, NULL, sampler_main, s);
+  pthread_sigmask(SIG_SETMASK, &old, NULL);
+  if (rc) {
+    close(s->efd);
+    free(s);
+    return -rc;
+  }
+  s->started = 1;
+  *out = s;
+  return 0;
+}
+
+void bqd_sampler_sched_stats(bqd_sampler_t *s, int dev, bqd_sched_stats_t *out) {
+  memset(out, 0, sizeof(*out));
+  if (!s || dev < 0 || dev >= s->cfg.ndev) return;
+  pthread_mutex_lock(&s->sched_mu);
+  *out = s->sched_pub[dev];
+  pthread_mutex_unlock(&s->sched_mu);
+}
+
+int bqd_sampler_fd(const bqd_sampler_t *s) {
+  return s ? s->efd : -1;
+}
+
+void bqd_sampler_ack(bqd_sampler_t *s) {
+  uint64_t v;
+  while (read(s->efd, &v, sizeof(v)) < 0 && errno == EINTR) {}
+}
+
+bool bqd_sampler_pop(bqd_sampler_t *s, bqd_sample_t *out) {
+  return bqd_ring_pop(&s->ring, out);
+}
+
+void bqd_sampler_kick(bqd_sampler_t *s) {
+  if (!s) return;
+  atomic_store_explicit(&s->kick, 1, memory_order_release);
+  pthread_kill(s->thr, BQD_SAMPLER_SIG);
+}
+
+void bqd_sampler_request(bqd_sampler_t *s, int dev) {
+  if (!s || dev < 0 || dev >= s->cfg.ndev) return;
+  atomic_fetch_or_explicit(&s->live_req, 1u << dev, memory_order_release);
+  pthread_kill(s->thr, BQD_SAMPLER_SIG);
+}
+
+int64_t bqd_sampler_overdue_ns(bqd_sampler_t *s) {
+  if (!s) return 0;
+  return mono_ns() - atomic_load_explicit(&s->due_ns, memory_order_relaxed);
+}
+
+void bqd_sampler_stats(bqd_sampler_t *s, int dev, bq25792_sampler_stats_t *out) {
+  memset(out, 0, sizeof(*out));
+  if (!s || dev < 0 || dev >= s->cfg.ndev) return;
+  const uint32_t ticks = atomic_exchange_explicit(&s->win_ticks[dev], 0, memory_order_relaxed);
+  const uint64_t sum = atomic_exchange_explicit(&s->win_late_sum_ns[dev], 0, memory_order_relaxed);
+  const uint32_t mx = atomic_exchange_explicit(&s->win_late_max_ns[dev], 0, memory_order_relaxed);
+  out->period_us = s->period_us;
+  out->jitter_max_us = mx / 1000u;
+  out->jitter_mean_us = ticks ? (uint32_t)(sum / ticks / 1000u) : 0;
+  out->overruns = atomic_load_explicit(&s->overruns, memory_order_relaxed);
+  out->drops = atomic_load_explicit(&s->drops, memory_order_relaxed);
+}
+
+void bqd_sampler_stop(bqd_sampler_t *s) {
+  if (!s) return;
+  if (s->started) {
+    atomic_store_explicit(&s->stop, 1, memory_order_release);
+    pthread_kill(s->thr, BQD_SAMPLER_SIG);
+    pthread_join(s->thr, NULL);
+  }
+  close(s->efd);
+  pthread_mutex_destroy(&s->sched_mu);
+  free(s);
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <stdbool.h>
+
+#include "bq25792.h"
+#include "bq25792d_ring.h"
+#include "bq25792d_sched.h"
+
+/*
+  I2C ornekleme thread'i (bus basina bir tane). Bus'taki cihaz handle'larinin tek
+  sahibidir, cihazlari sirayla okur (bus icinde serilestirme); CLOCK_MONOTONIC uzerinde
+  clock_nanosleep(TIMER_ABSTIME) ile mutlak zamanlarda uyanir, ornekleri SPSC ring
+  uzerinden publisher'a (epoll dongusu) verir ve eventfd ile haber verir.
+  Publisher'daki fsync/format gecikmeleri ornekleme zamanlamasini kaydirmaz.
+*/
+
+#define BQD_SAMPLER_MAX_DEVS 8
+
+typedef struct {
+  bq25792_dev_t *devs[BQD_SAMPLER_MAX_DEVS];
+  int ndev;
+  long long interval_ms;     /* tam snapshot (heartbeat) periyodu, sched.min_ms == 0 ise */
+  bqd_sched_config_t sched;  /* uyarlamali tam ornek periyodu */
+  long long int_holdoff_ms;  /* INT sonrasi iki tam okuma arasi min sure */
+  int batt_hz;               /* VBAT/IBAT ornek hizi, 0 = kapali */
+  int event_hz;              /* durum/flag yoklama hizi (INT hatti yoksa), 0 = kapali */
+  uint32_t adc_channels;     /* BQ25792_ADC_* (durum kanallari hep eklenir), 0 = dokunma */
+  int rt_prio;               /* >0: SCHED_FIFO onceligi */
+  int cpu;                   /* >=0: bu CPU'ya sabitle */
+} bqd_sampler_config_t;
+
+typedef struct bqd_sampler bqd_sampler_t;
+
+int  bqd_sampler_start(bqd_sampler_t **s, const bqd_sampler_config_t *cfg);
+
+/* Ring'de ornek varken okunabilir olan eventfd (epoll'a eklenir) */
+int  bqd_sampler_fd(const bqd_sampler_t *s);
+
+/* Publisher: once bqd_sampler_ack(), sonra bos olana kadar pop */
+void bqd_sampler_ack(bqd_sampler_t *s);
+bool bqd_sampler_pop(bqd_sampler_t *s, bqd_sample_t *out);
+
+/* INT geldi: holdoff'a uyarak tum cihazlardan en kisa surede tam snapshot al
+   (BQ25792 INT open-drain; kartlarda genelde wire-OR baglanir) */
+void bqd_sampler_kick(bqd_sampler_t *s);
+
+/* Istemci canli okuma istedi: dev (cfg.devs sirasi) icin holdoff/periyot beklemeden
+   tam ornek (trigger LIVE). Zamanlayiciyi etkilemez; ayni anda gelen istekler tek okumada
+   birlesir. */
+void bqd_sampler_request(bqd_sampler_t *s, int dev);
+
+/* Planli uyanma zamanindan bu yana gecen sure (ns); <= 0 ise thread zamaninda uyuyor.
+   Bir I2C islemi takilirsa buyur (systemd watchdog keepalive'i buna baglidir). */
+int64_t bqd_sampler_overdue_ns(bqd_sampler_t *s);
+
+/* Jitter/overrun istatistikleri; jitter alanlari bu cihaz (cfg.devs sirasi) icin
+   son cagridan beri (pencere) */
+void bqd_sampler_stats(bqd_sampler_t *s, int dev, bq25792_sampler_stats_t *out);
+
+/* Cihaz (cfg.devs sirasi) basina zamanlayici istatistikleri; son tam ornek itibariyla */
+void bqd_sampler_sched_stats(bqd_sampler_t *s, int dev, bqd_sched_stats_t *out);
+
+/* Thread'i durdurur ve bekler (cihaz handle'lari cagirana kalir) */
+void bqd_sampler_stop(bqd_sampler_t *s);
@@ -0,0 +1,86 @@
+#include "bq25792d_sched.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bq25792_regs.h"
+
+void bqd_sched_config_fixed(bqd_sched_config_t *c, long long ms) {
+  memset(c, 0, sizeof(*c));
+  c->min_ms = c->max_ms = c->busy_ms = ms;
+}
+
+void bqd_sched_init(bqd_sched_t *s, const bqd_sched_config_t *cfg, int64_t now_ns) {
+  memset(s, 0, sizeof(*s));
+  s->cfg = *cfg;
+  if (s->cfg.min_ms < 1) s->cfg.min_ms = 1;
+  if (s->cfg.max_ms < s->cfg.min_ms) s->cfg.max_ms = s->cfg.min_ms;
+  if (s->cfg.busy_ms < s->cfg.min_ms || s->cfg.busy_ms > s->cfg.max_ms) s->cfg.busy_ms = s->cfg.max_ms;
+  s->interval_ms = s->cfg.min_ms;
+  s->state_since_ns = now_ns;
+  s->stats.interval_ms = (uint32_t)s->interval_ms;
+}
+
+static int classify(const bq25792_status_t *st) {
+  if (st->fault_any) return BQD_SCHED_FAULT;
+  if (!st->vbus_present) return BQD_SCHED_UNPLUGGED;
+  if (st->chg_stat == 7) return BQD_SCHED_DONE;
+  if (st->chg_stat >= 1 && st->chg_stat <= 6) return BQD_SCHED_CHARGING;
+  return BQD_SCHED_IDLE;
+}
+
+long long bqd_sched_update(bqd_sched_t *s, const bq25792_status_t *st, int trigger_int, int64_t now_ns) {
+  /* onceki durumda gecen sure */
+  s->stats.dwell_ms[s->stats.state] += (uint64_t)((now_ns - s->state_since_ns) / 1000000);
+  s->state_since_ns = now_ns - (now_ns - s->state_since_ns) % 1000000;
+  s->stats.state = (uint8_t)classify(st);
+  s->stats.samples[s->stats.state]++;
+
+  /* fault sadece kenarda: zayif adaptor ya da kalici fault periyodu min'de tutmasin */
+  const int fault_new = (st->fault_any && !s->fault_any) ||
+                        (st->fault0 & ~s->fault0) || (st->fault1 & ~s->fault1);
+  const int transient = !s->have_prev || trigger_int || fault_new ||
+                        st->chg_stat != s->chg_stat || st->vbus_stat != s->vbus_stat ||
+                        (s->cfg.ibat_step_ma > 0 && abs(st->ibat_ma - s->ibat_ma) >= s->cfg.ibat_step_ma);
+  s->have_prev = 1;
+  s->chg_stat = st->chg_stat;
+  s->vbus_stat = st->vbus_stat;
+  s->fault_any = st->fault_any;
+  s->fault0 = st->fault0;
+  s->fault1 = st->fault1;
+  s->ibat_ma = st->ibat_ma;
+
+  if (transient) {
+    s->interval_ms = s->cfg.min_ms;
+    s->stats.transients++;
+  } else {
+    s->interval_ms *= 2;
+  }
+  const long long cap = (s->cfg.ibat_high_ma > 0 && abs(st->ibat_ma) >= s->cfg.ibat_high_ma)
+                        ? s->cfg.busy_ms : s->cfg.max_ms;
+  if (s->interval_ms > cap) s->interval_ms = cap;
+  s->stats.interval_ms = (uint32_t)s->interval_ms;
+  return s->interval_ms;
+}
+
+int bqd_sched_poke(bqd_sched_t *s, const uint8_t *regs) {
+  if (!s->have_prev) return 0;
+  const int chg = bq25792_field_raw(regs, BQ25792_F_CHG_STAT);
+  const int vbus = bq25792_field_raw(regs, BQ25792_F_VBUS_STAT);
+  const int fault = regs[BQ25792_REG26_FAULT_FLAG_0] || regs[BQ25792_REG27_FAULT_FLAG_1];
+  if (chg == s->chg_stat && vbus == s->vbus_stat && !fault) return 0;
+  s->interval_ms = s->cfg.min_ms;
+  s->stats.interval_ms = (uint32_t)s->interval_ms;
+  return 1;
+}
+
+const char* bqd_sched_state_str(int state) {
+  switch (state) {
+    case BQD_SCHED_UNPLUGGED: return "unplugged";
+    case BQD_SCHED_IDLE:      return "idle";
+    case BQD_SCHED_CHARGING:  return "charging";
+    case BQD_SCHED_DONE:      return "done";
+    case BQD_SCHED_FAULT:     return "fault";
+    default:                  return "unknown";
+  }
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <stdint.h>
+
+#include "bq25792.h"
+
+/*
+  Uyarlamali tam ornek zamanlayicisi (sampler thread'inde, cihaz basina).
+  chg_stat/vbus_stat degisimi, yeni fault, INT ya da buyuk IBAT sicramasinda periyot
+  min_ms'e iner; sonraki her kararli ornekte iki katina cikar (max_ms'e kadar).
+  Yuksek akimla sarjda ust sinir busy_ms. Durum basina kalis suresi ve ornek
+  sayisi tutulur (metrikler).
+*/
+
+typedef enum {
+  BQD_SCHED_UNPLUGGED = 0,  /* VBUS yok */
+  BQD_SCHED_IDLE,           /* VBUS var, sarj yok */
+  BQD_SCHED_CHARGING,       /* trickle/pre/CC/CV/topoff */
+  BQD_SCHED_DONE,           /* sarj tamam */
+  BQD_SCHED_FAULT,
+  BQD_SCHED_NSTATES
+} bqd_sched_state_t;
+
+typedef struct {
+  long long min_ms;
+  long long max_ms;
+  long long busy_ms;        /* |IBAT| >= ibat_high_ma iken ust sinir */
+  int ibat_step_ma;         /* iki ornek arasi bu kadar IBAT degisimi gecis sayilir */
+  int ibat_high_ma;
+} bqd_sched_config_t;
+
+typedef struct {
+  uint32_t interval_ms;                       /* su anki periyot */
+  uint8_t state;                              /* bqd_sched_state_t */
+  uint64_t dwell_ms[BQD_SCHED_NSTATES];       /* kumulatif */
+  uint64_t samples[BQD_SCHED_NSTATES];        /* durumda alinan tam ornekler */
+  uint64_t transients;                        /* periyodu min'e indiren ornekler */
+} bqd_sched_stats_t;
+
+typedef struct {
+  bqd_sched_config_t cfg;
+  long long interval_ms;
+  int have_prev;
+  uint8_t chg_stat;
+  uint8_t vbus_stat;
+  int fault_any;             /* seviye: poor_source/watchdog gibi kalici durumlar dahil */
+  uint8_t fault0, fault1;
+  int ibat_ma;
+  int64_t state_since_ns;
+  bqd_sched_stats_t stats;
+} bqd_sched_t;
+
+/* Sabit periyot (eski davranis): min = max = busy = ms */
+void bqd_sched_config_fixed(bqd_sched_config_t *c, long long ms);
+
+void bqd_sched_init(bqd_sched_t *s, const bqd_sched_config_t *cfg, int64_t now_ns);
+
+/* Tam ornekten sonra: bir sonraki tam ornege kadar sure (ms) */
+long long bqd_sched_update(bqd_sched_t *s, const bq25792_status_t *st, int trigger_int, int64_t now_ns);
+
+/* Olay yoklamasi (REG1B..REG27 imaji): durum degisti ya da fault flag'i varsa
+   periyodu min'e indirir ve 1 doner (tam ornek hemen alinmali) */
+int bqd_sched_poke(bqd_sched_t *s, const uint8_t *regs);
+
+const char* bqd_sched_state_str(int state);
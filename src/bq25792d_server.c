@@ -0,0 +1,428 @@
+#define _GNU_SOURCE
+#include "bq25792d_server.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <grp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define IN_CAP      256
+#define OUT_CAP     16384   /* en az; cevap buyukse (metrics) cagiran reply_cap ile buyutur */
+#define LATEST_CAP  4096    /* coklu cihazda pack satiri */
+
+typedef struct client {
+  bqd_watch_t w;              /* ilk uye: epoll data.ptr */
+  struct client *prev, *next;
+  int subscribed;
+  int want_latest;            /* buffer bosalinca en guncel snapshot gonderilecek */
+  int events;                 /* olay satirlari push edilir */
+  int wait_key;               /* ertelenmis cevap bekliyor (bqd_server_defer), -1 = yok */
+  uint64_t events_lost;       /* buffer dolu oldugu icin dusen olaylar */
+  int pollout;                /* EPOLLOUT kayitli mi */
+  int dead;                   /* kapatildi, bqd_server_reap'te serbest birakilir */
+  size_t in_len;
+  size_t out_off, out_len, out_cap;
+  char in[IN_CAP];
+  char out[];                 /* out_cap byte; calloc'lu, dokunulmayan sayfa RSS'e girmez */
+} client_t;
+
+struct bqd_server {
+  bqd_watch_t listen;
+  int epfd;
+  int max_clients;
+  int nclients;
+  client_t *clients;
+  client_t *dead;             /* kapatilmis, ayni epoll turunda hala olayi olabilir */
+  char path[108];
+  size_t latest_len;
+  char latest[LATEST_CAP];
+  bqd_server_cmd_fn cmd_fn;
+  void *cmd_ctx;
+  client_t *cmd_client;       /* handler calisirken komutu gonderen */
+  size_t out_cap;             /* istemci buffer'i ve komut cevabi */
+  char *reply;
+};
+
+/* Ayni epoll_wait sonucunda bu istemcinin bekleyen olayi olabilir (ornegin onceki
+   bir sampler olayinin yayini kapatti): bellek dongu turu bitene kadar tutulur,
+   bqd_server_reap serbest birakir. */
+static void client_close(bqd_server_t *srv, client_t *c) {
+  if (c->dead) return;
+  bqd_loop_del(srv->epfd, &c->w);
+  close(c->w.fd);
+  c->w.fd = -1;
+  c->dead = 1;
+  if (c->prev) c->prev->next = c->next;
+  else srv->clients = c->next;
+  if (c->next) c->next->prev = c->prev;
+  c->prev = NULL;
+  c->next = srv->dead;
+  srv->dead = c;
+  srv->nclients--;
+}
+
+static int client_append(client_t *c, const char *data, size_t len) {
+  if (c->out_len + len > c->out_cap) return -ENOSPC;
+  memcpy(c->out + c->out_len, data, len);
+  c->out_len += len;
+  return 0;
+}
+
+/* Bekleyen veriyi gonder. 0: tamam/devam, <0: istemci kapatilmali */
+static int client_flush(bqd_server_t *srv, client_t *c) {
+  for (;;) {
+    while (c->out_off < c->out_len) {
+      ssize_t n = send(c->w.fd, c->out + c->out_off, c->out_len - c->out_off,
+                       MSG_NOSIGNAL | MSG_DONTWAIT);
+      if (n < 0) {
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+          if (!c->pollout && bqd_loop_mod(srv->epfd, &c->w, EPOLLIN | EPOLLOUT) == 0) c->pollout = 1;
+          return 0;
+        }
+        return -errno;
+      }
+      c->out_off += (size_t)n;
+    }
+    c->out_off = c->out_len = 0;
+
+    if (c->events_lost) {
+      char msg[48];
+      int n = snprintf(msg, sizeof(msg), "{\"events_lost\":%llu}\n", (unsigned long long)c->events_lost);
+      c->events_lost = 0;
+      (void)client_append(c, msg, (size_t)n);
+      continue;
+    }
+
+    /* Yavas okuyucu: aradaki push'lar atlandi, sadece en guncelini gonder */
+    if (c->want_latest && srv->latest_len > 0) {
+      c->want_latest = 0;
+      (void)client_append(c, srv->latest, srv->latest_len);
+      continue;
+    }
+    c->want_latest = 0;
+    break;
+  }
+
+  if (c->pollout && bqd_loop_mod(srv->epfd, &c->w, EPOLLIN) == 0) c->pollout = 0;
+  return 0;
+}
+
+/* En guncel snapshot'i gonder; onceki veri hala bekliyorsa birlestir */
+static int client_send_latest(bqd_server_t *srv, client_t *c) {
+  if (srv->latest_len == 0) return 0;
+  if (c->out_len > 0) {
+    c->want_latest = 1;
+    return 0;
+  }
+  (void)client_append(c, srv->latest, srv->latest_len);
+  return client_flush(srv, c);
+}
+
+static int client_reply(bqd_server_t *srv, client_t *c, const char *msg) {
+  if (client_append(c, msg, strlen(msg)) != 0) return 0; /* cevap sigmadi: istemci zaten geride */
+  return client_flush(srv, c);
+}
+
+static int client_command(bqd_server_t *srv, client_t *c, char *line) {
+  /* sondaki \r ve bosluklari at */
+  size_t n = strlen(line);
+  while (n > 0 && (line[n-1] == '\r' || line[n-1] == ' ' || line[n-1] == '\t')) line[--n] = '\0';
+  if (n == 0) return 0;
+
+  if (strcmp(line, "get") == 0) {
+    if (srv->latest_len == 0) return client_reply(srv, c, "{\"error\":\"no data yet\"}\n");
+    return client_send_latest(srv, c);
+  }
+  if (strcmp(line, "subscribe") == 0) {
+    c->subscribed = 1;
+    return client_send_latest(srv, c);
+  }
+  if (strcmp(line, "unsubscribe") == 0) {
+    c->subscribed = 0;
+    c->want_latest = 0;
+    c->events = 0;
+    return 0;
+  }
+  /* "events follow [seq]": birikmis olaylar komut handler'indan, sonrakiler push */
+  if (strncmp(line, "events follow", 13) == 0 && (line[13] == '\0' || line[13] == ' ')) {
+    c->events = 1;
+    memmove(line + 6, line + 13, strlen(line + 13) + 1);
+  }
+  if (srv->cmd_fn) {
+    srv->cmd_client = c;
+    int r = srv->cmd_fn(srv->cmd_ctx, line, srv->reply, srv->out_cap);
+    srv->cmd_client = NULL;
+    if (r == BQD_SERVER_DEFERRED) return 0;
+    if (r > 0) {
+      if (client_append(c, srv->reply, (size_t)r) != 0) {
+        return client_reply(srv, c, "{\"error\":\"busy\"}\n");
+      }
+      return client_flush(srv, c);
+    }
+    if (r < 0) return client_reply(srv, c, "{\"error\":\"internal\"}\n");
+  }
+  return client_reply(srv, c, "{\"error\":\"unknown command\"}\n");
+}
+
+static void client_readable(bqd_server_t *srv, client_t *c) {
+  for (;;) {
+    ssize_t n = recv(c->w.fd, c->in + c->in_len, IN_CAP - 1 - c->in_len, MSG_DONTWAIT);
+    if (n == 0) {
+      client_close(srv, c);
+      return;
+    }
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK) return;
+      client_close(srv, c);
+      return;
+    }
+    c->in_len += (size_t)n;
+    c->in[c->in_len] = '\0';
+
+    char *start = c->in;
+    char *nl;
+    while ((nl = strchr(start, '\n')) != NULL) {
+      *nl = '\0';
+      if (client_command(srv, c, start) < 0) {
+        client_close(srv, c);
+        return;
+      }
+      start = nl + 1;
+    }
+
+    size_t rest = c->in_len - (size_t)(start - c->in);
+    if (rest >= IN_CAP - 1) {
+      /* satir cok uzun: protokol ihlali */
+      client_close(srv, c);
+      return;
+    }
+    memmove(c->in, start, rest);
+    c->in_len = rest;
+  }
+}
+
+static void accept_clients(bqd_server_t *srv) {
+  for (;;) {
+    int fd = accept4(srv->listen.fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (errno == EINTR) continue;
+      return; /* EAGAIN ya da gecici hata (EMFILE vb.) */
+    }
+    if (srv->nclients >= srv->max_clients) {
+      close(fd);
+      continue;
+    }
+
+    client_t *c = (client_t*)calloc(1, sizeof(*c) + srv->out_cap);
+    if (!c) {
+      close(fd);
+      continue;
+    }
+    c->out_cap = srv->out_cap;
+    c->w.fd = fd;
+    c->w.kind = BQD_W_CLIENT;
+    c->wait_key = -1;
+    if (bqd_loop_add(srv->epfd, &c->w, EPOLLIN) != 0) {
+      close(fd);
+      free(c);
+      continue;
+    }
+    c->next = srv->clients;
+    if (srv->clients) srv->clients->prev = c;
+    srv->clients = c;
+    srv->nclients++;
+  }
+}
+
+/* path bos: soket disaridan geldi (socket activation), kapanista silinmez */
+static int server_new(bqd_server_t **out, int epfd, int fd, const char *path, int max_clients,
+                      size_t reply_cap) {
+  bqd_server_t *srv = (bqd_server_t*)calloc(1, sizeof(*srv));
+  if (!srv) return -ENOMEM;
+  srv->out_cap = (reply_cap > OUT_CAP) ? reply_cap : OUT_CAP;
+  srv->reply = (char*)malloc(srv->out_cap);
+  if (!srv->reply) {
+    free(srv);
+    return -ENOMEM;
+  }
+  srv->listen.fd = fd;
+  srv->listen.kind = BQD_W_LISTEN;
+  srv->epfd = epfd;
+  srv->max_clients = (max_clients > 0) ? max_clients : 1;
+  snprintf(srv->path, sizeof(srv->path), "%s", path);
+
+  int rc = bqd_loop_add(epfd, &srv->listen, EPOLLIN);
+  if (rc) {
+    free(srv->reply);
+    free(srv);   /* fd cagiranda kalir */
+    return rc;
+  }
+  *out = srv;
+  return 0;
+}
+
+int bqd_server_open(bqd_server_t **out, int epfd, const char *path, const char *group, int max_clients,
+                    size_t reply_cap) {
+  if (!out || !path) return -EINVAL;
+  *out = NULL;
+
+  struct sockaddr_un sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sun_family = AF_UNIX;
+  if (strlen(path) >= sizeof(sa.sun_path)) return -ENAMETOOLONG;
+  snprintf(sa.sun_path, sizeof(sa.sun_path), "%s", path);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0) return -errno;
+
+  (void)unlink(path);
+  if (bind(fd, (struct sockaddr*)&sa, sizeof(sa)) < 0 || listen(fd, 64) < 0) {
+    int e = -errno;
+    close(fd);
+    return e;
+  }
+  /* "live" bus'a okuma (ve ADC acma yazmasi) tetikler: sadece root ve grup uyeleri.
+     Grup yoksa root'a kalir. Herkese acik veri status.json/shm'de. */
+  (void)chmod(path, 0660);
+  if (group && *group) {
+    const struct group *gr = getgrnam(group);
+    if (!gr || chown(path, (uid_t)-1, gr->gr_gid) != 0) {
+      fprintf(stderr, "bq25792d: socket grubu ayarlanamadi (%s), sadece root erisebilir\n", group);
+    }
+  }
+
+  int rc = server_new(out, epfd, fd, path, max_clients, reply_cap);
+  if (rc) {
+    close(fd);
+    unlink(path);
+  }
+  return rc;
+}
+
+int bqd_server_open_fd(bqd_server_t **out, int epfd, int fd, int max_clients, size_t reply_cap) {
+  if (!out || fd < 0) return -EINVAL;
+  *out = NULL;
+  /* systemd dinleme soketini blocking verir */
+  int fl = fcntl(fd, F_GETFL);
+  if (fl < 0 || fcntl(fd, F_SETFL, fl | O_NONBLOCK) < 0) return -errno;
+  return server_new(out, epfd, fd, "", max_clients, reply_cap);
+}
+
+void bqd_server_handle(bqd_server_t *srv, bqd_watch_t *w, uint32_t events) {
+  if (w->kind == BQD_W_LISTEN) {
+    accept_clients(srv);
+    return;
+  }
+
+  client_t *c = (client_t*)w;
+  if (c->dead) return;
+  if (events & (EPOLLERR | EPOLLHUP)) {
+    client_close(srv, c);
+    return;
+  }
+  if (events & EPOLLOUT) {
+    if (client_flush(srv, c) < 0) {
+      client_close(srv, c);
+      return;
+    }
+  }
+  if (events & EPOLLIN) client_readable(srv, c);
+}
+
+void bqd_server_set_latest(bqd_server_t *srv, const char *line, size_t len) {
+  if (!srv || len > LATEST_CAP) return;
+  memcpy(srv->latest, line, len);
+  srv->latest_len = len;
+}
+
+void bqd_server_broadcast(bqd_server_t *srv, const char *line, size_t len) {
+  if (!srv) return;
+  bqd_server_set_latest(srv, line, len);
+
+  client_t *c = srv->clients;
+  while (c) {
+    client_t *next = c->next;
+    if (c->subscribed && client_send_latest(srv, c) < 0) client_close(srv, c);
+    c = next;
+  }
+}
+
+void bqd_server_broadcast_event(bqd_server_t *srv, const char *line, size_t len) {
+  if (!srv) return;
+  client_t *c = srv->clients;
+  while (c) {
+    client_t *next = c->next;
+    if (c->events) {
+      if (c->events_lost || client_append(c, line, len) != 0) {
+        c->events_lost++;
+      } else if (client_flush(srv, c) < 0) {
+        client_close(srv, c);
+      }
+    }
+    c = next;
+  }
+}
+
+void bqd_server_set_command_handler(bqd_server_t *srv, bqd_server_cmd_fn fn, void *ctx) {
+  if (!srv) return;
+  srv->cmd_fn = fn;
+  srv->cmd_ctx = ctx;
+}
+
+void bqd_server_defer(bqd_server_t *srv, int key) {
+  if (srv && srv->cmd_client) srv->cmd_client->wait_key = key;
+}
+
+int bqd_server_complete(bqd_server_t *srv, int key, const char *line, size_t len) {
+  if (!srv) return 0;
+  int n = 0;
+  client_t *c = srv->clients;
+  while (c) {
+    client_t *next = c->next;
+    if (c->wait_key == key) {
+      c->wait_key = -1;
+      n++;
+      if (client_append(c, line, len) != 0) {
+        (void)client_reply(srv, c, "{\"error\":\"busy\"}\n");
+      } else if (client_flush(srv, c) < 0) {
+        client_close(srv, c);
+      }
+    }
+    c = next;
+  }
+  return n;
+}
+
+void bqd_server_reap(bqd_server_t *srv) {
+  if (!srv) return;
+  while (srv->dead) {
+    client_t *c = srv->dead;
+    srv->dead = c->next;
+    free(c);
+  }
+}
+
+int bqd_server_client_count(const bqd_server_t *srv) {
+  return srv ? srv->nclients : 0;
+}
+
+void bqd_server_close(bqd_server_t *srv) {
+  if (!srv) return;
+  while (srv->clients) client_close(srv, srv->clients);
+  bqd_server_reap(srv);
+  if (srv->listen.fd >= 0) {
+    bqd_loop_del(srv->epfd, &srv->listen);
+    close(srv->listen.fd);
+    if (srv->path[0]) unlink(srv->path);
+  }
+  free(srv->reply);
+  free(srv);
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bq25792d_loop.h"
+
+/*
+  bq25792d unix socket sunucusu (varsayilan: /run/bq25792/bq25792.sock).
+  Satir tabanli protokol, her istek bir satir:
+    get          -> son snapshot (tek JSON satiri)
+    subscribe    -> son snapshot + her yayinda yeni satir (NDJSON push)
+    unsubscribe  -> push'u durdur (olay takibi dahil)
+    events follow [seq] -> "events [seq]" cevabi + her yeni olay satiri
+  Cevabi sonradan gelen komutlar (bqd_server_defer) icin istemci, cevap
+  yazilana kadar baska komut gondermemelidir.
+  Diger komutlar bqd_server_set_command_handler ile eklenir (ornegin "metrics").
+  Tum soketler non-blocking; yavas okuyucu ornekleme dongusunu bloklamaz:
+  istemcinin bekleyen verisi bitmeden gelen push'lar birlestirilir ve
+  buffer bosalinca sadece en guncel snapshot gonderilir.
+*/
+
+typedef struct bqd_server bqd_server_t;
+
+/* Soket 0660; group (NULL = degistirilmez) uyeleri baglanabilir.
+   reply_cap: en buyuk komut cevabi (istemci basina buffer), en az 16 KiB */
+int  bqd_server_open(bqd_server_t **srv, int epfd, const char *path, const char *group, int max_clients,
+                     size_t reply_cap);
+
+/* Hazir dinleme soketi (systemd socket activation); kapanista dosya silinmez */
+int  bqd_server_open_fd(bqd_server_t **srv, int epfd, int fd, int max_clients, size_t reply_cap);
+
+/* epoll olayi: w->kind BQD_W_LISTEN ya da BQD_W_CLIENT */
+void bqd_server_handle(bqd_server_t *srv, bqd_watch_t *w, uint32_t events);
+
+/* Her ornekte: "get" icin en guncel snapshot */
+void bqd_server_set_latest(bqd_server_t *srv, const char *line, size_t len);
+
+/* Yayin: set_latest + tum abonelere push */
+void bqd_server_broadcast(bqd_server_t *srv, const char *line, size_t len);
+
+/* Olay satiri: "events follow" yapan istemcilere. Olaylar birlestirilmez;
+   buffer dolarsa satir dusurulur ve sonra {"events_lost":N} gonderilir. */
+void bqd_server_broadcast_event(bqd_server_t *srv, const char *line, size_t len);
+
+/* Ek komutlar: cevabi out'a yazar, uzunlugunu doner; 0 = bilinmeyen komut.
+   Cevap hemen hazir degilse handler bqd_server_defer() cagirip BQD_SERVER_DEFERRED doner. */
+typedef int (*bqd_server_cmd_fn)(void *ctx, const char *cmd, char *out, size_t len);
+void bqd_server_set_command_handler(bqd_server_t *srv, bqd_server_cmd_fn fn, void *ctx);
+
+#define BQD_SERVER_DEFERRED (-EINPROGRESS)
+
+/* Sadece komut handler'i icinden: komutu gonderen istemci key'in cevabini bekler
+   (istemci basina tek bekleyen cevap) */
+void bqd_server_defer(bqd_server_t *srv, int key);
+
+/* key'i bekleyen istemcilerin hepsine ayni satir. Donus: cevaplanan istemci sayisi */
+int  bqd_server_complete(bqd_server_t *srv, int key, const char *line, size_t len);
+
+/* Kapatilan istemcilerin bellegi: epoll olay dizisi islendikten sonra cagrilir
+   (dizide kapanmis istemciye ait olay kalabilir, bqd_server_handle onlari atlar) */
+void bqd_server_reap(bqd_server_t *srv);
+
+int  bqd_server_client_count(const bqd_server_t *srv);
+
+void bqd_server_close(bqd_server_t *srv);
@@ -1,11 +1,21 @@
 // src/bqctl.c
+#define _GNU_SOURCE /* strptime */
 #include "bq25792.h"
+#include "bq25792_capture.h"
+#include "bq25792_history.h"
+#include "bq25792_regs.h"
+#include "bq25792_shm.h"
 
 #include <errno.h>
 #include <getopt.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
 
 static int env_int(const char *name, int defv) {
   const char *s = getenv(name);
@@ -18,17 +28,41 @@ static const char* env_str(const char *name, const char *defv) {
   return (s && *s) ? s : defv;
 }
 
+/* Satir bir string sabitiyle mi basliyor (sondaki NUL karsilastirilmaz) */
+#define HAS_PREFIX(s, lit) (strncmp((s), (lit), sizeof(lit) - 1) == 0)
+
 static void print_usage(const char *argv0) {
   fprintf(stderr,
     "Kullanim:\n"
-    "  %s [--bus N] [--addr 0x6b] [--no-adc] [--json] status\n"
-    "  %s [--bus N] [--addr 0x6b] raw\n"
-    "  %s [--json] cached\n\n"
+    "  %s [--bus N] [--addr 0x6b] [--no-adc] [--json] [--direct] status\n"
+    "  %s [--bus N] [--addr 0x6b] [--direct] raw\n"
+    "  %s [--bus N] [--addr 0x6b] [--format raw|csv|json] [--direct] regs\n"
+    "      REG00..REG48 tam dokum, alan adlari register tablosundan (flag'lar okununca temizlenir)\n"
+    "      status/raw/regs bq25792d calisiyorsa onun uzerinden okunur (bus'a tek erisim);\n"
+    "      --direct ile dogrudan I2C\n"
+    "  %s [--bus N] [--addr 0x6b] [--channels vbat,ibat|status|all] [--json] adc\n"
+    "      kanallar: ibus ibat vbus vac1 vac2 vbat vsys ts tdie dp dm\n"
+    "  %s [--json] [--format json|bin] cached\n"
+    "  %s [--json] [--from T] [--to T] [--resolution raw|1m|1h|1d|auto] history\n"
+    "      T: unix saniye, 'now', goreli (-90s, -30m, -6h, -7d) ya da YYYY-MM-DD[THH:MM[:SS]]\n"
+    "  %s [--json] [--since SEQ] [--follow] events\n"
+    "      daemon'un flag/durum olay gunlugu; --follow ile yeni olaylar geldikce\n"
+    "  %s [--bus N] [--addr 0x6b] stats\n"
+    "      daemon'un kayan pencere ozetleri (ortalama/min/max/std) ve enerji/yuk sayaclari (JSON)\n"
+    "  %s [--json] caplog [DOSYA]\n"
+    "      I2C kayit dosyasinin dokumu (varsayilan: BQ_CAPTURE_PATH)\n\n"
     "Ortam degiskenleri:\n"
     "  BQ_I2C_BUS      (orn: 10)\n"
     "  BQ_I2C_ADDR     (orn: 0x6b)\n"
-    "  BQ_STATUS_PATH  (cached icin, varsayilan: /run/bq25792/status.json)\n",
-    argv0, argv0, argv0);
+    "  BQ_SHM_PATH     (cached icin, varsayilan: " BQ25792_SHM_DEFAULT_PATH ")\n"
+    "  BQ_STATUS_PATH  (cached icin shm yoksa, varsayilan: /run/bq25792/status.json)\n"
+    "  BQ_STATUS_BIN_PATH (cached --format bin icin shm yoksa, varsayilan: /run/bq25792/status.bin)\n"
+    "  BQ_HISTORY_PATH (history icin, varsayilan: " BQ25792_HISTORY_DEFAULT_PATH ")\n"
+    "  BQ_SOCK_PATH    (events, stats ve daemon uzerinden okuma icin, varsayilan: /run/bq25792/bq25792.sock)\n"
+    "  BQ_LIVE_MAX_AGE_MS (daemon'dan kabul edilen en eski ornek, varsayilan: daemon'un BQ_LIVE_FRESH_MS'i)\n"
+    "  BQ_CAPTURE_PATH (ayarliysa dogrudan I2C islemleri bu dosyaya kaydedilir)\n"
+    "  BQ_TRANSPORT=replay BQ_REPLAY_LOG=DOSYA [BQ_REPLAY_SESSION=N] (kayittan oynat, --direct ile)\n",
+    argv0, argv0, argv0, argv0, argv0, argv0, argv0, argv0, argv0);
 }
 
 static void json_bool(const char *k, int v, int *first) {
@@ -66,41 +100,629 @@ static void json_str(const char *k, const char *v, int *first) {
   *first = 0;
 }
 
-/* cached: /run/bq25792/status.json dosyasini oldugu gibi basar.
-   --json opsiyonu sadece uyumluluk icin (cikti zaten JSON). */
-static int cmd_cached(void) {
-  const char *path = env_str("BQ_STATUS_PATH", "/run/bq25792/status.json");
+/* Snapshot'i istenen formatta bas (bin: BQ25792_SNAPSHOT_BIN_LEN byte, stdout'a ham) */
+static int print_snapshot(const bq25792_snapshot_t *snap, int bin) {
+  if (bin) {
+    uint8_t out[BQ25792_SNAPSHOT_BIN_LEN];
+    int n = bq25792_snapshot_to_bin(snap, out, sizeof(out));
+    if (n < 0) return n;
+    fwrite(out, 1, (size_t)n, stdout);
+    return 0;
+  }
+  char json[1024];
+  int n = bq25792_snapshot_to_json(snap, json, sizeof(json));
+  if (n < 0) return n;
+  fwrite(json, 1, (size_t)n, stdout);
+  return 0;
+}
+
+/* cached (shm): daemon'un paylasimli bellek segmentinden tutarli kopya al,
+   daemon ile ayni formatta bas. Segment yoksa -errno. */
+static int cached_from_shm(int bin) {
+  const char *path = env_str("BQ_SHM_PATH", BQ25792_SHM_DEFAULT_PATH);
+  bq25792_shm_t *shm = NULL;
+  int rc = bq25792_shm_open(&shm, path);
+  if (rc) return rc;
+
+  bq25792_snapshot_t snap;
+  rc = bq25792_shm_read(shm, &snap);
+  bq25792_shm_close(shm);
+  if (rc) return rc;
+
+  return print_snapshot(&snap, bin);
+}
+
+/* Dosyanin tamamini buf'a oku. Donus: byte sayisi ya da -errno */
+static long read_file(const char *path, void *buf, size_t len) {
   FILE *f = fopen(path, "rb");
-  if (!f) {
-    fprintf(stderr, "bqctl: cached okunamadi: %s (%s)\n", path, strerror(errno));
+  if (!f) return -errno;
+  size_t n = fread(buf, 1, len, f);
+  fclose(f);
+  return (long)n;
+}
+
+/* cached: once shm segmenti, yoksa daemon'un durum dosyasi. JSON icin status.json
+   oldugu gibi basilir, yoksa status.bin cozulur; bin icin status.bin dogrulanip basilir.
+   --json opsiyonu sadece uyumluluk icin (varsayilan cikti zaten JSON). */
+static int cmd_cached(const char *format_s) {
+  int bin = 0;
+  if (format_s && strcmp(format_s, "bin") == 0) bin = 1;
+  else if (format_s && strcmp(format_s, "json") != 0) {
+    fprintf(stderr, "bqctl: cached icin gecersiz format: %s (json|bin)\n", format_s);
+    return 2;
+  }
+
+  if (cached_from_shm(bin) == 0) return 0;
+
+  const char *json_path = env_str("BQ_STATUS_PATH", "/run/bq25792/status.json");
+  const char *bin_path = env_str("BQ_STATUS_BIN_PATH", "/run/bq25792/status.bin");
+  static char buf[4096];
+  long n;
+
+  if (!bin) {
+    n = read_file(json_path, buf, sizeof(buf));
+    if (n > 0) {
+      fwrite(buf, 1, (size_t)n, stdout);
+      return 0;
+    }
+  }
+
+  n = read_file(bin_path, buf, sizeof(buf));
+  bq25792_snapshot_t snap;
+  int rc = (n < 0) ? (int)n : bq25792_snapshot_from_bin(&snap, (const uint8_t*)buf, (size_t)n);
+  if (rc < 0) {
+    fprintf(stderr, "bqctl: cached okunamadi: %s (%s)\n", bin ? bin_path : json_path, strerror(-rc));
     return 1;
   }
+  if (bin) {
+    fwrite(buf, 1, (size_t)rc, stdout);
+    return 0;
+  }
+  return print_snapshot(&snap, 0) ? 1 : 0;
+}
 
-  char buf[4096];
-  size_t n;
-  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
-    fwrite(buf, 1, n, stdout);
+/* Zaman argumani -> epoch ms. -1: gecersiz */
+static long long parse_time_ms(const char *s) {
+  const long long now = (long long)time(NULL) * 1000LL;
+  if (!s || !*s || strcmp(s, "now") == 0) return now;
+
+  char *end = NULL;
+  if (s[0] == '-') {
+    double v = strtod(s + 1, &end);
+    long long mul = 1000LL;
+    switch (end ? *end : '\0') {
+      case '\0': case 's': mul = 1000LL; break;
+      case 'm': mul = 60LL * 1000LL; break;
+      case 'h': mul = 3600LL * 1000LL; break;
+      case 'd': mul = 86400LL * 1000LL; break;
+      default: return -1;
+    }
+    return now - (long long)(v * (double)mul);
   }
-  fclose(f);
 
-  /* Dosya newline icermiyorsa terminalde satir bozulmasin */
-  if (buf[0] != '\0') {
-    /* best-effort: son karakter newline mi kontrol etmek icin tekrar dosyayi okumuyoruz */
+  long long v = strtoll(s, &end, 10);
+  if (end && *end == '\0') return v * 1000LL;
+
+  /* yerel saat */
+  struct tm tm;
+  memset(&tm, 0, sizeof(tm));
+  const char *rest = strptime(s, "%Y-%m-%dT%H:%M:%S", &tm);
+  if (!rest || *rest) {
+    memset(&tm, 0, sizeof(tm));
+    rest = strptime(s, "%Y-%m-%dT%H:%M", &tm);
+  }
+  if (!rest || *rest) {
+    memset(&tm, 0, sizeof(tm));
+    rest = strptime(s, "%Y-%m-%d", &tm);
+  }
+  if (!rest || *rest) return -1;
+  tm.tm_isdst = -1;
+  return (long long)mktime(&tm) * 1000LL;
+}
+
+typedef struct {
+  int json;
+  unsigned long rows;
+} hist_out_t;
+
+static int print_raw_row(const bq25792_hist_sample_t *s, void *user) {
+  hist_out_t *o = (hist_out_t*)user;
+  if (o->json) {
+    printf("{\"ts_ms\":%lld,\"vbat_mv\":%u,\"vsys_mv\":%u,\"vbus_mv\":%u,"
+           "\"ibat_ma\":%d,\"ibus_ma\":%d,\"tdie_c\":%.1f,\"soc_pct\":%u,"
+           "\"chg_stat\":%u,\"vbus_stat\":%u,\"fault_any\":%s}\n",
+           (long long)s->ts_ms, s->vbat_mv, s->vsys_mv, s->vbus_mv,
+           s->ibat_ma, s->ibus_ma, s->tdie_dc / 10.0, s->soc_pct,
+           s->chg_stat, s->vbus_stat, (s->flags & BQ25792_HIST_F_FAULT) ? "true" : "false");
+  } else {
+    if (o->rows == 0) printf("ts_ms,vbat_mv,vsys_mv,vbus_mv,ibat_ma,ibus_ma,tdie_c,soc_pct,chg_stat,vbus_stat,fault_any\n");
+    printf("%lld,%u,%u,%u,%d,%d,%.1f,%u,%u,%u,%d\n",
+           (long long)s->ts_ms, s->vbat_mv, s->vsys_mv, s->vbus_mv,
+           s->ibat_ma, s->ibus_ma, s->tdie_dc / 10.0, s->soc_pct,
+           s->chg_stat, s->vbus_stat, (s->flags & BQ25792_HIST_F_FAULT) ? 1 : 0);
+  }
+  o->rows++;
+  return 0;
+}
+
+static const char *const hist_field_name[BQ25792_HIST_NFIELDS] = {
+  "vbat_mv", "vsys_mv", "vbus_mv", "ibat_ma", "ibus_ma", "tdie_dc", "soc_pct"
+};
+
+static int print_agg_row(const bq25792_hist_agg_t *a, void *user) {
+  hist_out_t *o = (hist_out_t*)user;
+  if (o->json) {
+    printf("{\"ts_ms\":%lld,\"count\":%u,\"fault_count\":%u", (long long)a->ts_ms, a->count, a->fault_count);
+    for (int f = 0; f < BQ25792_HIST_NFIELDS; f++) {
+      printf(",\"%s\":{\"min\":%d,\"max\":%d,\"mean\":%d}",
+             hist_field_name[f], a->f[f].min, a->f[f].max, a->f[f].mean);
+    }
+    printf("}\n");
+  } else {
+    if (o->rows == 0) {
+      printf("ts_ms,count,fault_count");
+      for (int f = 0; f < BQ25792_HIST_NFIELDS; f++) {
+        printf(",%s_min,%s_max,%s_mean", hist_field_name[f], hist_field_name[f], hist_field_name[f]);
+      }
+      printf("\n");
+    }
+    printf("%lld,%u,%u", (long long)a->ts_ms, a->count, a->fault_count);
+    for (int f = 0; f < BQ25792_HIST_NFIELDS; f++) printf(",%d,%d,%d", a->f[f].min, a->f[f].max, a->f[f].mean);
+    printf("\n");
+  }
+  o->rows++;
+  return 0;
+}
+
+/* history: daemon'un gecmis deposundan aralik sorgusu (CSV, --json ile NDJSON) */
+static int cmd_history(const char *from_s, const char *to_s, const char *res_s, int json) {
+  const long long from_ms = parse_time_ms(from_s ? from_s : "-1h");
+  const long long to_ms = parse_time_ms(to_s ? to_s : "now");
+  if (from_ms < 0 || to_ms < 0 || to_ms < from_ms) {
+    fprintf(stderr, "bqctl: gecersiz zaman araligi\n");
+    return 2;
+  }
+
+  const char *path = env_str("BQ_HISTORY_PATH", BQ25792_HISTORY_DEFAULT_PATH);
+  bq25792_history_t *h = NULL;
+  int rc = bq25792_history_open(&h, path, false);
+  if (rc) {
+    fprintf(stderr, "bqctl: history acilamadi: %s (%s)\n", path, strerror(-rc));
+    return 1;
+  }
+
+  bq25792_hist_res_t res;
+  if (!res_s || strcmp(res_s, "auto") == 0) {
+    res = bq25792_history_pick_res(h, from_ms, to_ms, 2000);
+  } else {
+    res = BQ25792_HIST_NTIERS;
+    for (int t = 0; t < BQ25792_HIST_NTIERS; t++) {
+      if (strcmp(res_s, bq25792_hist_res_str((bq25792_hist_res_t)t)) == 0) res = (bq25792_hist_res_t)t;
+    }
+    if (res == BQ25792_HIST_NTIERS) {
+      fprintf(stderr, "bqctl: gecersiz resolution: %s\n", res_s);
+      bq25792_history_close(h);
+      return 2;
+    }
+  }
+
+  hist_out_t o = { .json = json, .rows = 0 };
+  if (res == BQ25792_HIST_RAW) rc = bq25792_history_query_raw(h, from_ms, to_ms, print_raw_row, &o);
+  else rc = bq25792_history_query_agg(h, res, from_ms, to_ms, print_agg_row, &o);
+  bq25792_history_close(h);
+
+  if (rc) {
+    fprintf(stderr, "bqctl: history sorgusu basarisiz: %s\n", strerror(-rc));
+    return 1;
+  }
+  return 0;
+}
+
+/* Olay satirini (bq25792_event_to_json) oku; --json yoksa tek satir metin */
+static void print_event(const char *line, int json) {
+  if (json) {
+    fputs(line, stdout);
+    return;
+  }
+  unsigned long long seq;
+  long long t_ns, ts_ms;
+  int bus, value, prev;
+  char addr[8], name[48], reg[8], kind[12];
+  if (sscanf(line, "{\"seq\":%llu,\"t_ns\":%lld,\"ts_ms\":%lld,\"bus\":%d,\"addr\":\"%7[^\"]\","
+                   "\"event\":\"%47[^\"]\",\"reg\":\"%7[^\"]\",\"kind\":\"%11[^\"]\",\"value\":%d,\"prev\":%d",
+             &seq, &t_ns, &ts_ms, &bus, addr, name, reg, kind, &value, &prev) != 10) {
+    fputs(line, stdout);
+    return;
+  }
+  const time_t sec = (time_t)(ts_ms / 1000);
+  struct tm tm;
+  char tbuf[32];
+  localtime_r(&sec, &tm);
+  strftime(tbuf, sizeof(tbuf), "%Y-%m-%d %H:%M:%S", &tm);
+  printf("%s.%03lld  %d:%s  #%-6llu %-20s %s", tbuf, ts_ms % 1000, bus, addr, seq, name, kind);
+  if (strcmp(kind, "change") == 0) printf(" %d -> %d", prev, value);
+  printf("\n");
+}
+
+/* caplog: capture dosyasini oturum + islem satirlari olarak dok (--json ile NDJSON) */
+static int cmd_caplog(const char *path, int json) {
+  if (!path) path = getenv("BQ_CAPTURE_PATH");
+  if (!path || !*path) {
+    fprintf(stderr, "bqctl: caplog icin dosya gerekli\n");
+    return 2;
+  }
+  bq25792_caplog_t *l = NULL;
+  int rc = bq25792_caplog_open(&l, path);
+  if (rc) {
+    fprintf(stderr, "bqctl: kayit acilamadi: %s (%s)\n", path, strerror(-rc));
+    return 1;
+  }
+
+  /* Zamanlar oturum basina gore; oturum baslangiclari kucuk bir tabloda */
+  enum { MAX_SESS = 256 };
+  static struct { uint64_t sid; int64_t start_us; } sess[MAX_SESS];
+  int nsess = 0;
+  bq25792_cap_record_t r;
+  while ((rc = bq25792_caplog_next(l, &r)) > 0) {
+    if (r.op == BQ25792_CAP_SESSION) {
+      if (nsess < MAX_SESS) {
+        sess[nsess].sid = r.sid;
+        sess[nsess].start_us = r.mono_us;
+        nsess++;
+      }
+      if (json) {
+        printf("{\"sid\":%llu,\"op\":\"session\",\"ts_ms\":%lld,\"bus\":%d,\"addr\":\"0x%02x\","
+               "\"transport\":\"%s\"}\n", (unsigned long long)r.sid, (long long)(r.wall_us / 1000),
+               r.bus, r.addr, r.transport);
+      } else {
+        const time_t sec = (time_t)(r.wall_us / 1000000);
+        struct tm tm;
+        char tbuf[32];
+        localtime_r(&sec, &tm);
+        strftime(tbuf, sizeof(tbuf), "%Y-%m-%d %H:%M:%S", &tm);
+        printf("== oturum %llu  %s  bus=%d addr=0x%02x transport=%s\n",
+               (unsigned long long)r.sid, tbuf, r.bus, r.addr, r.transport);
+      }
+      continue;
+    }
+
+    int64_t start = 0;
+    for (int i = 0; i < nsess; i++) {
+      if (sess[i].sid == r.sid) start = sess[i].start_us;
+    }
+    const double t_ms = (double)(r.mono_us - start) / 1000.0;
+    const int has_data = r.rc == 0 || r.op == BQ25792_CAP_WRITE_U8;
+    if (json) {
+      printf("{\"sid\":%llu,\"t_ms\":%.3f,\"op\":\"%s\",\"reg\":\"0x%02x\",\"len\":%u,\"rc\":%d,\"data\":\"",
+             (unsigned long long)r.sid, t_ms, bq25792_cap_op_str(r.op), r.reg, r.len, r.rc);
+      for (unsigned i = 0; has_data && i < r.len; i++) printf("%02x", r.data[i]);
+      printf("\"}\n");
+    } else {
+      printf("%12.3f  %-10s REG%02X", t_ms, bq25792_cap_op_str(r.op), r.reg);
+      if (r.rc) printf("  rc=%d (%s)", r.rc, strerror(-r.rc));
+      if (has_data) {
+        printf(" ");
+        for (unsigned i = 0; i < r.len; i++) printf(" %02X", r.data[i]);
+      }
+      printf("\n");
+    }
+  }
+  bq25792_caplog_close(l);
+  if (rc < 0) {
+    fprintf(stderr, "bqctl: kayit bozuk: %s (%s)\n", path, strerror(-rc));
+    return 1;
+  }
+  return 0;
+}
+
+/* Daemon socket'ine baglan. Donus: fd ya da -errno (daemon calismiyor) */
+static int sock_connect(void) {
+  const char *path = env_str("BQ_SOCK_PATH", "/run/bq25792/bq25792.sock");
+  struct sockaddr_un sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sun_family = AF_UNIX;
+  snprintf(sa.sun_path, sizeof(sa.sun_path), "%s", path);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) return -errno;
+  if (connect(fd, (struct sockaddr*)&sa, sizeof(sa)) < 0) {
+    const int e = -errno;
+    close(fd);
+    return e;
+  }
+  return fd;
+}
+
+/* events: daemon socket'inden olay gunlugu. Cevap sigmazsa "events <end>" ile devam
+   edilir; --follow ile kalinan yerden "events follow" (arada olay kacmaz). */
+static int cmd_events(const char *since_s, int follow, int json) {
+  int fd = sock_connect();
+  if (fd < 0) {
+    fprintf(stderr, "bqctl: daemon'a baglanilamadi: %s (%s)\n",
+            env_str("BQ_SOCK_PATH", "/run/bq25792/bq25792.sock"), strerror(-fd));
+    return 1;
+  }
+  FILE *in = fdopen(fd, "r");
+  if (!in) {
+    close(fd);
+    return 1;
+  }
+
+  unsigned long long after = since_s ? strtoull(since_s, NULL, 10) : 0;
+  char line[512];
+  int rc = 0;
+  for (int pass = 0; ; pass++) {
+    const int live = follow && pass > 0;
+    if (live) dprintf(fd, "events follow %llu\n", after);
+    else dprintf(fd, "events %llu\n", after);
+
+    unsigned long long end = 0, last = 0;
+    int got_end = 0;
+    while (fgets(line, sizeof(line), in)) {
+      if (sscanf(line, "{\"end\":%llu,\"last_seq\":%llu}", &end, &last) == 2) {
+        got_end = 1;
+        if (!live) break;
+        continue;
+      }
+      if (HAS_PREFIX(line, "{\"error\"")) {
+        fprintf(stderr, "bqctl: daemon: %s", line);
+        rc = 1;
+        break;
+      }
+      if (HAS_PREFIX(line, "{\"events_lost\"")) {
+        fprintf(stderr, "bqctl: olaylar kacirildi: %s", line);
+        continue;
+      }
+      print_event(line, json);
+      if (live) fflush(stdout);
+    }
+    if (rc || !got_end || live) break;
+    /* cevap sigmadi: kalan olaylar icin tekrar */
+    if (end < last && end > after) {
+      after = end;
+      pass = -1;
+      continue;
+    }
+    after = end;
+    if (!follow) break;
+  }
+  fclose(in);
+  if (follow && !rc) {
+    fprintf(stderr, "bqctl: daemon baglantisi kapandi\n");
+    rc = 1;
+  }
+  return rc;
+}
+
+/* stats: daemon'un kayan pencere ozetleri ve enerji/yuk sayaclari (tek satir JSON) */
+static int cmd_stats(int bus, int addr) {
+  int fd = sock_connect();
+  if (fd < 0) {
+    fprintf(stderr, "bqctl: daemon'a baglanilamadi: %s (%s)\n",
+            env_str("BQ_SOCK_PATH", "/run/bq25792/bq25792.sock"), strerror(-fd));
+    return 1;
   }
+  FILE *in = fdopen(fd, "r");
+  if (!in) {
+    close(fd);
+    return 1;
+  }
+  dprintf(fd, "stats %d:0x%02x\n", bus, addr & 0xFF);
+  static char line[16384];
+  int rc = 1;
+  if (!fgets(line, sizeof(line), in)) {
+    fprintf(stderr, "bqctl: daemon cevap vermedi\n");
+  } else if (strncmp(line, "{\"error\"", 8) == 0) {
+    fprintf(stderr, "bqctl: daemon: %s", line);
+  } else {
+    fputs(line, stdout);
+    rc = 0;
+  }
+  fclose(in);
+  return rc;
+}
+
+/*
+  Canli okuma daemon uzerinden: bq25792d calisiyorsa bus'in tek sahibi odur
+  ("live" komutu, taze ornek paylasilir); bqctl I2C'ye dokunmaz, ADC/safe
+  default yazmalari tekrarlanmaz. Donus: 0 (img dolu), 1 (daemon hata verdi,
+  mesaj yazildi), <0 (daemon yok ya da cihazi izlemiyor: dogrudan erisim).
+*/
+static int daemon_live(int bus, int addr, uint8_t img[BQ25792_NREGS]) {
+  int fd = sock_connect();
+  if (fd < 0) return fd;
+  /* okuma + ADC beklemesi icin bol; daemon takilirsa bus'a da dokunma */
+  struct timeval tv = { .tv_sec = 5, .tv_usec = 0 };
+  (void)setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  FILE *in = fdopen(fd, "r");
+  if (!in) {
+    close(fd);
+    return -ENOMEM;
+  }
+
+  const char *age_s = env_str("BQ_LIVE_MAX_AGE_MS", NULL);
+  dprintf(fd, "live %d:0x%02x%s%s\n", bus, addr & 0xFF, age_s ? " " : "", age_s ? age_s : "");
+  char line[512];
+  int rc = 1;
+  if (!fgets(line, sizeof(line), in)) {
+    fprintf(stderr, "bqctl: daemon cevap vermedi (%s)\n", strerror(errno ? errno : EPIPE));
+  } else if (strstr(line, "\"error\":\"no such device\"") || strstr(line, "\"error\":\"device not open\"") ||
+             strstr(line, "\"error\":\"unknown command\"")) {
+    rc = -ENODEV;
+  } else if (HAS_PREFIX(line, "{\"error\"")) {
+    fprintf(stderr, "bqctl: daemon: %s", line);
+  } else {
+    const char *p = strstr(line, "\"regs\":\"");
+    if (p) {
+      p += 8;
+      rc = 0;
+      for (int r = 0; r < BQ25792_NREGS; r++) {
+        unsigned v;
+        if (sscanf(p + 2 * r, "%2x", &v) != 1) {
+          rc = 1;
+          break;
+        }
+        img[r] = (uint8_t)v;
+      }
+    }
+    if (rc) fprintf(stderr, "bqctl: daemon cevabi anlasilamadi: %s", line);
+  }
+  fclose(in);
+  return rc;
+}
+
+/* regs: tum register imaji, register/alan tablosundan raw, CSV ya da JSON */
+static int print_regs(const uint8_t *img, bq25792_dump_fmt_t fmt) {
+  static char out[16384];
+  int n = bq25792_regs_dump(img, 0x00, BQ25792_NREGS - 1, fmt, out, sizeof(out));
+  if (n < 0) {
+    fprintf(stderr, "bqctl: regs_dump failed: %s\n", strerror(-n));
+    return 1;
+  }
+  fwrite(out, 1, (size_t)n, stdout);
   return 0;
 }
 
+/* Sadece istenen kanallar donusturulur ve okunur (REG2F/REG30) */
+static int cmd_adc(bq25792_dev_t *dev, const char *channels_s, int json) {
+  uint32_t mask = 0;
+  if (bq25792_adc_channels_parse(channels_s, &mask) != 0) {
+    fprintf(stderr, "bqctl: gecersiz kanal listesi: %s\n", channels_s);
+    return 2;
+  }
+  /* kanal maskesi paylasilan cihazda: okumadan sonra onceki hale dondurulur
+     (daemon'un durum kanallari kapali kalmasin) */
+  uint32_t prev = 0;
+  const int have_prev = bq25792_adc_get_channels(dev, &prev) == 0;
+  bq25792_adc_t a;
+  int rc = bq25792_read_adc(dev, mask, &a);
+  if (have_prev && prev != (mask & BQ25792_ADC_ALL)) (void)bq25792_adc_set_channels(dev, prev);
+  if (rc) {
+    fprintf(stderr, "bqctl: read_adc failed: %s\n", strerror(-rc));
+    return 1;
+  }
+
+  if (json) {
+    int first = 1;
+    printf("{");
+    if (a.valid & BQ25792_ADC_IBUS) json_int("ibus_ma", a.ibus_ma, &first);
+    if (a.valid & BQ25792_ADC_IBAT) json_int("ibat_ma", a.ibat_ma, &first);
+    if (a.valid & BQ25792_ADC_VBUS) json_int("vbus_mv", a.vbus_mv, &first);
+    if (a.valid & BQ25792_ADC_VAC1) json_int("vac1_mv", a.vac1_mv, &first);
+    if (a.valid & BQ25792_ADC_VAC2) json_int("vac2_mv", a.vac2_mv, &first);
+    if (a.valid & BQ25792_ADC_VBAT) json_int("vbat_mv", a.vbat_mv, &first);
+    if (a.valid & BQ25792_ADC_VSYS) json_int("vsys_mv", a.vsys_mv, &first);
+    if (a.valid & BQ25792_ADC_TS)   json_float1("ts_pct", a.ts_pct, &first);
+    if (a.valid & BQ25792_ADC_TDIE) json_float1("tdie_c", a.tdie_c, &first);
+    if (a.valid & BQ25792_ADC_DP)   json_int("dp_mv", a.dp_mv, &first);
+    if (a.valid & BQ25792_ADC_DM)   json_int("dm_mv", a.dm_mv, &first);
+    printf("}\n");
+  } else {
+    if (a.valid & BQ25792_ADC_IBUS) printf("IBUS : %d mA\n", a.ibus_ma);
+    if (a.valid & BQ25792_ADC_IBAT) printf("IBAT : %d mA\n", a.ibat_ma);
+    if (a.valid & BQ25792_ADC_VBUS) printf("VBUS : %d mV\n", a.vbus_mv);
+    if (a.valid & BQ25792_ADC_VAC1) printf("VAC1 : %d mV\n", a.vac1_mv);
+    if (a.valid & BQ25792_ADC_VAC2) printf("VAC2 : %d mV\n", a.vac2_mv);
+    if (a.valid & BQ25792_ADC_VBAT) printf("VBAT : %d mV\n", a.vbat_mv);
+    if (a.valid & BQ25792_ADC_VSYS) printf("VSYS : %d mV\n", a.vsys_mv);
+    if (a.valid & BQ25792_ADC_TS)   printf("TS   : %.1f %%\n", a.ts_pct);
+    if (a.valid & BQ25792_ADC_TDIE) printf("TDIE : %.1f C\n", a.tdie_c);
+    if (a.valid & BQ25792_ADC_DP)   printf("D+   : %d mV\n", a.dp_mv);
+    if (a.valid & BQ25792_ADC_DM)   printf("D-   : %d mV\n", a.dm_mv);
+  }
+  return 0;
+}
+
+/* status ciktisi (metin ya da JSON); dogrudan okuma ve daemon yolu ayni */
+static void print_status(int bus, int addr, const bq25792_status_t *st, int json) {
+  if (json) {
+    int first = 1;
+    printf("{");
+
+    json_int("bus", bus, &first);
+    {
+      char addr_s[8];
+      snprintf(addr_s, sizeof(addr_s), "0x%02x", addr & 0xFF);
+      json_str("addr", addr_s, &first);
+    }
+
+    json_bool("vbus_present", st->vbus_present, &first);
+    json_bool("ac1_present", st->ac1_present, &first);
+    json_bool("ac2_present", st->ac2_present, &first);
+    json_bool("pg", st->pg, &first);
+    json_bool("iindpm", st->iindpm, &first);
+    json_bool("vindpm", st->vindpm, &first);
+    json_bool("watchdog_expired", st->watchdog_expired, &first);
+    json_bool("poor_source", st->poor_source, &first);
+
+    json_u8("cell_count", st->cell_count, &first);
+
+    json_u8("chg_stat", st->chg_stat, &first);
+    json_str("chg_stat_str", bq25792_chg_stat_str(st->chg_stat), &first);
+
+    json_u8("vbus_stat", st->vbus_stat, &first);
+    json_str("vbus_stat_str", bq25792_vbus_stat_str(st->vbus_stat), &first);
+    json_bool("bc12_done", st->bc12_done, &first);
+
+    json_int("ibus_ma", st->ibus_ma, &first);
+    json_int("ibat_ma", st->ibat_ma, &first);
+    json_int("vbus_mv", st->vbus_mv, &first);
+    json_int("vbat_mv", st->vbat_mv, &first);
+    json_int("vsys_mv", st->vsys_mv, &first);
+    json_float1("tdie_c", st->tdie_c, &first);
+
+    json_int("soc_pct_est", st->soc_pct_est, &first);
+
+    json_u8("fault0", st->fault0, &first);
+    json_u8("fault1", st->fault1, &first);
+    json_bool("fault_any", st->fault_any, &first);
+
+    printf("}\n");
+  } else {
+    printf("BQ25792 durum (bus=%d addr=0x%02x)\n", bus, addr & 0xFF);
+    printf("  Giris : VBUS=%d AC1=%d AC2=%d PG=%d\n",
+           st->vbus_present, st->ac1_present, st->ac2_present, st->pg);
+    printf("  DPM   : IINDPM=%d VINDPM=%d poor_src=%d wd_exp=%d\n",
+           st->iindpm, st->vindpm, st->poor_source, st->watchdog_expired);
+    printf("  Sarj  : chg_stat=%u (%s)\n",
+           st->chg_stat, bq25792_chg_stat_str(st->chg_stat));
+    printf("         vbus_stat=0x%X (%s) bc12_done=%d\n",
+           st->vbus_stat, bq25792_vbus_stat_str(st->vbus_stat), st->bc12_done);
+    printf("  ADC   : VBUS=%dmV VBAT=%dmV VSYS=%dmV IBUS=%dmA IBAT=%dmA TDIE=%.1fC\n",
+           st->vbus_mv, st->vbat_mv, st->vsys_mv, st->ibus_ma, st->ibat_ma, st->tdie_c);
+    printf("  Pil   : cells=%u SoC_est=%d%%\n", st->cell_count, st->soc_pct_est);
+    printf("  Hata  : any=%d fault0=0x%02X fault1=0x%02X\n",
+           st->fault_any, st->fault0, st->fault1);
+  }
+}
+
 int main(int argc, char **argv) {
   int bus  = env_int("BQ_I2C_BUS", 10);
   int addr = env_int("BQ_I2C_ADDR", 0x6B);
   int ensure_adc = 1;
   int json = 0;
+  const char *from_s = NULL;
+  const char *to_s = NULL;
+  const char *res_s = NULL;
+  const char *channels_s = "status";
+  const char *format_s = NULL;
+  const char *since_s = NULL;
+  int follow = 0;
+  int direct = 0;
 
   static struct option long_opts[] = {
     {"bus",     required_argument, 0, 'b'},
     {"addr",    required_argument, 0, 'a'},
     {"no-adc",  no_argument,       0, 'n'},
     {"json",    no_argument,       0, 'j'}, /* IMPORTANT: cached --json icin de gerekli */
+    {"from",    required_argument, 0, 'F'},
+    {"to",      required_argument, 0, 'T'},
+    {"resolution", required_argument, 0, 'R'},
+    {"channels", required_argument, 0, 'C'},
+    {"format",  required_argument, 0, 'f'},
+    {"since",   required_argument, 0, 'S'},
+    {"follow",  no_argument,       0, 'W'},
+    {"direct",  no_argument,       0, 'D'},
     {"help",    no_argument,       0, 'h'},
     {0,0,0,0}
   };
@@ -112,6 +734,14 @@ int main(int argc, char **argv) {
       case 'a': addr = (int)strtol(optarg, NULL, 0); break;
       case 'n': ensure_adc = 0; break;
       case 'j': json = 1; break;
+      case 'F': from_s = optarg; break;
+      case 'T': to_s = optarg; break;
+      case 'R': res_s = optarg; break;
+      case 'C': channels_s = optarg; break;
+      case 'f': format_s = optarg; break;
+      case 'S': since_s = optarg; break;
+      case 'W': follow = 1; break;
+      case 'D': direct = 1; break;
       case 'h':
       default:
         print_usage(argv[0]);
@@ -127,9 +757,47 @@ int main(int argc, char **argv) {
   const char *cmd = argv[optind++];
 
   if (strcmp(cmd, "cached") == 0) {
-    /* json flag sadece kabul edilir (cikti zaten JSON) */
-    (void)json;
-    return cmd_cached();
+    /* json flag sadece kabul edilir (varsayilan cikti zaten JSON) */
+    return cmd_cached(format_s);
+  }
+
+  if (strcmp(cmd, "history") == 0) {
+    return cmd_history(from_s, to_s, res_s, json);
+  }
+
+  if (strcmp(cmd, "events") == 0) {
+    return cmd_events(since_s, follow, json);
+  }
+
+  if (strcmp(cmd, "stats") == 0) {
+    return cmd_stats(bus, addr);
+  }
+
+  if (strcmp(cmd, "caplog") == 0) {
+    return cmd_caplog(optind < argc ? argv[optind] : NULL, json);
+  }
+
+  /* raw: regs --format raw ile ayni */
+  const int is_status = strcmp(cmd, "status") == 0;
+  const int is_regs = strcmp(cmd, "raw") == 0 || strcmp(cmd, "regs") == 0;
+  bq25792_dump_fmt_t fmt = json ? BQ25792_DUMP_JSON : BQ25792_DUMP_RAW;
+  if (is_regs && format_s && bq25792_dump_fmt_parse(format_s, &fmt) != 0) {
+    fprintf(stderr, "bqctl: gecersiz format: %s\n", format_s);
+    return 2;
+  }
+
+  /* status/raw/regs: daemon calisiyorsa onun uzerinden (bus'a tek sahip) */
+  if ((is_status || is_regs) && !direct) {
+    uint8_t img[BQ25792_NREGS];
+    int rc = daemon_live(bus, addr, img);
+    if (rc == 0) {
+      if (is_regs) return print_regs(img, fmt);
+      bq25792_status_t st;
+      bq25792_decode_status(img, &st);
+      print_status(bus, addr, &st, json);
+      return 0;
+    }
+    if (rc > 0) return 1;
   }
 
   bq25792_dev_t *dev = NULL;
@@ -140,7 +808,7 @@ int main(int argc, char **argv) {
     return 1;
   }
 
-  if (strcmp(cmd, "status") == 0) {
+  if (is_status) {
     bq25792_status_t st;
     rc = bq25792_read_status(dev, &st, ensure_adc);
     if (rc) {
@@ -148,85 +816,20 @@ int main(int argc, char **argv) {
       bq25792_close(dev);
       return 1;
     }
+    print_status(bus, addr, &st, json);
 
-    if (json) {
-      int first = 1;
-      printf("{");
-
-      json_int("bus", bus, &first);
-      {
-        char addr_s[8];
-        snprintf(addr_s, sizeof(addr_s), "0x%02x", addr & 0xFF);
-        json_str("addr", addr_s, &first);
-      }
-
-      json_bool("vbus_present", st.vbus_present, &first);
-      json_bool("ac1_present", st.ac1_present, &first);
-      json_bool("ac2_present", st.ac2_present, &first);
-      json_bool("pg", st.pg, &first);
-      json_bool("iindpm", st.iindpm, &first);
-      json_bool("vindpm", st.vindpm, &first);
-      json_bool("watchdog_expired", st.watchdog_expired, &first);
-      json_bool("poor_source", st.poor_source, &first);
-
-      json_u8("cell_count", st.cell_count, &first);
-
-      json_u8("chg_stat", st.chg_stat, &first);
-      json_str("chg_stat_str", bq25792_chg_stat_str(st.chg_stat), &first);
-
-      json_u8("vbus_stat", st.vbus_stat, &first);
-      json_str("vbus_stat_str", bq25792_vbus_stat_str(st.vbus_stat), &first);
-      json_bool("bc12_done", st.bc12_done, &first);
-
-      json_int("ibus_ma", st.ibus_ma, &first);
-      json_int("ibat_ma", st.ibat_ma, &first);
-      json_int("vbus_mv", st.vbus_mv, &first);
-      json_int("vbat_mv", st.vbat_mv, &first);
-      json_int("vsys_mv", st.vsys_mv, &first);
-      json_float1("tdie_c", st.tdie_c, &first);
-
-      json_int("soc_pct_est", st.soc_pct_est, &first);
-
-      json_u8("fault0", st.fault0, &first);
-      json_u8("fault1", st.fault1, &first);
-      json_bool("fault_any", st.fault_any, &first);
+  } else if (strcmp(cmd, "adc") == 0) {
+    rc = cmd_adc(dev, channels_s, json);
+    bq25792_close(dev);
+    return rc;
 
-      printf("}\n");
-    } else {
-      printf("BQ25792 durum (bus=%d addr=0x%02x)\n", bus, addr & 0xFF);
-      printf("  Giris : VBUS=%d AC1=%d AC2=%d PG=%d\n",
-             st.vbus_present, st.ac1_present, st.ac2_present, st.pg);
-      printf("  DPM   : IINDPM=%d VINDPM=%d poor_src=%d wd_exp=%d\n",
-             st.iindpm, st.vindpm, st.poor_source, st.watchdog_expired);
-      printf("  Sarj  : chg_stat=%u (%s)\n",
-             st.chg_stat, bq25792_chg_stat_str(st.chg_stat));
-      printf("         vbus_stat=0x%X (%s) bc12_done=%d\n",
-             st.vbus_stat, bq25792_vbus_stat_str(st.vbus_stat), st.bc12_done);
-      printf("  ADC   : VBUS=%dmV VBAT=%dmV VSYS=%dmV IBUS=%dmA IBAT=%dmA TDIE=%.1fC\n",
-             st.vbus_mv, st.vbat_mv, st.vsys_mv, st.ibus_ma, st.ibat_ma, st.tdie_c);
-      printf("  Pil   : cells=%u SoC_est=%d%%\n", st.cell_count, st.soc_pct_est);
-      printf("  Hata  : any=%d fault0=0x%02X fault1=0x%02X\n",
-             st.fault_any, st.fault0, st.fault1);
-    }
-
-  } else if (strcmp(cmd, "raw") == 0) {
-    uint8_t v8;
-    uint16_t v16;
-
-    if (bq25792_read_u8(dev, 0x0A, &v8) == 0) printf("REG0A: 0x%02X\n", v8);
-    if (bq25792_read_u8(dev, 0x10, &v8) == 0) printf("REG10: 0x%02X\n", v8);
-    if (bq25792_read_u8(dev, 0x14, &v8) == 0) printf("REG14: 0x%02X\n", v8);
-    if (bq25792_read_u8(dev, 0x1B, &v8) == 0) printf("REG1B: 0x%02X\n", v8);
-    if (bq25792_read_u8(dev, 0x1C, &v8) == 0) printf("REG1C: 0x%02X\n", v8);
-    if (bq25792_read_u8(dev, 0x26, &v8) == 0) printf("REG26: 0x%02X\n", v8);
-    if (bq25792_read_u8(dev, 0x27, &v8) == 0) printf("REG27: 0x%02X\n", v8);
-
-    if (bq25792_read_u16(dev, 0x31, &v16) == 0) printf("REG31 (IBUS): 0x%04X\n", v16);
-    if (bq25792_read_u16(dev, 0x33, &v16) == 0) printf("REG33 (IBAT): 0x%04X\n", v16);
-    if (bq25792_read_u16(dev, 0x35, &v16) == 0) printf("REG35 (VBUS): 0x%04X\n", v16);
-    if (bq25792_read_u16(dev, 0x3B, &v16) == 0) printf("REG3B (VBAT): 0x%04X\n", v16);
-    if (bq25792_read_u16(dev, 0x3D, &v16) == 0) printf("REG3D (VSYS): 0x%04X\n", v16);
-    if (bq25792_read_u16(dev, 0x41, &v16) == 0) printf("REG41 (TDIE): 0x%04X\n", v16);
+  } else if (is_regs) {
+    uint8_t img[BQ25792_NREGS];
+    rc = bq25792_read_regs(dev, img);
+    if (rc) fprintf(stderr, "bqctl: read_regs failed: %s\n", strerror(-rc));
+    else rc = print_regs(img, fmt);
+    bq25792_close(dev);
+    return rc ? 1 : 0;
 
   } else {
     print_usage(argv[0]);